@@ -0,0 +1,197 @@
+/// gravity_accuracy.cpp
+///
+/// Accuracy-versus-cost harness for the integrator of gravity_sim.cpp. Runs one scene for a fixed simulated time with every
+/// combination of frame time step, substeps and collision handling and reports the wall time, the relative force error of
+/// one substep against synchronous direct summation (StepSimulation moves each body before the next one is evaluated), and
+/// the worst relative energy and angular-momentum drift seen over the run (angular momentum relative to the sum of the bodies'
+/// own magnitudes, so scenes without net rotation stay comparable). The CSV is sorted by wall time and marks the
+/// runs that no other run beats in time and in every error at once (the Pareto front).
+///
+/// Build (links the same libraries as gravity_sim, since it includes the whole program without its main):
+///   g++ -std=c++17 -O2 -DNDEBUG gravity_accuracy.cpp -o gravity_accuracy.exe -lglfw3 -lopengl32 -lgdi32 -lws2_32 -I C:/msys64/mingw64/include -L C:/msys64/mingw64/lib
+///
+/// Usage:
+///   gravity_accuracy [--time SECONDS] [--timesteps DT,DT,...] [--substeps N,N,...] [--collisions] [--samples K] [--csv FILE] [scene options]
+///   Scene options are those of gravity_sim: --load FILE, --generate KIND:N[:SEED], --generate-mass KG, --generate-scale M.
+///
+/// EN: Shows which time step and substep settings buy how much accuracy for how much time.
+/// DE: Zeigt, welche Zeitschritt- und Teilschritt-Einstellungen wie viel Genauigkeit für wie viel Zeit bringen.
+
+#define GRAVITY_SIM_LIBRARY // Leave out gravity_sim's main. // main von gravity_sim weglassen.
+#include "gravity_sim.cpp"
+
+/// Settings and results of one run
+struct AccuracyRun {
+    double timeStep; // Simulated seconds per frame. // Simulierte Sekunden pro Frame.
+    int substeps; // Substeps per frame. // Teilschritte pro Frame.
+    bool collisions; // Collision damping on the first substep. // Kollisionsdämpfung im ersten Teilschritt.
+    uint64_t frames = 0; // Frames to cover the simulated time. // Frames für die simulierte Zeit.
+    double wallSeconds = 0.0; // Stepping time, samples excluded. // Schrittzeit ohne Messpunkte.
+    double forceErrorRms = 0.0, forceErrorMax = 0.0; // Relative acceleration error of one substep. // Relativer Beschleunigungsfehler eines Teilschritts.
+    double energyDrift = 0.0; // max |E(t) - E(0)| / |E(0)|. // max |E(t) - E(0)| / |E(0)|.
+    double angularDrift = 0.0; // max |L(t) - L(0)| / sum |L_i(0)|. // max |L(t) - L(0)| / Summe |L_i(0)|.
+    bool pareto = false; // Not dominated by another run. // Von keinem anderen Lauf dominiert.
+};
+
+/// Measures the force error of one substep
+/// EN: Compares the velocity change StepSimulation applies with synchronous direct summation at the starting positions;
+///     returns RMS and maximum of |a_step - a_direct| / |a_direct| over all bodies
+/// DE: Vergleicht die von StepSimulation angewandte Geschwindigkeitsänderung mit synchroner direkter Summation an den
+///     Startpositionen; gibt RMS und Maximum von |a_step - a_direct| / |a_direct| über alle Körper zurück
+void ForceError(const SlotMap<Object>& initial, double dt, double& rms, double& worst) {
+    objs = initial;
+    std::vector<glm::dvec3> direct(objs.size(), glm::dvec3(0.0)); // Reference accelerations. // Referenzbeschleunigungen.
+    ParallelFor(objs.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (objs[i].Initalizing) continue;
+            for (size_t j = 0; j < objs.size(); ++j) {
+                if (j == i || objs[j].Initalizing) continue;
+                glm::dvec3 delta = objs[j].position - objs[i].position; // Towards j. // Richtung j.
+                double distance = glm::length(delta); // Pair distance. // Paarabstand.
+                if (distance > 0.0) direct[i] += delta * (G * objs[j].mass / (distance * distance * distance));
+            }
+        }
+    });
+    StepSimulation(dt, false); // Effective acceleration is the velocity change over dt. // Effektive Beschleunigung ist die Geschwindigkeitsänderung über dt.
+    double sum = 0.0; // Squared errors. // Quadrierte Fehler.
+    size_t counted = 0; // Bodies with a force. // Körper mit einer Kraft.
+    worst = 0.0;
+    for (size_t i = 0; i < objs.size(); ++i) {
+        double reference = glm::length(direct[i]); // Exact magnitude. // Exakter Betrag.
+        if (objs[i].Initalizing || reference == 0.0) continue;
+        glm::dvec3 applied = (objs[i].velocity - initial[i].velocity) / dt; // What the step used. // Was der Schritt verwendet hat.
+        double error = glm::length(applied - direct[i]) / reference; // Relative error. // Relativer Fehler.
+        sum += error * error;
+        worst = std::max(worst, error);
+        ++counted;
+    }
+    rms = counted > 0 ? std::sqrt(sum / counted) : 0.0;
+}
+
+/// Runs one combination
+/// EN: Restores the initial scene, steps it over the simulated time like the viewer does and samples the drifts samples times
+/// DE: Stellt die Anfangsszene wieder her, rechnet sie wie der Viewer über die simulierte Zeit und misst die Drift samples-mal
+void Run(AccuracyRun& run, const SlotMap<Object>& initial, double duration, int samples) {
+    ForceError(initial, run.timeStep / run.substeps, run.forceErrorRms, run.forceErrorMax);
+    objs = initial;
+    ConservedQuantities reference = ComputeConservedQuantities(objs); // Values at the start. // Werte am Anfang.
+    run.frames = std::max<uint64_t>(1, (uint64_t)std::llround(duration / run.timeStep));
+    for (uint64_t frame = 1; frame <= run.frames; ++frame) {
+        auto start = std::chrono::steady_clock::now(); // Only stepping is timed. // Nur das Rechnen wird gemessen.
+        for (int substep = 0; substep < run.substeps; ++substep) {
+            StepSimulation(run.timeStep / run.substeps, run.collisions && substep == 0); // Same schedule as the viewer. // Gleicher Ablauf wie im Viewer.
+        }
+        run.wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (frame == run.frames || frame % std::max<uint64_t>(1, run.frames / samples) == 0) {
+            ConservedQuantities now = ComputeConservedQuantities(objs); // Values at this sample. // Werte an diesem Messpunkt.
+            if (reference.Energy() != 0.0) run.energyDrift = std::max(run.energyDrift, std::abs(now.Energy() - reference.Energy()) / std::abs(reference.Energy()));
+            if (reference.angularScale > 0.0) run.angularDrift = std::max(run.angularDrift, glm::length(now.angularMomentum - reference.angularMomentum) / reference.angularScale);
+        }
+    }
+}
+
+/// Marks the Pareto front
+/// EN: A run is dominated if another is no worse in wall time, force error, energy and angular-momentum drift and better in one
+/// DE: Ein Lauf ist dominiert, wenn ein anderer bei Laufzeit, Kraftfehler, Energie- und Drehimpulsdrift nicht schlechter und in einem besser ist
+void MarkPareto(std::vector<AccuracyRun>& runs) {
+    auto costs = [](const AccuracyRun& run) { return std::array<double, 4>{ run.wallSeconds, run.forceErrorRms, run.energyDrift, run.angularDrift }; };
+    for (AccuracyRun& run : runs) {
+        run.pareto = true;
+        std::array<double, 4> mine = costs(run); // Objectives of this run. // Ziele dieses Laufs.
+        for (const AccuracyRun& other : runs) {
+            std::array<double, 4> theirs = costs(other); // Objectives of the other run. // Ziele des anderen Laufs.
+            bool noWorse = true, better = false; // Dominance test. // Dominanztest.
+            for (int k = 0; k < 4; ++k) {
+                noWorse = noWorse && theirs[k] <= mine[k];
+                better = better || theirs[k] < mine[k];
+            }
+            if (noWorse && better) { run.pareto = false; break; }
+        }
+    }
+}
+
+/// Parses a comma-separated list
+/// EN: Throws on malformed numbers, like the other option parsers
+/// DE: Wirft bei fehlerhaften Zahlen, wie die anderen Optionsparser
+std::vector<double> ParseList(const std::string& text) {
+    std::vector<double> values; // Parsed numbers. // Gelesene Zahlen.
+    std::stringstream stream(text); // Splits at commas. // Trennt an Kommas.
+    for (std::string item; std::getline(stream, item, ',');) values.push_back(std::stod(item));
+    return values;
+}
+
+/// Main function
+/// EN: Sets up the scene with gravity_sim's options, runs all combinations, prints a table and writes the CSV
+/// DE: Richtet die Szene mit den Optionen von gravity_sim ein, führt alle Kombinationen aus, gibt eine Tabelle aus und schreibt die CSV
+int main(int argc, char** argv) {
+    double duration = 0.0; // Simulated seconds; 0 means 200 scene steps. // Simulierte Sekunden; 0 bedeutet 200 Szenenschritte.
+    std::vector<double> timeSteps, substepList = { 1, 2, 4 }; // Sweep values; empty time steps scale the scene's step. // Reihenwerte; leere Zeitschritte skalieren den Szenenschritt.
+    bool collisions = false; // Also run with collision damping. // Auch mit Kollisionsdämpfung rechnen.
+    int samples = 10; // Drift samples per run. // Drift-Messpunkte pro Lauf.
+    std::string csvPath = "accuracy.csv"; // Pareto table. // Pareto-Tabelle.
+    std::vector<char*> sceneArgs = { argv[0] }; // Forwarded to ParseArguments. // An ParseArguments weitergereicht.
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i]; // Current option. // Aktuelle Option.
+        bool hasValue = i + 1 < argc; // Option has an argument. // Option hat ein Argument.
+        try {
+            if (arg == "--time" && hasValue) duration = std::stod(argv[++i]);
+            else if (arg == "--timesteps" && hasValue) timeSteps = ParseList(argv[++i]);
+            else if (arg == "--substeps" && hasValue) substepList = ParseList(argv[++i]);
+            else if (arg == "--collisions") collisions = true;
+            else if (arg == "--samples" && hasValue) samples = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--csv" && hasValue) csvPath = argv[++i];
+            else sceneArgs.push_back(argv[i]); // Scene option or its value. // Szenenoption oder ihr Wert.
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for option: " << arg << std::endl; // Error message. // Fehlermeldung.
+            return 1;
+        }
+    }
+    if (!ParseArguments((int)sceneArgs.size(), sceneArgs.data()) || !SetUpScene()) return 1;
+    paused = false; // StepSimulation only moves bodies while running. // StepSimulation bewegt Körper nur im Lauf.
+    if (timeSteps.empty()) timeSteps = { 4.0 * simTimeStep, 2.0 * simTimeStep, simTimeStep, 0.5 * simTimeStep, 0.25 * simTimeStep };
+    if (duration <= 0.0) duration = 200.0 * simTimeStep;
+    SlotMap<Object> initial = objs; // Every run starts here. // Jeder Lauf beginnt hier.
+
+    std::vector<AccuracyRun> runs; // All combinations. // Alle Kombinationen.
+    for (double timeStep : timeSteps) {
+        for (double count : substepList) {
+            for (int withCollisions = 0; withCollisions <= (collisions ? 1 : 0); ++withCollisions) {
+                if (timeStep <= 0.0 || count < 1.0) {
+                    std::cerr << "Time steps must be positive and substeps at least 1" << std::endl; // Error message. // Fehlermeldung.
+                    return 1;
+                }
+                AccuracyRun run; // One combination. // Eine Kombination.
+                run.timeStep = timeStep;
+                run.substeps = (int)count;
+                run.collisions = withCollisions != 0;
+                Run(run, initial, duration, samples);
+                runs.push_back(run);
+            }
+        }
+    }
+    MarkPareto(runs);
+    std::sort(runs.begin(), runs.end(), [](const AccuracyRun& a, const AccuracyRun& b) { return a.wallSeconds < b.wallSeconds; });
+
+    double pairs = double(initial.size()) * (initial.size() - 1.0); // Interactions per substep. // Wechselwirkungen pro Teilschritt.
+    std::ofstream csv(csvPath, std::ios::trunc); // Pareto table. // Pareto-Tabelle.
+    csv << "timestep_s,substeps,collisions,frames,wall_s,ns_per_interaction,force_error_rms,force_error_max,energy_drift,angular_momentum_drift,pareto\n";
+    csv << std::setprecision(10);
+    std::cout << initial.size() << " bodies, " << duration << " simulated seconds" << std::endl; // Scene. // Szene.
+    std::cout << std::setw(12) << "dt [s]" << std::setw(9) << "substeps" << std::setw(6) << "coll" << std::setw(12) << "wall [s]"
+              << std::setw(14) << "force err" << std::setw(14) << "energy drift" << std::setw(14) << "L drift" << "  pareto" << std::endl; // Table header. // Tabellenkopf.
+    for (const AccuracyRun& run : runs) {
+        double interactions = pairs * run.substeps * run.frames; // Work of the run. // Arbeit des Laufs.
+        csv << run.timeStep << "," << run.substeps << "," << run.collisions << "," << run.frames << "," << run.wallSeconds << ","
+            << (interactions > 0.0 ? run.wallSeconds * 1.0e9 / interactions : 0.0) << "," << run.forceErrorRms << "," << run.forceErrorMax << ","
+            << run.energyDrift << "," << run.angularDrift << "," << run.pareto << "\n";
+        std::cout << std::defaultfloat << std::setprecision(4) << std::setw(12) << run.timeStep << std::setw(9) << run.substeps << std::setw(6) << (run.collisions ? "on" : "off")
+                  << std::setw(12) << run.wallSeconds << std::scientific << std::setprecision(3) << std::setw(14) << run.forceErrorRms
+                  << std::setw(14) << run.energyDrift << std::setw(14) << run.angularDrift << (run.pareto ? "  *" : "") << std::endl; // Result row. // Ergebniszeile.
+    }
+    if (!csv) {
+        std::cerr << "Cannot write " << csvPath << std::endl; // Error message. // Fehlermeldung.
+        return 1;
+    }
+    std::cout << "Wrote " << csvPath << std::endl; // Status. // Status.
+    return 0;
+}
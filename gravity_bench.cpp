@@ -0,0 +1,207 @@
+/// gravity_bench.cpp
+///
+/// Microbenchmarks for the hot paths of gravity_sim.cpp: the all-pairs force loop of StepSimulation (with and without
+/// collisions), the picking BVH (build and ray walk), spacetime grid creation and deformation, and sphere mesh generation.
+/// Each benchmark sweeps the body count from 2 to 10^6, repeats until a minimum time has passed and reports time per
+/// iteration, ns per body and items (interactions, bodies, rays or vertices) per second, as a table and as JSON in the
+/// layout of Google Benchmark, so existing comparison tools read it.
+///
+/// Build (links the same libraries as gravity_sim, since it includes the whole program without its main):
+///   g++ -std=c++17 -O2 gravity_bench.cpp -o gravity_bench.exe -lglfw3 -lopengl32 -lgdi32 -lws2_32 -I C:/msys64/mingw64/include -L C:/msys64/mingw64/lib
+///
+/// Usage:
+///   gravity_bench [--filter TEXT] [--min-n N] [--max-n N] [--min-time SECONDS] [--max-items COUNT] [--json FILE]
+///
+/// EN: Tracks interactions per second and ns per body across body counts, without a window.
+/// DE: Verfolgt Wechselwirkungen pro Sekunde und ns pro Körper über Körperanzahlen hinweg, ohne Fenster.
+
+#define GRAVITY_SIM_LIBRARY // Leave out gravity_sim's main. // main von gravity_sim weglassen.
+#include "gravity_sim.cpp"
+#include <ctime> // Standard library for process CPU time. // Standardbibliothek für Prozess-CPU-Zeit.
+#include <functional> // Standard library for benchmark callbacks. // Standardbibliothek für Benchmark-Callbacks.
+
+/// Benchmark definition
+/// EN: setup prepares the inputs for n outside the timed region, run does one timed iteration, items counts the work of one iteration
+/// DE: setup bereitet die Eingaben für n außerhalb des gemessenen Bereichs vor, run führt eine gemessene Iteration aus, items zählt die Arbeit einer Iteration
+struct Benchmark {
+    std::string name; // Family name; the body count is appended. // Familienname; die Körperanzahl wird angehängt.
+    const char* itemName; // Unit of items, e.g. "interactions". // Einheit der Elemente, z. B. "interactions".
+    std::function<void(size_t)> setup; // Untimed preparation for n. // Ungemessene Vorbereitung für n.
+    std::function<void()> run; // One timed iteration. // Eine gemessene Iteration.
+    std::function<double(size_t)> items; // Work per iteration. // Arbeit pro Iteration.
+    std::vector<size_t> sizes; // Sizes to run; empty for the body count sweep. // Auszuführende Größen; leer für die Körperanzahl-Reihe.
+};
+
+/// Result of one benchmark at one size
+struct BenchmarkResult {
+    std::string name; // Family/size. // Familie/Größe.
+    size_t n; // Body count or size parameter. // Körperanzahl oder Größenparameter.
+    uint64_t iterations; // Timed iterations. // Gemessene Iterationen.
+    double realNs; // Wall time per iteration. // Laufzeit pro Iteration.
+    double cpuNs; // Process CPU time per iteration, all threads. // Prozess-CPU-Zeit pro Iteration, alle Threads.
+    double itemsPerSecond; // Work rate. // Arbeitsrate.
+    const char* itemName; // Unit of items. // Einheit der Elemente.
+};
+
+/// Creates the benchmark scene
+/// EN: A Plummer sphere of n bodies, identical for a given n, loaded into objs without console output
+/// DE: Eine Plummer-Kugel aus n Körpern, für ein gegebenes n identisch, ohne Konsolenausgabe in objs geladen
+void MakeBodies(size_t n) {
+    Scenario scenario; // Generated bodies. // Generierte Körper.
+    scenario.bodies.resize(n);
+    GeneratePlummer(scenario.bodies, 0, n, 1, 1.989e25, 1.5e8, glm::vec4(0.8f, 0.8f, 1.0f, 1.0f));
+    CenterComponent(scenario.bodies, 0, n);
+    StartScenario(scenario);
+    paused = false; // StepSimulation only moves bodies while running. // StepSimulation bewegt Körper nur im Lauf.
+}
+
+/// Runs one benchmark at one size
+/// EN: Doubles the iteration count until the batch takes at least minTime; one untimed warm-up iteration first
+/// DE: Verdoppelt die Iterationsanzahl, bis der Durchlauf mindestens minTime dauert; vorher eine ungemessene Aufwärm-Iteration
+BenchmarkResult RunBenchmark(const Benchmark& benchmark, size_t n, double minTime) {
+    benchmark.setup(n);
+    benchmark.run(); // Warm caches and lazy allocations. // Caches und verzögerte Allokationen aufwärmen.
+    uint64_t iterations = 1; // Batch size. // Durchlaufgröße.
+    double seconds = 0.0, cpuSeconds = 0.0; // Batch times. // Durchlaufzeiten.
+    for (;;) {
+        std::clock_t cpuStart = std::clock(); // Process CPU clock. // Prozess-CPU-Uhr.
+        auto start = std::chrono::steady_clock::now(); // Wall clock. // Wanduhr.
+        for (uint64_t i = 0; i < iterations; ++i) benchmark.run();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        if (seconds >= minTime || iterations >= (1ull << 40)) break;
+        iterations = seconds > 0.0 ? std::max(iterations * 2, uint64_t(iterations * 1.4 * minTime / seconds)) : iterations * 10; // Aim past minTime. // Über minTime hinaus zielen.
+    }
+    BenchmarkResult result; // Per-iteration figures. // Werte pro Iteration.
+    result.name = benchmark.name + "/" + std::to_string(n);
+    result.n = n;
+    result.iterations = iterations;
+    result.realNs = seconds * 1.0e9 / iterations;
+    result.cpuNs = cpuSeconds * 1.0e9 / iterations;
+    result.itemsPerSecond = benchmark.items(n) * iterations / seconds;
+    result.itemName = benchmark.itemName;
+    return result;
+}
+
+/// Writes results as Google Benchmark JSON
+/// EN: Adds ns_per_body and the item unit as extra fields next to the standard ones
+/// DE: Fügt ns_per_body und die Elementeinheit als zusätzliche Felder neben den Standardfeldern hinzu
+bool WriteJson(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream json(path, std::ios::trunc); // Report file. // Berichtsdatei.
+    std::time_t now = std::time(nullptr); // Run date. // Laufdatum.
+    char date[32]; // ISO 8601 timestamp. // ISO-8601-Zeitstempel.
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    json << std::setprecision(10) << "{\n  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"executable\": \"gravity_bench\",\n"
+         << "    \"num_cpus\": " << std::max(1u, std::thread::hardware_concurrency()) << ",\n"
+#ifdef NDEBUG
+         << "    \"library_build_type\": \"release\"\n"
+#else
+         << "    \"library_build_type\": \"debug\"\n"
+#endif
+         << "  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        json << "    {\n"
+             << "      \"name\": \"" << r.name << "\",\n"
+             << "      \"run_name\": \"" << r.name << "\",\n"
+             << "      \"run_type\": \"iteration\",\n"
+             << "      \"iterations\": " << r.iterations << ",\n"
+             << "      \"real_time\": " << r.realNs << ",\n"
+             << "      \"cpu_time\": " << r.cpuNs << ",\n"
+             << "      \"time_unit\": \"ns\",\n"
+             << "      \"items_per_second\": " << r.itemsPerSecond << ",\n"
+             << "      \"item_unit\": \"" << r.itemName << "\",\n"
+             << "      \"n\": " << r.n << ",\n"
+             << "      \"ns_per_body\": " << r.realNs / r.n << "\n"
+             << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    if (!json) std::cerr << "Cannot write " << path << std::endl; // Error message. // Fehlermeldung.
+    return (bool)json;
+}
+
+/// Main function
+/// EN: Parses options, runs every matching benchmark over the size sweep and prints a table; skips sizes whose work exceeds --max-items
+/// DE: Liest Optionen, führt jeden passenden Benchmark über die Größenreihe aus und gibt eine Tabelle aus; überspringt Größen, deren Arbeit --max-items übersteigt
+int main(int argc, char** argv) {
+    std::string filter, jsonPath; // Name filter and report path. // Namensfilter und Berichtspfad.
+    size_t minN = 2, maxN = 1000000; // Body count range. // Bereich der Körperanzahl.
+    double minTime = 0.25; // Seconds per measurement. // Sekunden pro Messung.
+    double maxItems = 2.0e9; // Skip sizes with more work per iteration, e.g. all-pairs at 10^6. // Größen mit mehr Arbeit pro Iteration überspringen, z. B. paarweise bei 10^6.
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i]; // Current option. // Aktuelle Option.
+        bool hasValue = i + 1 < argc; // Option has an argument. // Option hat ein Argument.
+        try {
+            if (arg == "--filter" && hasValue) filter = argv[++i];
+            else if (arg == "--min-n" && hasValue) minN = std::stoull(argv[++i]);
+            else if (arg == "--max-n" && hasValue) maxN = std::stoull(argv[++i]);
+            else if (arg == "--min-time" && hasValue) minTime = std::stod(argv[++i]);
+            else if (arg == "--max-items" && hasValue) maxItems = std::stod(argv[++i]);
+            else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+            else {
+                std::cerr << "Usage: gravity_bench [--filter TEXT] [--min-n N] [--max-n N] [--min-time SECONDS] [--max-items COUNT] [--json FILE]" << std::endl; // Error message. // Fehlermeldung.
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for option: " << arg << std::endl; // Error message. // Fehlermeldung.
+            return 1;
+        }
+    }
+
+    std::vector<size_t> sweep = { 2, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1000000 }; // Body counts. // Körperanzahlen.
+    std::vector<double> grid; // Grid vertices for the update benchmark. // Gitter-Vertices für den Aktualisierungs-Benchmark.
+    std::vector<glm::dvec3> rays; // Pick ray directions. // Pick-Strahlrichtungen.
+    const size_t RAYS = 1024; // Rays per pick iteration. // Strahlen pro Pick-Iteration.
+    auto gridVertices = [&] { return double(grid.size() / 3); }; // Vertices of the current grid. // Vertices des aktuellen Gitters.
+    std::vector<float> mesh; // Sphere mesh output. // Ausgabe des Kugel-Meshs.
+
+    std::vector<Benchmark> benchmarks = {
+        { "AllPairs", "interactions", MakeBodies, [] { StepSimulation(simTimeStep, false); },
+          [](size_t n) { return double(n) * (n - 1); }, {} },
+        { "AllPairsCollisions", "interactions", MakeBodies, [] { StepSimulation(simTimeStep, true); },
+          [](size_t n) { return double(n) * (n - 1); }, {} },
+        { "BVHBuild", "bodies", MakeBodies, [] { bodyBVH.Build(objs); },
+          [](size_t n) { return double(n); }, {} },
+        { "BVHPick", "rays", [&](size_t n) {
+              MakeBodies(n);
+              bodyBVH.Build(objs);
+              rays.clear();
+              for (size_t i = 0; i < RAYS; ++i) rays.push_back(BodyRandom(7, i).Direction()); // Deterministic directions. // Deterministische Richtungen.
+          }, [&] {
+              for (const glm::dvec3& direction : rays) bodyBVH.Pick(objs, cameraPos, direction);
+          }, [&](size_t) { return double(RAYS); }, {} },
+        { "CreateGridVertices", "vertices", [&](size_t) { grid = CreateGridVertices(gridSize, gridDivisions, objs); }, // Flat grid, independent of the bodies. // Flaches Gitter, unabhängig von den Körpern.
+          [&] { grid = CreateGridVertices(gridSize, gridDivisions, objs); }, [&](size_t) { return gridVertices(); }, { 1 } },
+        { "UpdateGridVertices", "vertex-body pairs", [&](size_t n) { MakeBodies(n); grid = CreateGridVertices(gridSize, gridDivisions, objs); },
+          [&] { grid = UpdateGridVertices(std::move(grid), objs); }, [&](size_t n) { return gridVertices() * n; }, {} },
+        { "SphereMesh", "vertices", [](size_t) {}, [&] {
+              for (int level = 0; level < LOD_COUNT; ++level) mesh = CreateSphereVertices(1.0f, lodSegments[level], lodSegments[level]);
+          }, [&](size_t) {
+              double vertices = 0.0; // All levels. // Alle Stufen.
+              for (int level = 0; level < LOD_COUNT; ++level) vertices += 6.0 * lodSegments[level] * lodSegments[level];
+              return vertices;
+          }, { 1 } },
+    };
+
+    std::cout << std::left << std::setw(32) << "Benchmark" << std::right << std::setw(14) << "Time/iter" << std::setw(14) << "ns/body"
+              << std::setw(12) << "Iterations" << "  Items/s" << std::endl; // Table header. // Tabellenkopf.
+    std::vector<BenchmarkResult> results; // All measurements. // Alle Messungen.
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+        for (size_t n : benchmark.sizes.empty() ? sweep : benchmark.sizes) {
+            if (benchmark.sizes.empty() && (n < minN || n > maxN || benchmark.items(n) > maxItems)) continue;
+            BenchmarkResult result = RunBenchmark(benchmark, n, minTime);
+            results.push_back(result);
+            double ns = result.realNs; // Time per iteration. // Zeit pro Iteration.
+            std::ostringstream time; // Scaled time. // Skalierte Zeit.
+            time << std::fixed << std::setprecision(ns < 1.0e4 ? 0 : 2) << (ns < 1.0e4 ? ns : ns < 1.0e7 ? ns / 1.0e3 : ns / 1.0e6) << (ns < 1.0e4 ? " ns" : ns < 1.0e7 ? " us" : " ms");
+            std::cout << std::left << std::setw(32) << result.name << std::right << std::setw(14) << time.str()
+                      << std::setw(14) << std::fixed << std::setprecision(1) << ns / n << std::setw(12) << result.iterations
+                      << "  " << std::scientific << std::setprecision(3) << result.itemsPerSecond << " " << result.itemName << std::defaultfloat << std::endl; // Result row. // Ergebniszeile.
+        }
+    }
+    if (!jsonPath.empty() && !WriteJson(jsonPath, results)) return 1;
+    return 0;
+}
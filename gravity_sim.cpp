@@ -19,50 +19,225 @@
 #include <glm/gtc/type_ptr.hpp> // GLM extension for pointer access to matrices. // GLM-Erweiterung für Zeigerzugriff auf Matrizen.
 #include <vector> // Standard library for dynamic arrays. // Standardbibliothek für dynamische Arrays.
 #include <iostream> // Standard library for input/output operations. // Standardbibliothek für Ein-/Ausgabeoperationen.
+#include <fstream> // Standard library for file output (profiling log). // Standardbibliothek für Dateiausgabe (Profiling-Log).
+#include <sstream> // Standard library for string formatting (window title). // Standardbibliothek für String-Formatierung (Fenstertitel).
+#include <iomanip> // Standard library for stream formatting manipulators. // Standardbibliothek für Stream-Formatierungsmanipulatoren.
+#include <filesystem> // Standard library for directory handling (shader cache). // Standardbibliothek für Verzeichnisverwaltung (Shader-Cache).
+#include <cstdint> // Fixed-width integer types for binary file headers. // Integer-Typen fester Breite für binäre Datei-Header.
+#include <cstddef> // Standard library for offsetof (instance attribute layout). // Standardbibliothek für offsetof (Instanz-Attribut-Layout).
+#include <chrono> // Standard library for high-resolution CPU timing. // Standardbibliothek für hochauflösende CPU-Zeitmessung.
+#include <string> // Standard library for command-line argument handling. // Standardbibliothek für Kommandozeilen-Argumentverarbeitung.
+#include <algorithm> // Standard library for nth_element (BVH median split). // Standardbibliothek für nth_element (BVH-Median-Teilung).
+#include <limits> // Standard library for numeric limits. // Standardbibliothek für numerische Grenzen.
+#include <atomic> // Standard library for lock-free queue indices. // Standardbibliothek für lock-freie Warteschlangen-Indizes.
+#include <array> // Standard library for fixed-size queue storage. // Standardbibliothek für Warteschlangenspeicher fester Größe.
+#include <thread> // Standard library for background file writes. // Standardbibliothek für Dateischreiben im Hintergrund.
+#include <mutex> // Standard library for the worker pool hand-off. // Standardbibliothek für die Übergabe an den Worker-Pool.
+#include <condition_variable> // Standard library for sleeping pool workers. // Standardbibliothek für schlafende Pool-Worker.
+#include <cstring> // Standard library for memcpy and memcmp (binary files). // Standardbibliothek für memcpy und memcmp (Binärdateien).
+#include <charconv> // Standard library for from_chars (scenario parsing). // Standardbibliothek für from_chars (Szenario-Parsing).
+#include <cctype> // Standard library for isspace (scenario parsing). // Standardbibliothek für isspace (Szenario-Parsing).
+#ifdef _WIN32
+#define NOMINMAX // Keep std::min and std::max usable. // std::min und std::max nutzbar halten.
+#include <winsock2.h> // Sockets for streaming; must precede windows.h. // Sockets für das Streaming; muss vor windows.h stehen.
+#include <ws2tcpip.h> // getaddrinfo. // getaddrinfo.
+#include <windows.h> // File mapping on Windows. // Datei-Mapping unter Windows.
+#pragma comment(lib, "ws2_32.lib") // Winsock for MSVC; MinGW links -lws2_32. // Winsock für MSVC; MinGW linkt -lws2_32.
+#else
+#include <sys/mman.h> // mmap for memory-mapped files. // mmap für speicherabgebildete Dateien.
+#include <sys/stat.h> // fstat for file sizes. // fstat für Dateigrößen.
+#include <fcntl.h> // open flags. // open-Flags.
+#include <unistd.h> // close. // close.
+#include <sys/socket.h> // Sockets for streaming. // Sockets für das Streaming.
+#include <netinet/in.h> // Internet address families. // Internet-Adressfamilien.
+#include <netinet/tcp.h> // TCP_NODELAY. // TCP_NODELAY.
+#include <netdb.h> // getaddrinfo. // getaddrinfo.
+#include <cerrno> // errno for non-blocking sockets. // errno für nicht blockierende Sockets.
+#ifdef __linux__
+#include <linux/perf_event.h> // Hardware performance counters. // Hardware-Leistungszähler.
+#include <sys/syscall.h> // perf_event_open has no libc wrapper. // perf_event_open hat keinen libc-Wrapper.
+#include <sys/ioctl.h> // Counter enable and reset. // Zähler aktivieren und zurücksetzen.
+#endif
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h> // __rdtsc for the frame profiler. // __rdtsc für den Frame-Profiler.
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc for the frame profiler. // __rdtsc für den Frame-Profiler.
+#endif
+#include "shared_state.h" // Shared-memory snapshot ring for external readers. // Schnappschuss-Ring im gemeinsamen Speicher für externe Leser.
 
 /// Vertex shader source code in GLSL
-/// EN: Transforms vertices and calculates lighting intensity based on position
-/// DE: Transformiert Vertices und berechnet Lichtintensität basierend auf Position
+/// EN: Places an instance of the shared unit-sphere mesh per body and calculates lighting intensity based on position
+/// DE: Platziert eine Instanz des gemeinsamen Einheitskugel-Meshs pro Körper und berechnet Lichtintensität basierend auf Position
 const char* vertexShaderSource = R"glsl(
 #version 330 core
-layout(location=0) in vec3 aPos; // Input vertex position. // Eingangs-Vertex-Position.
-uniform mat4 model; // Model transformation matrix. // Modell-Transformationsmatrix.
+layout(location=0) in vec3 aPos; // Unit-sphere vertex position. // Vertex-Position der Einheitskugel.
+layout(location=1) in vec4 aPositionRadius; // Per-instance camera-relative position (xyz) and radius (w). // Kamerarelative Position (xyz) und Radius (w) pro Instanz.
+layout(location=2) in vec4 aColor; // Per-instance base color. // Grundfarbe pro Instanz.
+layout(location=3) in float aGlow; // Per-instance glow flag. // Leucht-Flag pro Instanz.
 uniform mat4 view; // View transformation matrix. // Ansichts-Transformationsmatrix.
 uniform mat4 projection; // Projection matrix. // Projektionsmatrix.
+uniform vec3 lightPos; // Camera-relative world center. // Kamerarelatives Weltzentrum.
 out float lightIntensity; // Output light intensity to fragment shader. // Ausgabe der Lichtintensität an Fragment-Shader.
+out vec4 objectColor; // Output base color to fragment shader. // Ausgabe der Grundfarbe an Fragment-Shader.
+flat out int glow; // Output glow flag to fragment shader. // Ausgabe des Leucht-Flags an Fragment-Shader.
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0); // Transform vertex to clip space. // Transformiere Vertex in Clip-Space.
-    vec3 worldPos = (model * vec4(aPos, 1.0)).xyz; // Calculate world position. // Berechne Weltposition.
+    vec3 relativePos = aPositionRadius.xyz + aPos * aPositionRadius.w; // Scale and place unit sphere. // Skaliere und platziere Einheitskugel.
+    gl_Position = projection * view * vec4(relativePos, 1.0); // Transform vertex to clip space. // Transformiere Vertex in Clip-Space.
     vec3 normal = normalize(aPos); // Use position as normal for sphere. // Verwende Position als Normale für Kugel.
-    vec3 dirToCenter = normalize(-worldPos); // Direction to world center. // Richtung zum Weltzentrum.
+    vec3 dirToCenter = normalize(lightPos - relativePos); // Direction to world center. // Richtung zum Weltzentrum.
     lightIntensity = max(dot(normal, dirToCenter), 0.15); // Calculate diffuse lighting. // Berechne diffuse Beleuchtung.
+    objectColor = aColor; // Forward color. // Farbe weiterreichen.
+    glow = aGlow > 0.5 ? 1 : 0; // Forward glow flag. // Leucht-Flag weiterreichen.
 })glsl";
 
 /// Fragment shader source code in GLSL
-/// EN: Determines pixel colors with lighting effects and special rendering modes
-/// DE: Bestimmt Pixelfarben mit Lichteffekten und speziellen Rendering-Modi
+/// EN: Determines pixel colors with lighting effects; glowing bodies are selected per instance
+/// DE: Bestimmt Pixelfarben mit Lichteffekten; leuchtende Körper werden pro Instanz ausgewählt
 const char* fragmentShaderSource = R"glsl(
 #version 330 core
 in float lightIntensity; // Input light intensity from vertex shader. // Eingangs-Lichtintensität vom Vertex-Shader.
+in vec4 objectColor; // Base color of the object. // Grundfarbe des Objekts.
+flat in int glow; // Glow flag of the object. // Leucht-Flag des Objekts.
 out vec4 FragColor; // Output fragment color. // Ausgabe-Fragmentfarbe.
-uniform vec4 objectColor; // Base color of the object. // Grundfarbe des Objekts.
-uniform bool isGrid; // Flag for grid rendering. // Flag für Grid-Rendering.
-uniform bool GLOW; // Flag for glowing objects. // Flag für leuchtende Objekte.
+uniform float emissiveStrength; // HDR brightness of glowing bodies, picked up by the bloom pass. // HDR-Helligkeit leuchtender Körper, vom Bloom-Pass aufgegriffen.
 void main() {
-    if (isGrid) {
-        FragColor = objectColor; // Grid uses flat color. // Grid verwendet flache Farbe.
-    } else if(GLOW){
-        FragColor = vec4(objectColor.rgb * 100000, objectColor.a); // Extreme brightness for glow. // Extreme Helligkeit für Leuchten.
+    if(glow != 0){
+        FragColor = vec4(objectColor.rgb * emissiveStrength, objectColor.a); // HDR emission above 1.0 feeds the bloom. // HDR-Emission über 1.0 speist den Bloom.
     }else {
         float fade = smoothstep(0.0, 10.0, lightIntensity*10); // Smooth lighting transition. // Sanfter Beleuchtungsübergang.
         FragColor = vec4(objectColor.rgb * fade, objectColor.a); // Apply lighting to color. // Wende Beleuchtung auf Farbe an.
     }
 })glsl";
 
+/// Grid vertex shader source code in GLSL
+/// EN: Transforms grid line vertices to clip space
+/// DE: Transformiert Gitterlinien-Vertices in den Clip-Space
+const char* gridVertexShaderSource = R"glsl(
+#version 330 core
+layout(location=0) in vec3 aPos; // Input vertex position. // Eingangs-Vertex-Position.
+uniform mat4 model; // Model transformation matrix. // Modell-Transformationsmatrix.
+uniform mat4 view; // View transformation matrix. // Ansichts-Transformationsmatrix.
+uniform mat4 projection; // Projection matrix. // Projektionsmatrix.
+void main() {
+    gl_Position = projection * view * model * vec4(aPos, 1.0); // Transform vertex to clip space. // Transformiere Vertex in Clip-Space.
+})glsl";
+
+/// Grid fragment shader source code in GLSL
+/// EN: Grid uses a flat color
+/// DE: Grid verwendet eine flache Farbe
+const char* gridFragmentShaderSource = R"glsl(
+#version 330 core
+out vec4 FragColor; // Output fragment color. // Ausgabe-Fragmentfarbe.
+uniform vec4 objectColor; // Grid color. // Gitterfarbe.
+void main() {
+    FragColor = objectColor; // Flat color. // Flache Farbe.
+})glsl";
+
+/// Overlay vertex shader source code in GLSL
+/// EN: Passes screen-space (NDC) positions and per-vertex colors through for the profiler overlay
+/// DE: Reicht Bildschirm-Positionen (NDC) und Vertex-Farben für das Profiler-Overlay durch
+const char* overlayVertexShaderSource = R"glsl(
+#version 330 core
+layout(location=0) in vec2 aPos; // Vertex position in normalized device coordinates. // Vertex-Position in normalisierten Gerätekoordinaten.
+layout(location=1) in vec4 aColor; // Vertex color. // Vertex-Farbe.
+out vec4 barColor; // Output color to fragment shader. // Ausgabe der Farbe an Fragment-Shader.
+void main() {
+    gl_Position = vec4(aPos, 0.0, 1.0); // No transformation, already in clip space. // Keine Transformation, bereits im Clip-Space.
+    barColor = aColor; // Forward color. // Farbe weiterreichen.
+})glsl";
+
+/// Overlay fragment shader source code in GLSL
+/// EN: Outputs the flat bar color of the profiler overlay
+/// DE: Gibt die flache Balkenfarbe des Profiler-Overlays aus
+const char* overlayFragmentShaderSource = R"glsl(
+#version 330 core
+in vec4 barColor; // Input color from vertex shader. // Eingangsfarbe vom Vertex-Shader.
+out vec4 FragColor; // Output fragment color. // Ausgabe-Fragmentfarbe.
+void main() {
+    FragColor = barColor; // Flat color. // Flache Farbe.
+})glsl";
+
+/// Fullscreen vertex shader source code in GLSL
+/// EN: Generates one oversized triangle covering the screen from gl_VertexID, no vertex buffer needed
+/// DE: Erzeugt aus gl_VertexID ein übergroßes, bildschirmfüllendes Dreieck, kein Vertex-Buffer nötig
+const char* fullscreenVertexShaderSource = R"glsl(
+#version 330 core
+out vec2 uv; // Texture coordinate. // Texturkoordinate.
+void main() {
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2); // (0,0), (2,0), (0,2). // (0,0), (2,0), (0,2).
+    uv = corner; // Covers [0,1] on screen. // Deckt [0,1] auf dem Bildschirm ab.
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0); // To clip space. // In Clip-Space.
+})glsl";
+
+/// Bloom downsample fragment shader source code in GLSL
+/// EN: Dual-filter (Kawase) downsample with 5 bilinear taps; the first pass also applies a soft brightness threshold
+/// DE: Dual-Filter-(Kawase-)Downsampling mit 5 bilinearen Abtastungen; der erste Pass wendet zusätzlich eine weiche Helligkeitsschwelle an
+const char* bloomDownsampleFragmentSource = R"glsl(
+#version 330 core
+in vec2 uv; // Texture coordinate. // Texturkoordinate.
+out vec4 FragColor; // Output color. // Ausgabefarbe.
+uniform sampler2D source; // Larger bloom level or HDR scene. // Größere Bloom-Stufe oder HDR-Szene.
+uniform vec2 texelSize; // Texel size of the source. // Texelgröße der Quelle.
+uniform bool prefilter; // Apply brightness threshold. // Helligkeitsschwelle anwenden.
+uniform float threshold; // Brightness above which pixels bloom. // Helligkeit, ab der Pixel leuchten.
+vec3 Fetch(vec2 p) {
+    vec3 color = texture(source, p).rgb; // Bilinear sample. // Bilineare Abtastung.
+    if (prefilter) {
+        float brightness = max(color.r, max(color.g, color.b)); // Peak channel. // Höchster Kanal.
+        color *= max(brightness - threshold, 0.0) / max(brightness, 1e-4); // Keep only the excess. // Nur den Überschuss behalten.
+    }
+    return color;
+}
+void main() {
+    vec2 h = texelSize * 0.5; // Half-texel offset. // Halb-Texel-Versatz.
+    vec3 sum = Fetch(uv) * 4.0; // Center weight. // Zentrumsgewicht.
+    sum += Fetch(uv - h) + Fetch(uv + h); // Diagonal taps. // Diagonale Abtastungen.
+    sum += Fetch(uv + vec2(h.x, -h.y)) + Fetch(uv - vec2(h.x, -h.y));
+    FragColor = vec4(sum / 8.0, 1.0); // Normalize. // Normalisieren.
+})glsl";
+
+/// Bloom upsample fragment shader source code in GLSL
+/// EN: Dual-filter (Kawase) upsample with 8 bilinear taps, added onto the next larger level
+/// DE: Dual-Filter-(Kawase-)Upsampling mit 8 bilinearen Abtastungen, auf die nächstgrößere Stufe addiert
+const char* bloomUpsampleFragmentSource = R"glsl(
+#version 330 core
+in vec2 uv; // Texture coordinate. // Texturkoordinate.
+out vec4 FragColor; // Output color. // Ausgabefarbe.
+uniform sampler2D source; // Smaller bloom level. // Kleinere Bloom-Stufe.
+uniform vec2 texelSize; // Texel size of the source. // Texelgröße der Quelle.
+void main() {
+    vec2 h = texelSize * 0.5; // Half-texel offset. // Halb-Texel-Versatz.
+    vec3 sum = texture(source, uv + vec2(-h.x * 2.0, 0.0)).rgb; // Edge taps. // Kanten-Abtastungen.
+    sum += texture(source, uv + vec2(h.x * 2.0, 0.0)).rgb;
+    sum += texture(source, uv + vec2(0.0, -h.y * 2.0)).rgb;
+    sum += texture(source, uv + vec2(0.0, h.y * 2.0)).rgb;
+    sum += texture(source, uv + vec2(-h.x, h.y)).rgb * 2.0; // Diagonal taps. // Diagonale Abtastungen.
+    sum += texture(source, uv + vec2(h.x, h.y)).rgb * 2.0;
+    sum += texture(source, uv + vec2(h.x, -h.y)).rgb * 2.0;
+    sum += texture(source, uv + vec2(-h.x, -h.y)).rgb * 2.0;
+    FragColor = vec4(sum / 12.0, 1.0); // Normalize. // Normalisieren.
+})glsl";
+
+/// Composite fragment shader source code in GLSL
+/// EN: Adds the bloom to the HDR scene and writes the result to the window
+/// DE: Addiert den Bloom zur HDR-Szene und schreibt das Ergebnis ins Fenster
+const char* compositeFragmentSource = R"glsl(
+#version 330 core
+in vec2 uv; // Texture coordinate. // Texturkoordinate.
+out vec4 FragColor; // Output color. // Ausgabefarbe.
+uniform sampler2D scene; // HDR scene color. // HDR-Szenenfarbe.
+uniform sampler2D bloom; // Half-resolution bloom. // Bloom in halber Auflösung.
+uniform float bloomIntensity; // Bloom strength. // Bloom-Stärke.
+void main() {
+    vec3 color = texture(scene, uv).rgb + texture(bloom, uv).rgb * bloomIntensity; // Add glow. // Leuchten addieren.
+    FragColor = vec4(min(color, vec3(1.0)), 1.0); // Clamp to display range. // Auf Anzeigebereich begrenzen.
+})glsl";
+
 // Global simulation state variables. // Globale Simulationszustandsvariablen.
 bool running = true; // Main loop control flag. // Hauptschleifen-Kontrollflag.
-bool pause = true; // Simulation pause state. // Simulationspausenzustand.
-glm::vec3 cameraPos   = glm::vec3(0.0f, 0.0f,  1.0f); // Camera position in world space. // Kameraposition im Weltraum.
+bool paused = true; // Simulation pause state. // Simulationspausenzustand.
+glm::dvec3 cameraPos  = glm::dvec3(0.0, 0.0,  1.0); // Camera position in world space (meters). // Kameraposition im Weltraum (Meter).
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f); // Camera forward direction. // Kamera-Vorwärtsrichtung.
 glm::vec3 cameraUp    = glm::vec3(0.0f, 1.0f,  0.0f); // Camera up vector. // Kamera-Aufwärtsvektor.
 float lastX = 400.0, lastY = 300.0; // Last mouse position. // Letzte Mausposition.
@@ -70,313 +245,4698 @@ float yaw = -90; // Camera yaw angle in degrees. // Kamera-Gierwinkel in Grad.
 float pitch = 0.0; // Camera pitch angle in degrees. // Kamera-Nickwinkel in Grad.
 float deltaTime = 0.0; // Time between frames. // Zeit zwischen Frames.
 float lastFrame = 0.0; // Time of last frame. // Zeit des letzten Frames.
+bool showProfiler = true; // Show GPU profiler overlay (toggle with P). // Zeige GPU-Profiler-Overlay (umschalten mit P).
+int windowWidth = 800, windowHeight = 600; // Window framebuffer size in pixels. // Fenster-Framebuffergröße in Pixeln.
+bool windowResized = false; // Framebuffer size changed since last frame. // Framebuffergröße seit letztem Frame geändert.
+float fovY = 45.0f; // Vertical field of view in degrees. // Vertikales Sichtfeld in Grad.
+const float nearPlane = 10.0f; // Near plane in meters; the far plane is at infinity. // Nahebene in Metern; die Fernebene liegt im Unendlichen.
+bool reversedZ = false; // Depth runs 1 (near) to 0 (infinity). // Tiefe läuft von 1 (nah) bis 0 (unendlich).
 
 // Physical constants. // Physikalische Konstanten.
 const double G = 6.6743e-11; // Gravitational constant in m^3 kg^-1 s^-2. // Gravitationskonstante in m^3 kg^-1 s^-2.
 const float c = 299792458.0; // Speed of light in m/s. // Lichtgeschwindigkeit in m/s.
 float initMass = float(pow(10, 22)); // Initial mass for new objects in kg. // Anfangsmasse für neue Objekte in kg.
-float sizeRatio = 30000.0f; // Scale factor for visual representation. // Skalierungsfaktor für visuelle Darstellung.
+double simTimeStep = 600.0; // Simulated seconds per frame. // Simulierte Sekunden pro Frame.
+const double gridSize = 6.0e8; // Grid edge length in meters. // Gitter-Kantenlänge in Metern.
+const double gridWarpExaggeration = 1.0e4; // Flamm's paraboloid is only meters deep at these masses. // Flamms Paraboloid ist bei diesen Massen nur Meter tief.
+const char* shaderCacheDir = "shader_cache"; // Directory for cached program binaries. // Verzeichnis für zwischengespeicherte Programm-Binärdateien.
+
+// Quality knobs adjusted by the governor. // Vom Regler angepasste Qualitätsstellgrößen.
+int gridDivisions = 25; // Grid cells per side. // Gitterzellen pro Seite.
+int substeps = 1; // Physics substeps per frame. // Physik-Teilschritte pro Frame.
+
+// Run state saved in checkpoints. // In Checkpoints gespeicherter Laufzustand.
+double simTime = 0.0; // Simulated seconds since the start. // Simulierte Sekunden seit dem Start.
+uint64_t stepCount = 0; // Completed simulation frames. // Abgeschlossene Simulations-Frames.
+std::string checkpointPath = "checkpoint.gsim"; // File for F5/F9. // Datei für F5/F9.
+std::string loadPath; // Checkpoint or scenario to start from, if any. // Checkpoint oder Szenario, von dem gestartet wird, falls vorhanden.
+std::string trajectoryPath; // Trajectory output file, if any. // Trajektorien-Ausgabedatei, falls vorhanden.
+int trajectoryEvery = 10; // Frames between trajectory snapshots. // Frames zwischen Trajektorien-Schnappschüssen.
+bool trajectoryDirectIO = false; // Write trajectories with O_DIRECT. // Trajektorien mit O_DIRECT schreiben.
+double trajectoryError = 0.0; // Position error bound in m for compressed trajectories, 0 for raw. // Positionsfehlergrenze in m für komprimierte Trajektorien, 0 für roh.
+std::string replayPath; // Recording to play back instead of simulating, if any. // Statt zu simulieren abzuspielende Aufzeichnung, falls vorhanden.
+int headlessFrames = 0; // Frames to run without a window, 0 for the viewer. // Ohne Fenster zu rechnende Frames, 0 für den Viewer.
 
 // Function declarations. // Funktionsdeklarationen.
 GLFWwindow* StartGLU(); // Initializes OpenGL context and window. // Initialisiert OpenGL-Kontext und Fenster.
-GLuint CreateShaderProgram(const char* vertexSource, const char* fragmentSource); // Creates shader program. // Erstellt Shader-Programm.
+GLuint CreateShaderProgram(const char* vertexSource, const char* fragmentSource, bool retrievable = false); // Creates shader program. // Erstellt Shader-Programm.
+GLuint LoadShaderProgram(const char* vertexSource, const char* fragmentSource); // Loads shader program from binary cache or compiles it. // Lädt Shader-Programm aus Binär-Cache oder kompiliert es.
 void CreateVBOVAO(GLuint& VAO, GLuint& VBO, const float* vertices, size_t vertexCount); // Creates vertex buffers. // Erstellt Vertex-Buffer.
-void UpdateCam(GLuint shaderProgram, glm::vec3 cameraPos); // Updates camera matrices. // Aktualisiert Kameramatrizen.
+void UploadStreamBuffer(GLenum target, GLuint buffer, GLsizeiptr& capacity, const void* data, GLsizeiptr size); // Refills a pooled buffer. // Befüllt einen gepoolten Buffer neu.
+glm::mat4 UpdateCam(GLuint shaderProgram); // Updates camera matrices. // Aktualisiert Kameramatrizen.
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods); // Handles keyboard input. // Verarbeitet Tastatureingaben.
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods); // Handles mouse buttons. // Verarbeitet Maustasten.
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset); // Handles mouse scroll. // Verarbeitet Mausrad.
+void framebuffer_size_callback(GLFWwindow* window, int width, int height); // Handles window resizing. // Verarbeitet Fenstergrößenänderungen.
+bool ParseArguments(int argc, char** argv); // Reads command-line options. // Liest Kommandozeilenoptionen.
+bool SetUpScene(); // Creates the initial bodies. // Erstellt die Anfangskörper.
+int RunHeadless(int frames); // Simulates without a window. // Simuliert ohne Fenster.
+glm::mat4 UpdateProjection(std::initializer_list<GLuint> programs); // Rebuilds and uploads the projection matrix. // Erstellt und lädt die Projektionsmatrix neu.
 void mouse_callback(GLFWwindow* window, double xpos, double ypos); // Handles mouse movement. // Verarbeitet Mausbewegung.
 glm::vec3 sphericalToCartesian(float r, float theta, float phi); // Converts spherical to Cartesian coordinates. // Konvertiert sphärische zu kartesischen Koordinaten.
+std::vector<float> CreateSphereVertices(float radius, int stacks, int sectors); // Generates a triangulated sphere. // Generiert eine triangulierte Kugel.
 void DrawGrid(GLuint shaderProgram, GLuint gridVAO, size_t vertexCount); // Renders the grid. // Rendert das Gitter.
+void DrawProfilerOverlay(GLuint overlayProgram, GLuint overlayVAO, GLuint overlayVBO, const double* passMs); // Renders GPU timing bars. // Rendert GPU-Zeitbalken.
+void UpdateWindowTitle(GLFWwindow* window, const double* passMs); // Shows GPU pass times in the title bar. // Zeigt GPU-Pass-Zeiten in der Titelleiste.
 
 /// Object Class
 /// 
-/// Represents a celestial body in the simulation with physical properties and rendering data.
-/// Each object has mass, velocity, position, and visual representation as a sphere.
+/// Represents a celestial body in the simulation with physical properties and appearance.
+/// Each object has mass, velocity, position, and is drawn as an instance of the shared sphere meshes.
 /// 
-/// EN: Manages individual gravitational objects with physics simulation and OpenGL rendering.
-/// DE: Verwaltet einzelne Gravitationsobjekte mit Physiksimulation und OpenGL-Rendering.
+/// EN: Plain data without GL resources, so bodies can be created, copied and destroyed freely.
+/// DE: Reine Daten ohne GL-Ressourcen, sodass Körper frei erstellt, kopiert und zerstört werden können.
 class Object {
     public:
-        GLuint VAO, VBO; // OpenGL vertex array and buffer objects. // OpenGL Vertex-Array- und Buffer-Objekte.
-        glm::vec3 position = glm::vec3(400, 300, 0); // Current position in world space. // Aktuelle Position im Weltraum.
-        glm::vec3 velocity = glm::vec3(0, 0, 0); // Current velocity vector. // Aktueller Geschwindigkeitsvektor.
-        size_t vertexCount; // Number of vertices in the mesh. // Anzahl der Vertices im Mesh.
+        glm::dvec3 position = glm::dvec3(0, 0, 0); // Current position in world space (m). // Aktuelle Position im Weltraum (m).
+        glm::dvec3 velocity = glm::dvec3(0, 0, 0); // Current velocity vector (m/s). // Aktueller Geschwindigkeitsvektor (m/s).
         glm::vec4 color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f); // RGBA color of the object. // RGBA-Farbe des Objekts.
 
         bool Initalizing = false; // Object is being created by user. // Objekt wird vom Benutzer erstellt.
         bool Launched = false; // Object has been released. // Objekt wurde freigegeben.
         bool target = false; // Object is targeted (unused). // Objekt ist anvisiert (unbenutzt).
 
-        float mass; // Mass of the object in kg. // Masse des Objekts in kg.
-        float density;  // Density in kg/m^3. // Dichte in kg/m^3.
-        float radius; // Visual radius of the sphere. // Visueller Radius der Kugel.
+        float mass; // Mass of the object in kg. // Masse des Objekts in kg.
+        float density;  // Density in kg/m^3. // Dichte in kg/m^3.
+        float radius; // Physical radius of the sphere in meters. // Physikalischer Radius der Kugel in Metern.
+
+        glm::dvec3 LastPos = position; // Previous position (unused). // Vorherige Position (unbenutzt).
+        bool glow; // Whether object should glow. // Ob Objekt leuchten soll.
+
+        /// Constructor for creating a new gravitational object
+        /// EN: Initializes object with physical properties
+        /// DE: Initialisiert Objekt mit physikalischen Eigenschaften
+        Object(glm::dvec3 initPosition, glm::dvec3 initVelocity, float mass, float density = 3344, glm::vec4 color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f), bool Glow = false) {   
+            this->position = initPosition; // Set initial position. // Setze Anfangsposition.
+            this->velocity = initVelocity; // Set initial velocity. // Setze Anfangsgeschwindigkeit.
+            this->mass = mass; // Set object mass. // Setze Objektmasse.
+            this->density = density; // Set material density. // Setze Materialdichte.
+            this->radius = pow(((3 * this->mass/this->density)/(4 * 3.14159265359)), (1.0f/3.0f)); // Calculate radius from mass and density. // Berechne Radius aus Masse und Dichte.
+            this->color = color; // Set object color. // Setze Objektfarbe.
+            this->glow = Glow; // Set glow effect. // Setze Leuchteffekt.
+        }
+        
+        /// Updates object position based on velocity
+        /// EN: Integrates velocity over dt seconds
+        /// DE: Integriert Geschwindigkeit über dt Sekunden
+        void UpdatePos(double dt){
+            this->position[0] += this->velocity[0] * dt; // Update X position. // Aktualisiere X-Position.
+            this->position[1] += this->velocity[1] * dt; // Update Y position. // Aktualisiere Y-Position.
+            this->position[2] += this->velocity[2] * dt; // Update Z position. // Aktualisiere Z-Position.
+            this->radius = pow(((3 * this->mass/this->density)/(4 * 3.14159265359)), (1.0f/3.0f)); // Recalculate radius. // Berechne Radius neu.
+        }
+        
+        /// Returns current position
+        /// EN: Getter for object position
+        /// DE: Getter für Objektposition
+        glm::dvec3 GetPos() const {
+            return this->position;
+        }
+        
+        /// Applies acceleration to velocity
+        /// EN: Integrates an acceleration in m/s^2 over dt seconds
+        /// DE: Integriert eine Beschleunigung in m/s^2 über dt Sekunden
+        void accelerate(double x, double y, double z, double dt){
+            this->velocity[0] += x * dt; // Apply X acceleration. // Wende X-Beschleunigung an.
+            this->velocity[1] += y * dt; // Apply Y acceleration. // Wende Y-Beschleunigung an.
+            this->velocity[2] += z * dt; // Apply Z acceleration. // Wende Z-Beschleunigung an.
+        }
+        
+        /// Checks collision with another object
+        /// EN: Returns velocity damping factor if objects collide
+        /// DE: Gibt Geschwindigkeitsdämpfungsfaktor zurück wenn Objekte kollidieren
+        float CheckCollision(const Object& other) {
+            double dx = other.position[0] - this->position[0]; // X distance. // X-Abstand.
+            double dy = other.position[1] - this->position[1]; // Y distance. // Y-Abstand.
+            double dz = other.position[2] - this->position[2]; // Z distance. // Z-Abstand.
+            double distance = std::sqrt(dx*dx + dy*dy + dz*dz); // Calculate Euclidean distance. // Berechne euklidischen Abstand.
+            if (other.radius + this->radius > distance){ // Check if spheres overlap. // Prüfe ob Kugeln überlappen.
+                return -0.2f; // Return damping factor. // Gebe Dämpfungsfaktor zurück.
+            }
+            return 1.0f; // No collision. // Keine Kollision.
+        }
+};
+
+/// Slot Handle
+/// EN: Stable reference to an element of a SlotMap; the generation detects handles to removed elements
+/// DE: Stabile Referenz auf ein Element einer SlotMap; die Generation erkennt Handles auf entfernte Elemente
+struct SlotHandle {
+    uint32_t index = UINT32_MAX; // Slot index, UINT32_MAX for none. // Slot-Index, UINT32_MAX für keinen.
+    uint32_t generation = 0; // Slot generation when the handle was issued. // Slot-Generation bei Ausgabe des Handles.
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/// Slot Map Class
+/// 
+/// Generational slot map: elements live densely packed in a vector for fast iteration,
+/// while handles go through a slot table that survives removals and reordering.
+/// Insert and remove are O(1); removal moves the last element into the gap and bumps the slot generation.
+/// 
+/// EN: Container with stable handles and contiguous storage.
+/// DE: Container mit stabilen Handles und zusammenhängendem Speicher.
+template <typename T>
+class SlotMap {
+    public:
+        /// Inserts an element
+        /// EN: Reuses a free slot if there is one; returns the handle of the new element
+        /// DE: Verwendet einen freien Slot, falls vorhanden; gibt das Handle des neuen Elements zurück
+        SlotHandle Insert(T value) {
+            uint32_t slot; // Slot for the new element. // Slot für das neue Element.
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back(); // Recycle. // Wiederverwenden.
+                freeSlots.pop_back();
+            } else {
+                slot = (uint32_t)slots.size(); // New slot. // Neuer Slot.
+                slots.push_back(Slot{ 0, 0 });
+            }
+            slots[slot].denseIndex = (uint32_t)dense.size();
+            dense.push_back(std::move(value));
+            denseToSlot.push_back(slot);
+            return SlotHandle{ slot, slots[slot].generation };
+        }
+
+        /// Removes the element behind a handle
+        /// EN: The last element moves into the gap, so dense indices change but handles stay valid; returns false for stale handles
+        /// DE: Das letzte Element rückt in die Lücke, Dense-Indizes ändern sich also, Handles bleiben gültig; gibt false für veraltete Handles zurück
+        bool Remove(SlotHandle handle) {
+            if (!Contains(handle)) return false;
+            uint32_t gap = slots[handle.index].denseIndex; // Position to fill. // Zu füllende Position.
+            uint32_t last = (uint32_t)dense.size() - 1; // Element that moves. // Element, das verschoben wird.
+            if (gap != last) {
+                dense[gap] = std::move(dense[last]);
+                denseToSlot[gap] = denseToSlot[last];
+                slots[denseToSlot[gap]].denseIndex = gap; // Repoint moved element. // Verschobenes Element neu verweisen.
+            }
+            dense.pop_back();
+            denseToSlot.pop_back();
+            ++slots[handle.index].generation; // Invalidate outstanding handles. // Ausstehende Handles ungültig machen.
+            freeSlots.push_back(handle.index);
+            return true;
+        }
+
+        /// Checks a handle
+        /// EN: True if the handle refers to a live element
+        /// DE: True, wenn das Handle auf ein lebendes Element verweist
+        bool Contains(SlotHandle handle) const {
+            return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+        }
+
+        /// Resolves a handle
+        /// EN: Pointer to the element, or nullptr for stale handles; valid until the next insert or remove
+        /// DE: Zeiger auf das Element oder nullptr für veraltete Handles; gültig bis zum nächsten Einfügen oder Entfernen
+        T* Get(SlotHandle handle) { return Contains(handle) ? &dense[slots[handle.index].denseIndex] : nullptr; }
+        const T* Get(SlotHandle handle) const { return Contains(handle) ? &dense[slots[handle.index].denseIndex] : nullptr; }
+
+        /// Handle of the element at a dense position
+        /// EN: Converts iteration order back into a stable handle
+        /// DE: Wandelt die Iterationsreihenfolge zurück in ein stabiles Handle
+        SlotHandle HandleAt(size_t denseIndex) const {
+            uint32_t slot = denseToSlot[denseIndex];
+            return SlotHandle{ slot, slots[slot].generation };
+        }
+
+        // Dense access for iteration. // Dichter Zugriff für Iteration.
+        T& operator[](size_t denseIndex) { return dense[denseIndex]; }
+        const T& operator[](size_t denseIndex) const { return dense[denseIndex]; }
+        size_t size() const { return dense.size(); }
+        bool empty() const { return dense.empty(); }
+        typename std::vector<T>::iterator begin() { return dense.begin(); }
+        typename std::vector<T>::iterator end() { return dense.end(); }
+        typename std::vector<T>::const_iterator begin() const { return dense.begin(); }
+        typename std::vector<T>::const_iterator end() const { return dense.end(); }
+
+        /// Reserves capacity
+        /// EN: Avoids reallocation while spawning up to n elements
+        /// DE: Vermeidet Neuzuweisung beim Erzeugen von bis zu n Elementen
+        void reserve(size_t n) {
+            dense.reserve(n);
+            denseToSlot.reserve(n);
+            slots.reserve(n);
+        }
+
+    private:
+        struct Slot {
+            uint32_t denseIndex; // Position in dense. // Position in dense.
+            uint32_t generation; // Bumped on every removal. // Wird bei jedem Entfernen erhöht.
+        };
+        std::vector<T> dense; // Packed elements. // Gepackte Elemente.
+        std::vector<uint32_t> denseToSlot; // Slot of each dense element. // Slot jedes dichten Elements.
+        std::vector<Slot> slots; // Handle indirection. // Handle-Indirektion.
+        std::vector<uint32_t> freeSlots; // Recyclable slots. // Wiederverwendbare Slots.
+};
+
+using BodyHandle = SlotHandle; // Stable reference to a body. // Stabile Referenz auf einen Körper.
+SlotMap<Object> objs; // Container for all objects in simulation. // Container für alle Objekte in der Simulation.
+BodyHandle creatingBody; // Body being placed by the user, if any. // Vom Benutzer platzierter Körper, falls vorhanden.
+
+void StepSimulation(double dt, bool applyCollisions); // Advances all objects by one substep. // Rückt alle Objekte um einen Teilschritt vor.
+
+// Grid function declarations. // Grid-Funktionsdeklarationen.
+std::vector<double> CreateGridVertices(double size, int divisions, const SlotMap<Object>& objs); // Creates grid mesh. // Erstellt Grid-Mesh.
+std::vector<double> UpdateGridVertices(std::vector<double> vertices, const SlotMap<Object>& objs); // Updates grid deformation. // Aktualisiert Grid-Verformung.
+std::vector<float> ToCameraRelative(const std::vector<double>& vertices); // Rebases world vertices to the camera. // Verschiebt Welt-Vertices relativ zur Kamera.
+
+GLuint gridVAO, gridVBO; // OpenGL objects for grid rendering. // OpenGL-Objekte für Grid-Rendering.
+GLuint overlayVAO, overlayVBO; // OpenGL objects for profiler overlay rendering. // OpenGL-Objekte für Profiler-Overlay-Rendering.
+GLsizeiptr gridCapacity = 0, overlayCapacity = 0; // Allocated bytes of the streamed buffers. // Belegte Bytes der gestreamten Buffer.
+
+// Sphere levels of detail shared by all bodies, finest first. // Von allen Körpern geteilte Kugel-Detailstufen, feinste zuerst.
+const int LOD_COUNT = 4; // Number of sphere meshes. // Anzahl der Kugel-Meshes.
+const int lodSegments[LOD_COUNT] = { 24, 16, 10, 6 }; // Stacks and sectors per level. // Stapel und Sektoren pro Stufe.
+const float lodMinPixels[LOD_COUNT] = { 200.0f, 60.0f, 15.0f, 0.0f }; // Minimum projected diameter per level. // Minimaler projizierter Durchmesser pro Stufe.
+float lodBias = 1.0f; // Scales projected size before LOD selection (<1 = coarser). // Skaliert projizierte Größe vor LOD-Auswahl (<1 = gröber).
+GLint lodFirst[LOD_COUNT], lodVertexCount[LOD_COUNT]; // Vertex range of each level in the mesh buffer. // Vertex-Bereich jeder Stufe im Mesh-Buffer.
+GLuint bodyVAO, sphereVBO, instanceVBO, indirectBuffer; // OpenGL objects for batched body rendering. // OpenGL-Objekte für gebündeltes Körper-Rendering.
+GLsizeiptr instanceCapacity = 0; // Allocated bytes of the instance buffer. // Belegte Bytes des Instanz-Buffers.
+const int initialInstanceCapacity = 4096; // Bodies the instance buffer holds before it first grows. // Körper, die der Instanz-Buffer vor dem ersten Wachsen fasst.
+bool multiDrawIndirect = false; // glMultiDrawArraysIndirect available. // glMultiDrawArraysIndirect verfügbar.
+
+/// Per-instance data of a body draw
+/// EN: Matches vertex attributes 1-3 of the body shader
+/// DE: Entspricht den Vertex-Attributen 1-3 des Körper-Shaders
+struct BodyInstance {
+    glm::vec4 positionRadius; // World position and radius. // Weltposition und Radius.
+    glm::vec4 color; // Base color. // Grundfarbe.
+    float glow; // 1 for glowing bodies, 0 otherwise. // 1 für leuchtende Körper, sonst 0.
+};
+
+/// Indirect draw command
+/// EN: Layout defined by the GL spec for glMultiDrawArraysIndirect
+/// DE: Vom GL-Standard für glMultiDrawArraysIndirect festgelegtes Layout
+struct DrawArraysIndirectCommand {
+    GLuint count; // Vertices per instance. // Vertices pro Instanz.
+    GLuint instanceCount; // Number of instances. // Anzahl der Instanzen.
+    GLuint first; // First vertex in the mesh buffer. // Erster Vertex im Mesh-Buffer.
+    GLuint baseInstance; // First instance in the instance buffer. // Erste Instanz im Instanz-Buffer.
+};
+
+std::vector<BodyInstance> bodyInstances; // Instances of the current frame, sorted by LOD. // Instanzen des aktuellen Frames, nach LOD sortiert.
+std::vector<DrawArraysIndirectCommand> bodyCommands; // One command per non-empty LOD. // Ein Befehl pro nicht-leerem LOD.
+
+// Batched body rendering declarations. // Deklarationen für gebündeltes Körper-Rendering.
+void CreateBodyBuffers(); // Builds LOD meshes and instance/indirect buffers. // Erstellt LOD-Meshes und Instanz-/Indirekt-Buffer.
+void BuildBodyDrawCommands(const SlotMap<Object>& objs, const glm::mat4& viewProjection); // Culls bodies and fills draw commands. // Verwirft Körper und füllt Zeichenbefehle.
+void DrawBodies(GLuint shaderProgram); // Submits all body batches. // Sendet alle Körper-Batches.
+
+// Render passes measured by the GPU timer. // Vom GPU-Timer gemessene Render-Passes.
+enum GpuPass { PASS_GRID_UPLOAD, PASS_GRID_DRAW, PASS_BODIES, PASS_POST, PASS_COUNT };
+const char* gpuPassNames[PASS_COUNT] = { "grid upload", "grid draw", "bodies", "post" }; // Display names. // Anzeigenamen.
+const float gpuPassColors[PASS_COUNT][3] = { {0.2f, 0.6f, 1.0f}, {0.2f, 1.0f, 0.4f}, {1.0f, 0.6f, 0.1f}, {0.9f, 0.3f, 0.9f} }; // Overlay bar colors. // Overlay-Balkenfarben.
+
+/// GPU Timer Class
+/// 
+/// Wraps one GL_TIME_ELAPSED query per render pass and keeps several frames of queries in flight.
+/// Results are read back GPU_TIMER_LATENCY frames later and only if available, so the CPU never waits on the GPU.
+/// 
+/// EN: Measures per-pass GPU time asynchronously without stalling the pipeline.
+/// DE: Misst die GPU-Zeit pro Pass asynchron, ohne die Pipeline anzuhalten.
+class GpuTimer {
+    public:
+        static const int GPU_TIMER_LATENCY = 4; // Frames between issue and readback. // Frames zwischen Absenden und Auslesen.
+        GLuint queries[GPU_TIMER_LATENCY][PASS_COUNT]; // Query objects per frame slot and pass. // Query-Objekte pro Frame-Slot und Pass.
+        bool issued[GPU_TIMER_LATENCY][PASS_COUNT] = {}; // Whether a query was issued in that slot. // Ob in diesem Slot eine Query abgesetzt wurde.
+        double passMs[PASS_COUNT] = {}; // Smoothed GPU time per pass in ms. // Geglättete GPU-Zeit pro Pass in ms.
+        double lastMs[PASS_COUNT] = {}; // Latest raw GPU time per pass in ms. // Letzte rohe GPU-Zeit pro Pass in ms.
+        bool supported = false; // Timer queries available on this driver. // Timer-Queries auf diesem Treiber verfügbar.
+        long long frame = 0; // Current frame number. // Aktuelle Frame-Nummer.
+        long long sampleFrame = -1; // Frame the pass times read back last were issued in. // Frame, in dem die zuletzt ausgelesenen Pass-Zeiten abgesetzt wurden.
+        int activePass = -1; // Pass currently being measured. // Aktuell gemessener Pass.
+
+        /// Creates query objects
+        /// EN: Allocates all queries up front; disables itself if timer queries are unsupported
+        /// DE: Legt alle Queries vorab an; deaktiviert sich, wenn Timer-Queries nicht unterstützt werden
+        void Init() {
+            supported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query; // Core since OpenGL 3.3. // Core seit OpenGL 3.3.
+            if (!supported) {
+                std::cerr << "GL timer queries not supported, GPU profiling disabled." << std::endl; // Warning. // Warnung.
+                return;
+            }
+            glGenQueries(GPU_TIMER_LATENCY * PASS_COUNT, &queries[0][0]); // Generate all queries. // Generiere alle Queries.
+        }
+
+        /// Collects results issued GPU_TIMER_LATENCY frames ago
+        /// EN: Returns true if a complete set of pass times was read back this frame
+        /// DE: Gibt true zurück, wenn in diesem Frame ein vollständiger Satz Pass-Zeiten gelesen wurde
+        bool BeginFrame() {
+            if (!supported) return false;
+            int slot = frame % GPU_TIMER_LATENCY; // Slot about to be reused. // Slot, der wiederverwendet wird.
+            bool complete = true; // All passes read back. // Alle Passes ausgelesen.
+            sampleFrame = frame - GPU_TIMER_LATENCY; // The slot was last filled that many frames ago. // Der Slot wurde zuletzt so viele Frames zuvor gefüllt.
+            for (int pass = 0; pass < PASS_COUNT; ++pass) {
+                if (!issued[slot][pass]) { complete = false; continue; } // Nothing to read. // Nichts zu lesen.
+                GLint available = 0; // Result availability. // Ergebnisverfügbarkeit.
+                glGetQueryObjectiv(queries[slot][pass], GL_QUERY_RESULT_AVAILABLE, &available); // Non-blocking check. // Nicht-blockierende Prüfung.
+                issued[slot][pass] = false; // Slot is reissued either way. // Slot wird in jedem Fall neu abgesetzt.
+                if (!available) { complete = false; continue; } // Drop sample instead of stalling. // Messwert verwerfen statt zu warten.
+                GLuint64 elapsedNs = 0; // Elapsed GPU time in nanoseconds. // Vergangene GPU-Zeit in Nanosekunden.
+                glGetQueryObjectui64v(queries[slot][pass], GL_QUERY_RESULT, &elapsedNs); // Read result. // Lese Ergebnis.
+                lastMs[pass] = elapsedNs / 1.0e6; // Convert to milliseconds. // Konvertiere in Millisekunden.
+                passMs[pass] = passMs[pass] * 0.9 + lastMs[pass] * 0.1; // Exponential smoothing for display. // Exponentielle Glättung für Anzeige.
+            }
+            return complete;
+        }
+
+        /// Starts measuring a render pass
+        /// EN: Begins the GL_TIME_ELAPSED query of the pass in the current frame slot
+        /// DE: Startet die GL_TIME_ELAPSED-Query des Passes im aktuellen Frame-Slot
+        void Begin(int pass) {
+            if (!supported) return;
+            int slot = frame % GPU_TIMER_LATENCY; // Current slot. // Aktueller Slot.
+            glBeginQuery(GL_TIME_ELAPSED, queries[slot][pass]); // Start query. // Starte Query.
+            activePass = pass; // Remember pass. // Merke Pass.
+        }
+
+        /// Stops measuring the active render pass
+        /// EN: Time-elapsed queries cannot nest, so passes are measured back to back
+        /// DE: Time-Elapsed-Queries können nicht verschachtelt werden, daher werden Passes nacheinander gemessen
+        void End() {
+            if (!supported || activePass < 0) return;
+            glEndQuery(GL_TIME_ELAPSED); // Stop query. // Stoppe Query.
+            issued[frame % GPU_TIMER_LATENCY][activePass] = true; // Mark for readback. // Zum Auslesen markieren.
+            activePass = -1; // No active pass. // Kein aktiver Pass.
+        }
+
+        /// Advances to the next frame slot
+        /// EN: Called once per frame after all passes were submitted
+        /// DE: Wird einmal pro Frame aufgerufen, nachdem alle Passes abgesetzt wurden
+        void EndFrame() {
+            ++frame; // Next frame. // Nächster Frame.
+        }
+
+        /// Deletes query objects
+        /// EN: Releases all GL queries
+        /// DE: Gibt alle GL-Queries frei
+        void Destroy() {
+            if (supported) glDeleteQueries(GPU_TIMER_LATENCY * PASS_COUNT, &queries[0][0]); // Delete queries. // Lösche Queries.
+        }
+};
+
+GpuTimer gpuTimer; // GPU pass timer. // GPU-Pass-Timer.
+
+// The CPU frame profiler is opt-in: build with -DGRAVITY_SIM_PROFILER=1 to record zones and write traces. // Der CPU-Frame-Profiler ist optional: mit -DGRAVITY_SIM_PROFILER=1 bauen, um Zonen aufzuzeichnen und Traces zu schreiben.
+#ifndef GRAVITY_SIM_PROFILER
+#define GRAVITY_SIM_PROFILER 0
+#endif
+const char* traceFile = "trace.json"; // Chrome trace written by F8 and at exit. // Von F8 und beim Beenden geschriebener Chrome-Trace.
+
+#if GRAVITY_SIM_PROFILER
+/// Frame Profiler Class
+/// 
+/// Scoped CPU zones stamped with the time-stamp counter (steady_clock on CPUs without one). Every thread that records
+/// claims one of LANES fixed rings on first use and releases it on exit; the ParallelFor pool helpers keep theirs for the
+/// whole run, and recording never allocates or locks. Zones nest by time, which Chrome's trace viewer and Perfetto show as a
+/// hierarchy; the ring keeps the newest EVENTS zones per lane.
+/// 
+/// EN: Measures where each frame's CPU time goes, per phase and per thread.
+/// DE: Misst, wohin die CPU-Zeit jedes Frames geht, pro Phase und pro Thread.
+class FrameProfiler {
+    public:
+        static const int LANES = 32; // Threads recording at the same time. // Gleichzeitig aufzeichnende Threads.
+        static const uint64_t EVENTS = 8192; // Newest zones kept per lane. // Pro Spur behaltene neueste Zonen.
+
+        struct Event {
+            const char* name; // Static zone name. // Statischer Zonenname.
+            uint64_t begin, end; // Ticks. // Ticks.
+        };
+        struct Lane {
+            std::atomic<bool> claimed{ false }; // Owned by a live thread. // Gehört einem lebenden Thread.
+            std::atomic<uint64_t> written{ 0 }; // Zones recorded so far. // Bisher aufgezeichnete Zonen.
+            Event events[EVENTS]; // Ring, index written % EVENTS. // Ring, Index written % EVENTS.
+        };
+
+        /// Starts the clock
+        /// EN: Runs during static initialization, so the main thread takes lane 0
+        /// DE: Läuft während der statischen Initialisierung, daher bekommt der Haupt-Thread Spur 0
+        FrameProfiler() : startTime(std::chrono::steady_clock::now()), startTicks(Ticks()) {
+            ThisLane();
+        }
+
+        /// Reads the tick counter
+        /// EN: RDTSC on x86, which is invariant on current CPUs; steady_clock nanoseconds elsewhere
+        /// DE: RDTSC auf x86, auf aktuellen CPUs invariant; sonst steady_clock-Nanosekunden
+        static uint64_t Ticks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+
+        /// Stores a finished zone
+        /// EN: Called by ProfileZone; drops the zone if all lanes are taken
+        /// DE: Von ProfileZone aufgerufen; verwirft die Zone, wenn alle Spuren belegt sind
+        void Record(const char* name, uint64_t begin, uint64_t end) {
+            Lane* lane = ThisLane(); // Ring of this thread. // Ring dieses Threads.
+            if (!lane) return;
+            uint64_t index = lane->written.load(std::memory_order_relaxed); // Only this thread writes. // Nur dieser Thread schreibt.
+            lane->events[index % EVENTS] = { name, begin, end };
+            lane->written.store(index + 1, std::memory_order_release);
+        }
+
+        /// Writes the rings as Chrome trace JSON
+        /// EN: Complete events ("ph":"X") in microseconds since start, one tid per lane; load in chrome://tracing or ui.perfetto.dev
+        /// DE: Vollständige Ereignisse ("ph":"X") in Mikrosekunden seit dem Start, eine tid pro Spur; in chrome://tracing oder ui.perfetto.dev laden
+        bool WriteTrace(const char* path) {
+            double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count(); // Calibrates the ticks. // Kalibriert die Ticks.
+            double usPerTick = elapsedUs / std::max<double>(1.0, double(Ticks() - startTicks)); // Tick length. // Tick-Länge.
+            std::ofstream trace(path, std::ios::trunc); // Output file. // Ausgabedatei.
+            trace << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+            bool first = true; // Comma handling. // Komma-Behandlung.
+            size_t zones = 0; // Written zones. // Geschriebene Zonen.
+            for (int l = 0; l < LANES; ++l) {
+                uint64_t written = lanes[l].written.load(std::memory_order_acquire); // Zones of this lane. // Zonen dieser Spur.
+                if (written == 0) continue;
+                trace << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << l
+                      << ",\"args\":{\"name\":\"" << (l == 0 ? "main" : "worker " + std::to_string(l)) << "\"}}";
+                first = false;
+                for (uint64_t i = written > EVENTS ? written - EVENTS : 0; i < written; ++i) {
+                    const Event& event = lanes[l].events[i % EVENTS]; // Oldest first. // Älteste zuerst.
+                    trace << ",\n{\"ph\":\"X\",\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << l
+                          << ",\"ts\":" << (event.begin - startTicks) * usPerTick << ",\"dur\":" << (event.end - event.begin) * usPerTick << "}";
+                    ++zones;
+                }
+            }
+            trace << "\n]}\n";
+            if (!trace) {
+                std::cerr << "Cannot write " << path << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            std::cout << "Wrote " << zones << " profiler zones to " << path << std::endl; // Status. // Status.
+            return true;
+        }
+
+    private:
+        Lane lanes[LANES]; // Fixed rings, never reallocated. // Feste Ringe, nie neu angelegt.
+        std::chrono::steady_clock::time_point startTime; // Wall clock at start. // Wanduhr beim Start.
+        uint64_t startTicks; // Ticks at start. // Ticks beim Start.
+
+        /// Lane of the calling thread
+        /// EN: Claims a free lane on first use and frees it when the thread ends; nullptr if none was free
+        /// DE: Belegt beim ersten Aufruf eine freie Spur und gibt sie am Thread-Ende frei; nullptr, wenn keine frei war
+        Lane* ThisLane() {
+            struct Claim {
+                Lane* lane = nullptr; // Claimed ring. // Belegter Ring.
+                bool tried = false; // Claim attempted once. // Belegung einmal versucht.
+                ~Claim() { if (lane) lane->claimed.store(false, std::memory_order_release); }
+            };
+            thread_local Claim claim; // Per-thread lane. // Spur pro Thread.
+            if (!claim.tried) {
+                claim.tried = true;
+                for (Lane& lane : lanes) {
+                    bool expected = false; // Free lane. // Freie Spur.
+                    if (lane.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) { claim.lane = &lane; break; }
+                }
+            }
+            return claim.lane;
+        }
+};
+
+FrameProfiler frameProfiler; // CPU zone recorder. // CPU-Zonen-Rekorder.
+
+/// Profile Zone Class
+/// EN: Times its scope and records it with the frame profiler
+/// DE: Misst seinen Gültigkeitsbereich und zeichnet ihn mit dem Frame-Profiler auf
+class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name) : name(name), begin(FrameProfiler::Ticks()) {}
+        ~ProfileZone() { frameProfiler.Record(name, begin, FrameProfiler::Ticks()); }
+    private:
+        const char* name; // Static zone name. // Statischer Zonenname.
+        uint64_t begin; // Ticks at scope entry. // Ticks beim Betreten.
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name) // Times the rest of the scope. // Misst den Rest des Gültigkeitsbereichs.
+#define PROFILE_WRITE_TRACE() frameProfiler.WriteTrace(traceFile) // Dumps the rings. // Schreibt die Ringe.
+#else
+#define PROFILE_ZONE(name) // Compiled out. // Wegkompiliert.
+#define PROFILE_WRITE_TRACE() ((void)0) // No zones to write. // Keine Zonen zu schreiben.
+#endif
+
+// Simulation phases measured by the hardware counters. // Von den Hardware-Zählern gemessene Simulationsphasen.
+enum PerfPhase { PERF_SUBSTEP, PERF_SUBSTEP_COLLISIONS, PERF_GRID_UPDATE, PERF_BVH_BUILD, PERF_PHASE_COUNT };
+const char* perfPhaseNames[PERF_PHASE_COUNT] = { "substep", "substep with collisions", "grid update", "bvh build" }; // Report names. // Berichtsnamen.
+const char* perfPhaseItems[PERF_PHASE_COUNT] = { "interactions", "interactions", "vertex-body pairs", "bodies" }; // Unit of work. // Arbeitseinheit.
+
+// Hardware events counted per phase. // Pro Phase gezählte Hardware-Ereignisse.
+enum PerfEvent { PERF_CYCLES, PERF_INSTRUCTIONS, PERF_L1D_MISSES, PERF_LLC_MISSES, PERF_BRANCH_MISSES, PERF_EVENT_COUNT };
+const char* perfEventNames[PERF_EVENT_COUNT] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" }; // JSON keys. // JSON-Schlüssel.
+
+/// Performance Counters Class
+/// 
+/// Opens cycles, instructions, L1 data and last-level cache read misses and branch misses with perf_event_open as one
+/// event group per thread, for the calling thread and each ParallelFor pool helper, so a phase boundary costs one read
+/// per thread. Each phase reads every thread's group before and after, scales it for multiplexing and accumulates the sum
+/// with its wall time and work items; because the helpers are idle once the phase's loops have returned, their share is
+/// complete at the closing read. Pool work that another thread (the trajectory writer) runs during a phase is counted in
+/// that phase. Report writes IPC and events per item as JSON. Linux only; an event the kernel refuses on any thread is
+/// reported as null while the others keep counting, and without any event (perf_event_paranoid, containers, other
+/// systems) only wall time is reported.
+/// 
+/// EN: Shows whether a phase is bound by memory, branches or arithmetic.
+/// DE: Zeigt, ob eine Phase durch Speicher, Verzweigungen oder Rechenleistung begrenzt ist.
+class PerfCounters {
+    public:
+        bool enabled = false; // Phases are measured. // Phasen werden gemessen.
+        bool hardware = false; // Counters opened. // Zähler geöffnet.
+
+        /// Reading of all counters
+        struct Sample {
+            double value[PERF_EVENT_COUNT] = {}; // Scaled counts. // Skalierte Zählwerte.
+            uint64_t ns = 0; // steady_clock time. // steady_clock-Zeit.
+        };
+
+        /// Starts counting
+        /// EN: Call from the thread that runs the phases; helpers are the kernel thread ids of the pool threads. Events that cannot be opened are marked unavailable
+        /// DE: Vom Thread aufrufen, der die Phasen ausführt; helpers sind die Kernel-Thread-IDs der Pool-Threads. Nicht zu öffnende Ereignisse werden als nicht verfügbar markiert
+        void Open(const std::vector<long>& helpers) {
+            enabled = true;
+            available.fill(false);
+#ifdef __linux__
+            std::vector<long> threads(1, 0); // 0 is the calling thread. // 0 ist der aufrufende Thread.
+            threads.insert(threads.end(), helpers.begin(), helpers.end());
+            auto cache = [](uint64_t level) { return level | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16); }; // Read-miss config. // Lesefehlgriff-Konfiguration.
+            const uint32_t types[PERF_EVENT_COUNT] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE };
+            const uint64_t configs[PERF_EVENT_COUNT] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, cache(PERF_COUNT_HW_CACHE_L1D), cache(PERF_COUNT_HW_CACHE_LL), PERF_COUNT_HW_BRANCH_MISSES };
+            available.fill(true);
+            for (long thread : threads) {
+                groups.emplace_back();
+                Group& group = groups.back(); // This thread's counters. // Die Zähler dieses Threads.
+                for (int event = 0; event < PERF_EVENT_COUNT; ++event) {
+                    if (!available[event]) continue; // Failed on an earlier thread. // Auf einem früheren Thread fehlgeschlagen.
+                    perf_event_attr attr{}; // Zeroed, including reserved fields. // Genullt, einschließlich reservierter Felder.
+                    attr.size = sizeof(attr);
+                    attr.type = types[event];
+                    attr.config = configs[event];
+                    attr.exclude_kernel = 1; // Allowed at perf_event_paranoid 2. // Bei perf_event_paranoid 2 erlaubt.
+                    attr.exclude_hv = 1;
+                    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING; // One read, multiplex scaling. // Ein read, Multiplex-Skalierung.
+                    int fd = (int)syscall(SYS_perf_event_open, &attr, (pid_t)thread, -1, group.fds.empty() ? -1 : group.fds[0], 0); // One thread, any CPU; first open event leads. // Ein Thread, jede CPU; erstes geöffnetes Ereignis führt.
+                    if (fd < 0) {
+                        std::cerr << "perf_event_open(" << perfEventNames[event] << ") failed: " << std::strerror(errno) << "; reporting it as null" << std::endl; // Warning. // Warnung.
+                        available[event] = false;
+                        continue;
+                    }
+                    group.position[event] = (int)group.fds.size();
+                    group.fds.push_back(fd);
+                }
+            }
+            hardware = std::find(available.begin(), available.end(), true) != available.end(); // Any event left. // Irgendein Ereignis übrig.
+            if (!hardware) {
+                std::cerr << "No hardware counters available; reporting wall time only" << std::endl; // Warning. // Warnung.
+                Close();
+            }
+#else
+            std::cerr << "Hardware counters need Linux perf_event_open; reporting wall time only" << std::endl; // Warning. // Warnung.
+#endif
+        }
+
+        /// Reads all counters now
+        /// EN: One group read per thread, summed over the threads; counts are scaled by enabled/running time when the kernel multiplexes the group
+        /// DE: Ein Gruppen-read pro Thread, über die Threads summiert; Zählwerte werden mit Aktiv-/Laufzeit skaliert, wenn der Kernel die Gruppe multiplext
+        Sample Read() const {
+            Sample sample; // Current values. // Aktuelle Werte.
+#ifdef __linux__
+            for (const Group& group : groups) {
+                if (group.fds.empty()) continue;
+                uint64_t data[3 + PERF_EVENT_COUNT] = {}; // Member count, time enabled, time running, values. // Mitgliederzahl, Aktivzeit, Laufzeit, Werte.
+                ssize_t bytes = (ssize_t)((3 + group.fds.size()) * sizeof(uint64_t)); // Expected group size. // Erwartete Gruppengröße.
+                if (read(group.fds[0], data, sizeof(data)) != bytes || data[2] == 0) continue;
+                double scale = double(data[1]) / double(data[2]); // Multiplex correction. // Multiplex-Korrektur.
+                for (int event = 0; event < PERF_EVENT_COUNT; ++event) {
+                    if (available[event] && group.position[event] >= 0) sample.value[event] += double(data[3 + group.position[event]]) * scale;
+                }
+            }
+#endif
+            sample.ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            return sample;
+        }
+
+        /// Adds one measured phase
+        /// EN: items is the work done, e.g. body interactions, used for the per-item figures
+        /// DE: items ist die geleistete Arbeit, z. B. Körper-Wechselwirkungen, für die Werte pro Element
+        void Add(int phase, const Sample& begin, const Sample& end, double items) {
+            Totals& total = totals[phase]; // Accumulator. // Akkumulator.
+            ++total.calls;
+            total.items += items;
+            total.ns += double(end.ns - begin.ns);
+            for (int event = 0; event < PERF_EVENT_COUNT; ++event) total.value[event] += std::max(0.0, end.value[event] - begin.value[event]);
+        }
+
+        /// Writes the JSON report
+        /// EN: Per phase: calls, wall time, items, raw counts, IPC and counts per item; counters are null if unavailable
+        /// DE: Pro Phase: Aufrufe, Laufzeit, Elemente, Rohzählwerte, IPC und Zählwerte pro Element; Zähler sind null, wenn nicht verfügbar
+        bool Report(const std::string& path) const {
+            std::ofstream json(path, std::ios::trunc); // Report file. // Berichtsdatei.
+            json << std::setprecision(10) << "{\n  \"hardware_counters\": " << (hardware ? "true" : "false") << ",\n  \"bodies\": " << objs.size() << ",\n  \"phases\": [\n";
+            bool first = true; // Comma handling. // Komma-Behandlung.
+            for (int phase = 0; phase < PERF_PHASE_COUNT; ++phase) {
+                const Totals& total = totals[phase]; // Phase sums. // Phasensummen.
+                if (total.calls == 0) continue;
+                double items = std::max(1.0, total.items); // Avoid division by zero. // Division durch Null vermeiden.
+                json << (first ? "" : ",\n") << "    {\n"
+                     << "      \"name\": \"" << perfPhaseNames[phase] << "\",\n"
+                     << "      \"calls\": " << total.calls << ",\n"
+                     << "      \"wall_ms\": " << total.ns / 1.0e6 << ",\n"
+                     << "      \"wall_ns_per_call\": " << total.ns / total.calls << ",\n"
+                     << "      \"item_unit\": \"" << perfPhaseItems[phase] << "\",\n"
+                     << "      \"items\": " << total.items << ",\n"
+                     << "      \"wall_ns_per_item\": " << total.ns / items << ",\n";
+                first = false;
+                if (!hardware) {
+                    json << "      \"ipc\": null\n    }";
+                    continue;
+                }
+                for (int event = 0; event < PERF_EVENT_COUNT; ++event) {
+                    if (!available[event]) {
+                        json << "      \"" << perfEventNames[event] << "\": null,\n"
+                             << "      \"" << perfEventNames[event] << "_per_item\": null,\n";
+                        continue;
+                    }
+                    json << "      \"" << perfEventNames[event] << "\": " << total.value[event] << ",\n"
+                         << "      \"" << perfEventNames[event] << "_per_item\": " << total.value[event] / items << ",\n";
+                }
+                json << "      \"ipc\": ";
+                if (available[PERF_CYCLES] && available[PERF_INSTRUCTIONS]) json << (total.value[PERF_CYCLES] > 0.0 ? total.value[PERF_INSTRUCTIONS] / total.value[PERF_CYCLES] : 0.0);
+                else json << "null";
+                json << "\n    }";
+            }
+            json << "\n  ]\n}\n";
+            if (!json) {
+                std::cerr << "Cannot write " << path << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            std::cout << "Wrote performance counter report to " << path << std::endl; // Status. // Status.
+            return true;
+        }
+
+        /// Closes the counters
+        /// EN: Totals stay available for Report
+        /// DE: Summen bleiben für Report verfügbar
+        void Close() {
+#ifdef __linux__
+            for (const Group& group : groups) {
+                for (int fd : group.fds) close(fd);
+            }
+#endif
+            groups.clear();
+            hardware = false;
+        }
+
+    private:
+        struct Totals {
+            uint64_t calls = 0; // Measured phases. // Gemessene Phasen.
+            double items = 0.0; // Work items. // Arbeitselemente.
+            double ns = 0.0; // Wall time. // Laufzeit.
+            double value[PERF_EVENT_COUNT] = {}; // Counter sums. // Zählersummen.
+        };
+        struct Group {
+            std::vector<int> fds; // Opened events, the leader first. // Geöffnete Ereignisse, der Anführer zuerst.
+            std::array<int, PERF_EVENT_COUNT> position = { -1, -1, -1, -1, -1 }; // Index in the group read, -1 if not open. // Index im Gruppen-read, -1 wenn nicht geöffnet.
+        };
+        Totals totals[PERF_PHASE_COUNT]; // Per phase. // Pro Phase.
+        std::vector<Group> groups; // Counter group per thread. // Zählergruppe pro Thread.
+        std::array<bool, PERF_EVENT_COUNT> available = {}; // Opened on every thread. // Auf jedem Thread geöffnet.
+};
+
+PerfCounters perfCounters; // Hardware counters per phase. // Hardware-Zähler pro Phase.
+std::string perfReportPath; // JSON report of --perf-counters, if any. // JSON-Bericht von --perf-counters, falls vorhanden.
+
+/// Perf Scope Class
+/// EN: Measures its scope as one phase when --perf-counters is on; costs one branch otherwise
+/// DE: Misst seinen Gültigkeitsbereich als eine Phase, wenn --perf-counters aktiv ist; kostet sonst eine Verzweigung
+class PerfScope {
+    public:
+        PerfScope(int phase, double items) : phase(phase), items(items) {
+            if (perfCounters.enabled) begin = perfCounters.Read();
+        }
+        ~PerfScope() {
+            if (perfCounters.enabled) perfCounters.Add(phase, begin, perfCounters.Read(), items);
+        }
+    private:
+        int phase; // PerfPhase. // PerfPhase.
+        double items; // Work of the scope. // Arbeit des Bereichs.
+        PerfCounters::Sample begin; // Counters at entry. // Zähler beim Betreten.
+};
+
+/// Bloom Renderer Class
+/// 
+/// Renders the scene into an HDR framebuffer and spreads pixels brighter than a threshold with a
+/// dual-filter (Kawase) pyramid that starts at half resolution. The cost depends only on the
+/// framebuffer size, not on how many bodies glow.
+/// 
+/// EN: Owns the HDR scene target, the bloom mip chain and the composite pass to the window.
+/// DE: Besitzt das HDR-Szenenziel, die Bloom-Mip-Kette und den Compositing-Pass ins Fenster.
+class BloomRenderer {
+    public:
+        static const int BLOOM_LEVELS = 5; // 1/2 down to 1/32 resolution. // 1/2 bis 1/32 Auflösung.
+        int width = 0, height = 0; // HDR scene size. // HDR-Szenengröße.
+        GLuint sceneFBO = 0, sceneColor = 0, sceneDepth = 0; // HDR scene target. // HDR-Szenenziel.
+        GLuint levelFBO[BLOOM_LEVELS] = {}, levelTexture[BLOOM_LEVELS] = {}; // Bloom pyramid. // Bloom-Pyramide.
+        int levelWidth[BLOOM_LEVELS] = {}, levelHeight[BLOOM_LEVELS] = {}; // Size of each level. // Größe jeder Stufe.
+        GLuint downsampleProgram = 0, upsampleProgram = 0, compositeProgram = 0; // Post-processing shaders. // Nachbearbeitungs-Shader.
+        GLuint fullscreenVAO = 0; // Empty VAO for attribute-less draws. // Leeres VAO für attributlose Zeichenaufrufe.
+        float threshold = 1.0f; // Only HDR values above 1.0 bloom. // Nur HDR-Werte über 1,0 leuchten.
+        float intensity = 0.8f; // Bloom strength in the composite. // Bloom-Stärke im Compositing.
+
+        /// Compiles post-processing shaders and allocates targets
+        /// EN: Must be called after the GL context exists
+        /// DE: Muss nach dem Erstellen des GL-Kontexts aufgerufen werden
+        void Init(int sceneWidth, int sceneHeight) {
+            downsampleProgram = LoadShaderProgram(fullscreenVertexShaderSource, bloomDownsampleFragmentSource); // Downsample shader. // Downsample-Shader.
+            upsampleProgram = LoadShaderProgram(fullscreenVertexShaderSource, bloomUpsampleFragmentSource); // Upsample shader. // Upsample-Shader.
+            compositeProgram = LoadShaderProgram(fullscreenVertexShaderSource, compositeFragmentSource); // Composite shader. // Compositing-Shader.
+            glGenVertexArrays(1, &fullscreenVAO); // Core profile needs a bound VAO. // Core-Profil benötigt ein gebundenes VAO.
+            Resize(sceneWidth, sceneHeight); // Allocate targets. // Ziele anlegen.
+        }
+
+        /// Creates a render texture
+        /// EN: Linear filtering and edge clamping, as needed for the bilinear bloom taps
+        /// DE: Lineare Filterung und Kantenbegrenzung, wie für die bilinearen Bloom-Abtastungen benötigt
+        static GLuint CreateTexture(GLenum internalFormat, int w, int h) {
+            GLuint texture; // Texture handle. // Textur-Handle.
+            glGenTextures(1, &texture); // Generate texture. // Generiere Textur.
+            glBindTexture(GL_TEXTURE_2D, texture); // Bind texture. // Binde Textur.
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w, h, 0, GL_RGBA, GL_FLOAT, nullptr); // Allocate storage. // Speicher anlegen.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // Bilinear minification. // Bilineare Verkleinerung.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); // Bilinear magnification. // Bilineare Vergrößerung.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // No wrap-around at edges. // Kein Umlauf an Rändern.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            return texture;
+        }
+
+        /// (Re)allocates the HDR target and the bloom pyramid
+        /// EN: Frees previous targets first; level 0 is half the scene size
+        /// DE: Gibt vorherige Ziele zuerst frei; Stufe 0 hat die halbe Szenengröße
+        void Resize(int sceneWidth, int sceneHeight) {
+            DestroyTargets(); // Free old targets. // Alte Ziele freigeben.
+            width = sceneWidth; height = sceneHeight;
+
+            sceneColor = CreateTexture(GL_RGBA16F, width, height); // HDR color. // HDR-Farbe.
+            glGenRenderbuffers(1, &sceneDepth); // Depth buffer. // Tiefenpuffer.
+            glBindRenderbuffer(GL_RENDERBUFFER, sceneDepth);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height); // Float depth for reversed-Z. // Float-Tiefe für Reversed-Z.
+            glGenFramebuffers(1, &sceneFBO); // Scene framebuffer. // Szenen-Framebuffer.
+            glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneColor, 0);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sceneDepth);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "HDR scene framebuffer incomplete." << std::endl; // Error message. // Fehlermeldung.
+            }
+
+            for (int level = 0; level < BLOOM_LEVELS; ++level) {
+                levelWidth[level] = std::max(width >> (level + 1), 1); // Halve per level. // Pro Stufe halbieren.
+                levelHeight[level] = std::max(height >> (level + 1), 1);
+                levelTexture[level] = CreateTexture(GL_R11F_G11F_B10F, levelWidth[level], levelHeight[level]); // Compact HDR format. // Kompaktes HDR-Format.
+                glGenFramebuffers(1, &levelFBO[level]);
+                glBindFramebuffer(GL_FRAMEBUFFER, levelFBO[level]);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, levelTexture[level], 0);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0); // Back to window. // Zurück zum Fenster.
+        }
+
+        /// Binds the HDR target for scene rendering
+        /// EN: Subsequent draws go into the HDR scene texture
+        /// DE: Nachfolgende Zeichenaufrufe gehen in die HDR-Szenentextur
+        void BeginScene() {
+            glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO); // Bind HDR target. // Binde HDR-Ziel.
+            glViewport(0, 0, width, height); // Full scene size. // Volle Szenengröße.
+        }
+
+        /// Runs one fullscreen pass
+        /// EN: Samples source into the bound target with the given texel size
+        /// DE: Tastet source in das gebundene Ziel mit der angegebenen Texelgröße ab
+        void FullscreenPass(GLuint program, GLuint source, int sourceWidth, int sourceHeight) {
+            glUseProgram(program); // Activate pass shader. // Aktiviere Pass-Shader.
+            glActiveTexture(GL_TEXTURE0); // Texture unit 0. // Textureinheit 0.
+            glBindTexture(GL_TEXTURE_2D, source); // Bind source. // Binde Quelle.
+            glUniform1i(glGetUniformLocation(program, "source"), 0);
+            glUniform2f(glGetUniformLocation(program, "texelSize"), 1.0f / sourceWidth, 1.0f / sourceHeight);
+            glBindVertexArray(fullscreenVAO); // Attribute-less draw. // Attributloser Zeichenaufruf.
+            glDrawArrays(GL_TRIANGLES, 0, 3); // One covering triangle. // Ein bedeckendes Dreieck.
+        }
+
+        /// Builds the bloom and composites it into the window
+        /// EN: Downsamples to 1/32, upsamples back to 1/2 with additive blending, then composites at window size
+        /// DE: Verkleinert auf 1/32, vergrößert mit additivem Blending zurück auf 1/2 und führt dann das Compositing in Fenstergröße durch
+        void Apply(int windowW, int windowH) {
+            glDisable(GL_DEPTH_TEST); // Fullscreen passes ignore depth. // Vollbild-Passes ignorieren Tiefe.
+            glDisable(GL_BLEND); // Downsample overwrites. // Downsampling überschreibt.
+
+            // Downsample chain with threshold on the first pass. // Downsample-Kette mit Schwelle im ersten Pass.
+            glUseProgram(downsampleProgram);
+            glUniform1f(glGetUniformLocation(downsampleProgram, "threshold"), threshold);
+            for (int level = 0; level < BLOOM_LEVELS; ++level) {
+                glBindFramebuffer(GL_FRAMEBUFFER, levelFBO[level]);
+                glViewport(0, 0, levelWidth[level], levelHeight[level]);
+                glUseProgram(downsampleProgram);
+                glUniform1i(glGetUniformLocation(downsampleProgram, "prefilter"), level == 0);
+                if (level == 0) FullscreenPass(downsampleProgram, sceneColor, width, height);
+                else FullscreenPass(downsampleProgram, levelTexture[level - 1], levelWidth[level - 1], levelHeight[level - 1]);
+            }
+
+            // Upsample chain, accumulating into larger levels. // Upsample-Kette, in größere Stufen akkumulierend.
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE); // Additive. // Additiv.
+            for (int level = BLOOM_LEVELS - 1; level > 0; --level) {
+                glBindFramebuffer(GL_FRAMEBUFFER, levelFBO[level - 1]);
+                glViewport(0, 0, levelWidth[level - 1], levelHeight[level - 1]);
+                FullscreenPass(upsampleProgram, levelTexture[level], levelWidth[level], levelHeight[level]);
+            }
+            glDisable(GL_BLEND);
+
+            // Composite into the window. // Compositing ins Fenster.
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, windowW, windowH);
+            glUseProgram(compositeProgram);
+            glActiveTexture(GL_TEXTURE1); // Bloom on unit 1. // Bloom auf Einheit 1.
+            glBindTexture(GL_TEXTURE_2D, levelTexture[0]);
+            glUniform1i(glGetUniformLocation(compositeProgram, "scene"), 0);
+            glUniform1i(glGetUniformLocation(compositeProgram, "bloom"), 1);
+            glUniform1f(glGetUniformLocation(compositeProgram, "bloomIntensity"), intensity);
+            glActiveTexture(GL_TEXTURE0); // Scene on unit 0. // Szene auf Einheit 0.
+            glBindTexture(GL_TEXTURE_2D, sceneColor);
+            glBindVertexArray(fullscreenVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 3); // Composite. // Compositing.
+            glBindVertexArray(0);
+
+            // Restore scene state. // Szenenzustand wiederherstellen.
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glEnable(GL_DEPTH_TEST);
+        }
+
+        /// Deletes render targets
+        /// EN: Called before reallocation and at shutdown
+        /// DE: Wird vor der Neuzuweisung und beim Beenden aufgerufen
+        void DestroyTargets() {
+            if (sceneFBO) glDeleteFramebuffers(1, &sceneFBO);
+            if (sceneColor) glDeleteTextures(1, &sceneColor);
+            if (sceneDepth) glDeleteRenderbuffers(1, &sceneDepth);
+            for (int level = 0; level < BLOOM_LEVELS; ++level) {
+                if (levelFBO[level]) glDeleteFramebuffers(1, &levelFBO[level]);
+                if (levelTexture[level]) glDeleteTextures(1, &levelTexture[level]);
+                levelFBO[level] = levelTexture[level] = 0;
+            }
+            sceneFBO = sceneColor = sceneDepth = 0;
+        }
+
+        /// Deletes all GL objects
+        /// EN: Targets, programs and the fullscreen VAO
+        /// DE: Ziele, Programme und das Vollbild-VAO
+        void Destroy() {
+            DestroyTargets();
+            glDeleteProgram(downsampleProgram);
+            glDeleteProgram(upsampleProgram);
+            glDeleteProgram(compositeProgram);
+            glDeleteVertexArrays(1, &fullscreenVAO);
+        }
+};
+
+BloomRenderer bloom; // HDR target and bloom chain. // HDR-Ziel und Bloom-Kette.
+
+/// Dynamic Resolution Class
+/// 
+/// Scales the size of the HDR scene target so the measured frame time stays near a budget.
+/// Fill cost grows with the pixel count, so the scale moves by the square root of the time ratio.
+/// The composite pass upsamples the scene to the window with bilinear filtering.
+/// 
+/// EN: Adjusts the render scale every few frames to hold a frame-time budget.
+/// DE: Passt den Render-Maßstab alle paar Frames an, um ein Frame-Zeit-Budget einzuhalten.
+class DynamicResolution {
+    public:
+        bool enabled = true; // Controller active (toggle with R). // Regler aktiv (umschalten mit R).
+        float scale = 1.0f; // Current render scale per axis. // Aktueller Render-Maßstab pro Achse.
+        float minScale = 0.5f, maxScale = 1.0f; // Allowed scale range. // Erlaubter Maßstabsbereich.
+        double targetMs = 1000.0 / 60.0; // Frame-time budget. // Frame-Zeit-Budget.
+        int interval = 15; // Samples averaged per decision. // Pro Entscheidung gemittelte Messwerte.
+        int settleSamples = 0; // Samples to skip after a change. // Nach einer Änderung zu überspringende Messwerte.
+        double accumulatedMs = 0.0; // Sum of samples in the interval. // Summe der Messwerte im Intervall.
+        int samples = 0; // Samples in the interval. // Messwerte im Intervall.
+
+        /// Feeds one frame-time sample
+        /// EN: Returns true when the scale changed and the scene target must be reallocated
+        /// DE: Gibt true zurück, wenn sich der Maßstab geändert hat und das Szenenziel neu angelegt werden muss
+        bool Update(double frameMs) {
+            if (!enabled) return false;
+            if (settleSamples > 0) { --settleSamples; return false; } // Wait for the new size to show in the timings. // Warten, bis die neue Größe in den Zeiten sichtbar ist.
+            accumulatedMs += frameMs;
+            if (++samples < interval) return false;
+            double averageMs = accumulatedMs / samples; // Mean frame time. // Mittlere Frame-Zeit.
+            accumulatedMs = 0.0; samples = 0;
+
+            // Hysteresis: shrink when over budget, grow only with clear headroom. // Hysterese: verkleinern bei Überschreitung, vergrößern nur mit deutlichem Spielraum.
+            if (averageMs < targetMs * 1.05 && averageMs > targetMs * 0.8) return false;
+            float wanted = scale * float(sqrt(targetMs / std::max(averageMs, 0.01))); // Pixel count scales with scale^2. // Pixelanzahl skaliert mit scale^2.
+            wanted = std::round(glm::clamp(wanted, minScale, maxScale) * 32.0f) / 32.0f; // Quantize to limit reallocations. // Quantisieren, um Neuzuweisungen zu begrenzen.
+            if (wanted == scale) return false;
+            scale = wanted;
+            settleSamples = GpuTimer::GPU_TIMER_LATENCY + 1; // Timings lag behind by the query latency. // Zeiten hinken um die Query-Latenz hinterher.
+            return true;
+        }
+
+        /// Returns the scaled size of one window dimension
+        /// EN: Never below one pixel
+        /// DE: Nie unter einem Pixel
+        int Scaled(int size) const {
+            return std::max(int(size * scale), 1);
+        }
+
+        /// Whether the scale can shrink or grow no further
+        /// EN: Also true while the controller is off; the quality governor only acts at these limits
+        /// DE: Auch wahr, solange der Regler aus ist; der Qualitätsregler handelt nur an diesen Grenzen
+        bool AtFloor() const { return !enabled || scale <= minScale; }
+        bool AtNative() const { return !enabled || scale >= maxScale; }
+};
+
+DynamicResolution dynamicResolution; // Render scale controller. // Render-Maßstabs-Regler.
+
+/// Quality Governor Class
+/// 
+/// Watches frame and physics step times and moves one knob per decision to keep a target frame rate.
+/// Over budget it first cuts substeps when physics dominates, then coarsens sphere LODs, then the grid.
+/// With clear headroom it restores them in reverse order. Dynamic resolution shares the budget and reacts
+/// first: the governor degrades only once the render scale is at its floor and restores only once it is back
+/// at native, so the two never pull on the same frames. Every decision is written to quality.log.
+/// 
+/// EN: Trades rendering and physics quality for frame rate within user-set bounds.
+/// DE: Tauscht Render- und Physikqualität gegen Bildrate innerhalb benutzerdefinierter Grenzen.
+class QualityGovernor {
+    public:
+        bool enabled = true; // Governor active (toggle with G). // Regler aktiv (umschalten mit G).
+        double targetMs = 1000.0 / 60.0; // Frame-time target. // Frame-Zeit-Ziel.
+        int minGridDivisions = 10, maxGridDivisions = 50; // Grid bounds. // Gittergrenzen.
+        float minLodBias = 0.25f, maxLodBias = 1.0f; // LOD bias bounds. // LOD-Bias-Grenzen.
+        int minSubsteps = 1, maxSubsteps = 4; // Substep bounds. // Teilschritt-Grenzen.
+        int interval = 30; // Frames averaged per decision. // Pro Entscheidung gemittelte Frames.
+        double accumulatedFrameMs = 0.0, accumulatedStepMs = 0.0; // Sums over the interval. // Summen über das Intervall.
+        int frames = 0; // Frames in the interval. // Frames im Intervall.
+        std::ofstream log; // Decision log. // Entscheidungs-Log.
+
+        /// Feeds one frame
+        /// EN: frameMs is the busy time of the frame, stepMs the part spent in physics; returns true if the grid must be rebuilt
+        /// DE: frameMs ist die Arbeitszeit des Frames, stepMs der Physik-Anteil; gibt true zurück, wenn das Gitter neu erstellt werden muss
+        bool Update(double frameMs, double stepMs) {
+            if (!enabled) return false;
+            accumulatedFrameMs += frameMs;
+            accumulatedStepMs += stepMs;
+            if (++frames < interval) return false;
+            double averageFrameMs = accumulatedFrameMs / frames; // Mean frame time. // Mittlere Frame-Zeit.
+            double averageStepMs = accumulatedStepMs / frames; // Mean step time. // Mittlere Schrittzeit.
+            accumulatedFrameMs = accumulatedStepMs = 0.0; frames = 0;
+
+            if (averageFrameMs > targetMs * 1.1 && dynamicResolution.AtFloor()) { // Over budget: degrade. // Über Budget: verschlechtern.
+                if (averageStepMs > averageFrameMs * 0.5 && substeps > minSubsteps) {
+                    Decide("substeps", substeps, substeps - 1, averageFrameMs, averageStepMs, substeps);
+                    return false;
+                }
+                if (lodBias > minLodBias) {
+                    Decide("lod bias", lodBias, std::max(lodBias * 0.8f, minLodBias), averageFrameMs, averageStepMs, lodBias);
+                    return false;
+                }
+                if (gridDivisions > minGridDivisions) {
+                    Decide("grid divisions", gridDivisions, std::max(gridDivisions - 5, minGridDivisions), averageFrameMs, averageStepMs, gridDivisions);
+                    return true;
+                }
+                if (substeps > minSubsteps) {
+                    Decide("substeps", substeps, substeps - 1, averageFrameMs, averageStepMs, substeps);
+                    return false;
+                }
+            } else if (averageFrameMs < targetMs * 0.7 && dynamicResolution.AtNative()) { // Clear headroom: restore. // Deutlicher Spielraum: wiederherstellen.
+                if (gridDivisions < maxGridDivisions) {
+                    Decide("grid divisions", gridDivisions, std::min(gridDivisions + 5, maxGridDivisions), averageFrameMs, averageStepMs, gridDivisions);
+                    return true;
+                }
+                if (lodBias < maxLodBias) {
+                    Decide("lod bias", lodBias, std::min(lodBias * 1.25f, maxLodBias), averageFrameMs, averageStepMs, lodBias);
+                    return false;
+                }
+                if (substeps < maxSubsteps) {
+                    Decide("substeps", substeps, substeps + 1, averageFrameMs, averageStepMs, substeps);
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        /// Applies and logs one decision
+        /// EN: Sets target to newValue and writes the decision to the log
+        /// DE: Setzt target auf newValue und schreibt die Entscheidung ins Log
+        template <typename T>
+        void Decide(const char* knob, T oldValue, T newValue, double frameMs, double stepMs, T& target) {
+            target = newValue; // Apply. // Anwenden.
+            log << std::fixed << std::setprecision(3) << glfwGetTime() << "s frame " << frameMs << " ms step " << stepMs
+                << " ms target " << targetMs << " ms: " << knob << " " << oldValue << " -> " << newValue << std::endl; // Log decision. // Entscheidung protokollieren.
+        }
+};
+
+QualityGovernor governor; // Quality governor. // Qualitätsregler.
+
+/// Body BVH Class
+/// 
+/// Bounding-volume hierarchy over the bounding spheres of all bodies, used for ray picking.
+/// Built top-down with a median split on the longest box axis; a ray only descends into boxes it enters,
+/// so a pick visits O(log N) nodes in spread-out scenes. The tree persists across frames: Update refits the
+/// boxes to the moved bodies in O(N) once per frame and rebuilds only when bodies were added or removed or the
+/// refitted boxes have grown too loose, so a click never pays for a build.
+/// 
+/// EN: Finds the nearest body hit by a ray without testing every body.
+/// DE: Findet den nächsten vom Strahl getroffenen Körper, ohne jeden Körper zu testen.
+class BodyBVH {
+    public:
+        struct Node {
+            glm::dvec3 boundsMin, boundsMax; // Box around all spheres below this node. // Box um alle Kugeln unter diesem Knoten.
+            int first, count; // Leaf: range in indices; inner node: first = left child, count = 0. // Blatt: Bereich in indices; innerer Knoten: first = linkes Kind, count = 0.
+        };
+        static const int LEAF_SIZE = 4; // Bodies per leaf. // Körper pro Blatt.
+        std::vector<Node> nodes; // Node 0 is the root. // Knoten 0 ist die Wurzel.
+        std::vector<int> indices; // Body indices in leaf order. // Körperindizes in Blattreihenfolge.
+        static constexpr double MAX_AREA_GROWTH = 2.0; // Rebuild once the refitted boxes are this much larger. // Neu aufbauen, sobald die angepassten Boxen so viel größer sind.
+
+        /// Builds the hierarchy
+        /// EN: Covers all bodies except the one being created
+        /// DE: Umfasst alle Körper außer dem gerade erstellten
+        void Build(const SlotMap<Object>& bodies) {
+            PROFILE_ZONE("bvh build");
+            PerfScope perfScope(PERF_BVH_BUILD, double(bodies.size()));
+            nodes.clear(); indices.clear();
+            for (int i = 0; i < (int)bodies.size(); ++i) {
+                if (!bodies[i].Initalizing) indices.push_back(i);
+            }
+            if (indices.empty()) return;
+            nodes.reserve(2 * indices.size() / LEAF_SIZE + 1); // Upper bound for median splits. // Obergrenze bei Median-Teilung.
+            nodes.push_back(Node{});
+            BuildNode(bodies, 0, 0, (int)indices.size());
+            builtArea = 0.0;
+            for (const Node& node : nodes) builtArea += SurfaceArea(node);
+        }
+
+        /// Follows the bodies after they moved
+        /// EN: Call once per frame; refits in O(N) and falls back to Build when the tree no longer covers exactly the placed bodies or has become too loose
+        /// DE: Einmal pro Frame aufrufen; passt in O(N) an und weicht auf Build aus, wenn der Baum nicht mehr genau die platzierten Körper umfasst oder zu locker geworden ist
+        void Update(const SlotMap<Object>& bodies) {
+            if (!Refit(bodies)) Build(bodies);
+        }
+
+        /// Casts a ray
+        /// EN: Returns the index of the nearest body hit by the ray, or -1; direction must be normalized
+        /// DE: Gibt den Index des nächsten vom Strahl getroffenen Körpers zurück, oder -1; direction muss normiert sein
+        int Pick(const SlotMap<Object>& bodies, const glm::dvec3& origin, const glm::dvec3& direction) const {
+            if (nodes.empty()) return -1;
+            glm::dvec3 inverse(1.0 / direction.x, 1.0 / direction.y, 1.0 / direction.z); // For slab tests. // Für Slab-Tests.
+            double nearest = std::numeric_limits<double>::infinity(); // Closest hit so far. // Bisher nächster Treffer.
+            int hit = -1; // Body index of that hit. // Körperindex dieses Treffers.
+            int stack[64]; // Depth is about log2(N / LEAF_SIZE). // Tiefe ist etwa log2(N / LEAF_SIZE).
+            int top = 0;
+            stack[top++] = 0;
+            while (top > 0) {
+                const Node& node = nodes[stack[--top]];
+                if (!HitsBox(node, origin, inverse, nearest)) continue; // Missed or farther than the best hit. // Verfehlt oder weiter als der beste Treffer.
+                if (node.count > 0) {
+                    for (int i = node.first; i < node.first + node.count; ++i) {
+                        if (indices[i] >= (int)bodies.size() || bodies[indices[i]].Initalizing) continue; // Changed since the last Update. // Seit dem letzten Update geändert.
+                        double t = HitSphere(bodies[indices[i]], origin, direction); // Distance along the ray. // Abstand entlang des Strahls.
+                        if (t < nearest) { nearest = t; hit = indices[i]; }
+                    }
+                } else {
+                    stack[top++] = node.first; // Left child. // Linkes Kind.
+                    stack[top++] = node.first + 1; // Right child. // Rechtes Kind.
+                }
+            }
+            return hit;
+        }
+
+    private:
+        double builtArea = 0.0; // Summed node surface area right after the last build. // Summierte Knotenoberfläche direkt nach dem letzten Aufbau.
+
+        /// Recomputes all boxes bottom-up
+        /// EN: Children always follow their parent in nodes, so one reverse pass suffices; returns false if a rebuild is needed
+        /// DE: Kinder folgen in nodes immer ihrem Elternknoten, daher genügt ein Rückwärtsdurchlauf; gibt false zurück, wenn ein Neuaufbau nötig ist
+        bool Refit(const SlotMap<Object>& bodies) {
+            if (nodes.empty()) return false;
+            size_t placed = 0; // Bodies the tree must cover. // Körper, die der Baum umfassen muss.
+            for (const Object& body : bodies) placed += body.Initalizing ? 0 : 1;
+            if (placed != indices.size()) return false; // Bodies added or removed. // Körper hinzugefügt oder entfernt.
+            for (int index : indices) {
+                if (index >= (int)bodies.size() || bodies[index].Initalizing) return false; // Dense indices moved. // Dichte Indizes verschoben.
+            }
+            PROFILE_ZONE("bvh refit");
+            const double inf = std::numeric_limits<double>::infinity();
+            double area = 0.0; // Summed surface area after the refit. // Summierte Oberfläche nach dem Anpassen.
+            for (int n = (int)nodes.size() - 1; n >= 0; --n) {
+                Node& node = nodes[n];
+                if (node.count > 0) {
+                    node.boundsMin = glm::dvec3(inf, inf, inf);
+                    node.boundsMax = glm::dvec3(-inf, -inf, -inf);
+                    for (int i = node.first; i < node.first + node.count; ++i) {
+                        const Object& body = bodies[indices[i]];
+                        for (int axis = 0; axis < 3; ++axis) {
+                            node.boundsMin[axis] = std::min(node.boundsMin[axis], body.position[axis] - body.radius);
+                            node.boundsMax[axis] = std::max(node.boundsMax[axis], body.position[axis] + body.radius);
+                        }
+                    }
+                } else {
+                    const Node& left = nodes[node.first]; // Children were refitted already. // Kinder wurden bereits angepasst.
+                    const Node& right = nodes[node.first + 1];
+                    node.boundsMin = glm::min(left.boundsMin, right.boundsMin);
+                    node.boundsMax = glm::max(left.boundsMax, right.boundsMax);
+                }
+                area += SurfaceArea(node);
+            }
+            return area <= builtArea * MAX_AREA_GROWTH; // Loose boxes make rays visit too many nodes. // Lockere Boxen lassen Strahlen zu viele Knoten besuchen.
+        }
+
+        /// Box surface area
+        /// EN: Proportional to the chance that a random ray enters the box
+        /// DE: Proportional zur Wahrscheinlichkeit, dass ein zufälliger Strahl die Box betritt
+        static double SurfaceArea(const Node& node) {
+            glm::dvec3 extent = node.boundsMax - node.boundsMin; // Box size. // Boxgröße.
+            return 2.0 * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        /// Builds one node and its subtree
+        /// EN: Bounds indices[begin, end) and splits at the median along the longest axis
+        /// DE: Umschließt indices[begin, end) und teilt am Median entlang der längsten Achse
+        void BuildNode(const SlotMap<Object>& bodies, int nodeIndex, int begin, int end) {
+            const double inf = std::numeric_limits<double>::infinity();
+            glm::dvec3 boundsMin(inf, inf, inf), boundsMax(-inf, -inf, -inf); // Empty box. // Leere Box.
+            for (int i = begin; i < end; ++i) {
+                const Object& body = bodies[indices[i]];
+                for (int axis = 0; axis < 3; ++axis) {
+                    boundsMin[axis] = std::min(boundsMin[axis], body.position[axis] - body.radius);
+                    boundsMax[axis] = std::max(boundsMax[axis], body.position[axis] + body.radius);
+                }
+            }
+            nodes[nodeIndex].boundsMin = boundsMin;
+            nodes[nodeIndex].boundsMax = boundsMax;
+            if (end - begin <= LEAF_SIZE) {
+                nodes[nodeIndex].first = begin; // Leaf. // Blatt.
+                nodes[nodeIndex].count = end - begin;
+                return;
+            }
+
+            glm::dvec3 extent = boundsMax - boundsMin; // Box size. // Boxgröße.
+            int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2); // Longest axis. // Längste Achse.
+            int middle = (begin + end) / 2; // Median split. // Median-Teilung.
+            std::nth_element(indices.begin() + begin, indices.begin() + middle, indices.begin() + end,
+                [&](int a, int b) { return bodies[a].position[axis] < bodies[b].position[axis]; });
+
+            int left = (int)nodes.size(); // Children are stored next to each other. // Kinder liegen nebeneinander.
+            nodes.push_back(Node{});
+            nodes.push_back(Node{});
+            nodes[nodeIndex].first = left;
+            nodes[nodeIndex].count = 0;
+            BuildNode(bodies, left, begin, middle);
+            BuildNode(bodies, left + 1, middle, end);
+        }
+
+        /// Ray-box slab test
+        /// EN: True if the ray enters the box before maxT
+        /// DE: True, wenn der Strahl die Box vor maxT betritt
+        static bool HitsBox(const Node& node, const glm::dvec3& origin, const glm::dvec3& inverse, double maxT) {
+            double tMin = 0.0, tMax = maxT; // Ray interval inside the box. // Strahlintervall innerhalb der Box.
+            for (int axis = 0; axis < 3; ++axis) {
+                double t0 = (node.boundsMin[axis] - origin[axis]) * inverse[axis];
+                double t1 = (node.boundsMax[axis] - origin[axis]) * inverse[axis];
+                if (t0 > t1) std::swap(t0, t1);
+                tMin = std::max(tMin, t0);
+                tMax = std::min(tMax, t1);
+                if (tMin > tMax) return false;
+            }
+            return true;
+        }
+
+        /// Ray-sphere test
+        /// EN: Distance to the first intersection in front of the origin, or infinity
+        /// DE: Abstand zum ersten Schnittpunkt vor dem Ursprung, oder Unendlich
+        static double HitSphere(const Object& body, const glm::dvec3& origin, const glm::dvec3& direction) {
+            glm::dvec3 toCenter = body.position - origin; // Origin to sphere center. // Ursprung zum Kugelmittelpunkt.
+            double along = glm::dot(toCenter, direction); // Projection onto the ray. // Projektion auf den Strahl.
+            double closest2 = glm::dot(toCenter, toCenter) - along * along; // Squared ray-center distance. // Quadrierter Strahl-Mittelpunkt-Abstand.
+            double radius2 = double(body.radius) * body.radius;
+            if (closest2 > radius2) return std::numeric_limits<double>::infinity(); // Miss. // Verfehlt.
+            double half = sqrt(radius2 - closest2); // Half chord length. // Halbe Sehnenlänge.
+            double t = along - half; // Entry point. // Eintrittspunkt.
+            if (t < 0.0) t = along + half; // Origin inside the sphere. // Ursprung innerhalb der Kugel.
+            return t >= 0.0 ? t : std::numeric_limits<double>::infinity();
+        }
+};
+
+BodyBVH bodyBVH; // Picking hierarchy, updated once per frame. // Picking-Hierarchie, einmal pro Frame aktualisiert.
+BodyHandle selectedBody; // Picked body, if any. // Gewählter Körper, falls vorhanden.
+
+/// Mapped File Class
+/// 
+/// Read-only memory mapping of a whole file. Opening costs no reads; the OS pages data in on first access,
+/// so large arrays are read at page-cache speed without copying through a stream.
+/// 
+/// EN: Maps a file into memory for reading.
+/// DE: Bildet eine Datei zum Lesen in den Speicher ab.
+class MappedFile {
+    public:
+        const unsigned char* data = nullptr; // First byte, page-aligned. // Erstes Byte, seitenausgerichtet.
+        size_t size = 0; // File size in bytes. // Dateigröße in Bytes.
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() { Close(); }
+
+        /// Maps a file
+        /// EN: Returns false if the file cannot be opened, mapped or is empty
+        /// DE: Gibt false zurück, wenn die Datei nicht geöffnet oder abgebildet werden kann oder leer ist
+        bool Open(const std::string& path) {
+            Close();
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER length; // File size. // Dateigröße.
+            if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) { Close(); return false; }
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) { Close(); return false; }
+            data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            size = (size_t)length.QuadPart;
+#else
+            fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat info; // File size. // Dateigröße.
+            if (fstat(fd, &info) != 0 || info.st_size == 0) { Close(); return false; }
+            void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) { Close(); return false; }
+            madvise(address, (size_t)info.st_size, MADV_WILLNEED); // Start read-ahead now. // Vorauslesen jetzt starten.
+            data = (const unsigned char*)address;
+            size = (size_t)info.st_size;
+#endif
+            if (!data) { Close(); return false; }
+            return true;
+        }
+
+        /// Unmaps the file
+        /// EN: Pointers into data become invalid
+        /// DE: Zeiger in data werden ungültig
+        void Close() {
+#ifdef _WIN32
+            if (data) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (data) munmap((void*)data, size);
+            if (fd >= 0) close(fd);
+            fd = -1;
+#endif
+            data = nullptr;
+            size = 0;
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE; // Open file. // Geöffnete Datei.
+        HANDLE mapping = nullptr; // File mapping object. // Datei-Mapping-Objekt.
+#else
+        int fd = -1; // Open file descriptor. // Geöffneter Dateideskriptor.
+#endif
+};
+
+/// Checkpoint file layout
+/// EN: A header followed by one 64-byte aligned array per body field (structure of arrays) in native byte order;
+///     the loader maps the file and reads the arrays in place, without parsing
+/// DE: Ein Header gefolgt von einem 64-Byte-ausgerichteten Array pro Körperfeld (Structure of Arrays) in nativer Byte-Reihenfolge;
+///     der Lader bildet die Datei ab und liest die Arrays direkt, ohne Parsen
+const char checkpointMagic[8] = { 'G', 'S', 'I', 'M', 'C', 'K', 'P', 'T' }; // File signature. // Dateisignatur.
+const uint32_t checkpointVersion = 1; // Bumped on every layout change. // Bei jeder Layoutänderung erhöht.
+const uint64_t checkpointAlignment = 64; // Array alignment in bytes (cache line). // Array-Ausrichtung in Bytes (Cache-Zeile).
+
+enum CheckpointArray {
+    CKPT_POS_X, CKPT_POS_Y, CKPT_POS_Z, // double, m. // double, m.
+    CKPT_VEL_X, CKPT_VEL_Y, CKPT_VEL_Z, // double, m/s. // double, m/s.
+    CKPT_MASS, CKPT_DENSITY, CKPT_RADIUS, // float, kg, kg/m^3, m. // float, kg, kg/m^3, m.
+    CKPT_COLOR, // vec4 RGBA. // vec4 RGBA.
+    CKPT_FLAGS, // uint32 CKPT_FLAG_* bits. // uint32 CKPT_FLAG_*-Bits.
+    CKPT_ARRAY_COUNT
+};
+const uint64_t checkpointElementSize[CKPT_ARRAY_COUNT] = { 8, 8, 8, 8, 8, 8, 4, 4, 4, 16, 4 }; // Bytes per body. // Bytes pro Körper.
+const uint32_t CKPT_FLAG_GLOW = 1; // Body glows. // Körper leuchtet.
+const uint32_t CKPT_FLAG_LAUNCHED = 2; // Body was spawned by the user. // Körper wurde vom Benutzer erzeugt.
+
+struct CheckpointHeader {
+    char magic[8]; // checkpointMagic. // checkpointMagic.
+    uint32_t version; // checkpointVersion. // checkpointVersion.
+    uint32_t headerSize; // sizeof(CheckpointHeader). // sizeof(CheckpointHeader).
+    uint64_t bodyCount; // Elements per array. // Elemente pro Array.
+    uint64_t stepCount; // Completed frames. // Abgeschlossene Frames.
+    double simTime; // Simulated seconds. // Simulierte Sekunden.
+    double timeStep; // Integrator step per frame in seconds. // Integratorschritt pro Frame in Sekunden.
+    uint32_t substeps; // Integrator substeps per frame. // Integrator-Teilschritte pro Frame.
+    uint32_t arrayCount; // CKPT_ARRAY_COUNT. // CKPT_ARRAY_COUNT.
+    uint64_t rngState[4]; // Random generator state; zero while no generator is in use. // Zustand des Zufallsgenerators; null, solange keiner benutzt wird.
+    uint64_t arrayOffset[CKPT_ARRAY_COUNT]; // Byte offset of each array from the file start. // Byte-Offset jedes Arrays vom Dateianfang.
+};
+
+/// Rounds up to a multiple of alignment
+/// EN: Used for array offsets in binary files
+/// DE: Wird für Array-Offsets in Binärdateien verwendet
+uint64_t AlignUp(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/// Worker Pool Class
+/// 
+/// Keeps hardware_concurrency() - 1 helper threads asleep on a condition variable between parallel loops, so a loop costs
+/// one wake-up instead of starting and joining a thread per helper. The helpers start with the first loop and live until
+/// exit. One loop runs at a time: a loop that another thread starts meanwhile (the trajectory writer's encoder, or the
+/// simulation while the writer encodes) runs on its calling thread alone instead of waiting, so stepping never blocks behind
+/// the writer; loops nested inside a running one do the same.
+/// 
+/// EN: Shares the cores between all parallel loops without creating threads per loop.
+/// DE: Teilt die Kerne zwischen allen parallelen Schleifen, ohne pro Schleife Threads zu erzeugen.
+class WorkerPool {
+    public:
+        /// Starts the helpers once
+        /// EN: Returns the helper count, 0 on a single core
+        /// DE: Gibt die Anzahl der Helfer zurück, 0 auf einem Kern
+        size_t Start() {
+            std::call_once(started, [this]() {
+                size_t helpers = std::max(1u, std::thread::hardware_concurrency()) - 1; // The caller is the last core. // Der Aufrufer ist der letzte Kern.
+                for (size_t i = 0; i < helpers; ++i) threads.emplace_back([this]() { WorkerLoop(); });
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [&]() { return threadIds.size() == helpers; }); // Every helper has its id. // Jeder Helfer hat seine ID.
+            });
+            return threads.size();
+        }
+
+        /// Kernel thread ids of the helpers
+        /// EN: Starts the pool; empty outside Linux. Used to open per-thread hardware counters
+        /// DE: Startet den Pool; außerhalb von Linux leer. Dient zum Öffnen von Hardware-Zählern pro Thread
+        std::vector<long> ThreadIds() {
+            Start();
+            std::lock_guard<std::mutex> lock(mutex);
+#ifdef __linux__
+            return threadIds;
+#else
+            return {};
+#endif
+        }
+
+        /// Runs a job on the calling thread and up to helpers pool threads
+        /// EN: Returns once every thread that joined has left the job, so context may live on the caller's stack
+        /// DE: Kehrt zurück, sobald jeder beigetretene Thread den Auftrag verlassen hat, daher darf context auf dem Stack des Aufrufers liegen
+        void Run(size_t helpers, void (*job)(void*), void* context) {
+            if (insideJob) { job(context); return; } // Nested loop. // Verschachtelte Schleife.
+            helpers = std::min(helpers, Start());
+            std::unique_lock<std::mutex> turn(submit, std::try_to_lock); // One loop at a time. // Eine Schleife zur Zeit.
+            if (!turn.owns_lock()) { job(context); return; } // Pool busy: serial, never wait. // Pool belegt: seriell, nie warten.
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current = job;
+                currentContext = context;
+                wanted = helpers;
+                joined = 0;
+                ++generation;
+            }
+            if (helpers > 0) wake.notify_all();
+            insideJob = true;
+            job(context);
+            insideJob = false;
+            std::unique_lock<std::mutex> lock(mutex);
+            wanted = joined; // Late helpers stay asleep. // Späte Helfer schlafen weiter.
+            done.wait(lock, [this]() { return running == 0; });
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& thread : threads) thread.join();
+        }
+
+    private:
+        std::once_flag started; // Helpers created. // Helfer erzeugt.
+        std::vector<std::thread> threads; // Helpers. // Helfer.
+        std::mutex submit; // Held for a whole loop. // Für eine ganze Schleife gehalten.
+        std::mutex mutex; // Guards the fields below. // Schützt die Felder darunter.
+        std::condition_variable wake, done; // New job; last helper left. // Neuer Auftrag; letzter Helfer fertig.
+        void (*current)(void*) = nullptr; // Job of the running loop. // Auftrag der laufenden Schleife.
+        void* currentContext = nullptr; // Its argument. // Sein Argument.
+        uint64_t generation = 0; // Loops started. // Gestartete Schleifen.
+        size_t wanted = 0, joined = 0, running = 0; // Helpers asked for, joined and still working. // Angeforderte, beigetretene und noch arbeitende Helfer.
+        std::vector<long> threadIds; // Kernel ids of started helpers (Linux). // Kernel-IDs gestarteter Helfer (Linux).
+        bool stopping = false; // Exit requested. // Beenden angefordert.
+        static inline thread_local bool insideJob = false; // This thread runs a job. // Dieser Thread führt einen Auftrag aus.
+
+        /// Helper thread body
+        /// EN: Sleeps until a loop wants another helper, runs the job once per loop
+        /// DE: Schläft, bis eine Schleife einen weiteren Helfer will, und führt den Auftrag einmal pro Schleife aus
+        void WorkerLoop() {
+            insideJob = true; // Loops started from a job run serially. // Aus einem Auftrag gestartete Schleifen laufen seriell.
+            uint64_t seen = 0; // Last loop joined. // Zuletzt beigetretene Schleife.
+            std::unique_lock<std::mutex> lock(mutex);
+#ifdef __linux__
+            threadIds.push_back((long)syscall(SYS_gettid));
+#else
+            threadIds.push_back(0); // Only counted. // Nur gezählt.
+#endif
+            done.notify_all();
+            for (;;) {
+                wake.wait(lock, [&]() { return stopping || (generation != seen && joined < wanted); });
+                if (stopping) return;
+                seen = generation;
+                ++joined;
+                ++running;
+                void (*job)(void*) = current; // Copied before unlocking. // Vor dem Entsperren kopiert.
+                void* context = currentContext;
+                lock.unlock();
+                job(context);
+                lock.lock();
+                if (--running == 0) done.notify_one();
+            }
+        }
+};
+
+WorkerPool workerPool; // Helpers of ParallelFor. // Helfer von ParallelFor.
+
+/// Runs a loop on all cores
+/// EN: Splits [0, count) into fixed chunks of grain items that the caller and the pool helpers claim in turn; chunk boundaries never depend on the thread count
+/// DE: Teilt [0, count) in feste Blöcke zu je grain Elementen, die der Aufrufer und die Pool-Helfer nacheinander übernehmen; Blockgrenzen hängen nie von der Thread-Anzahl ab
+template <typename Function>
+void ParallelFor(size_t count, size_t grain, Function&& function) {
+    size_t chunks = (count + grain - 1) / grain; // Work items. // Arbeitspakete.
+    std::atomic<size_t> next{0}; // Next unclaimed chunk. // Nächster freier Block.
+    auto worker = [&]() {
+        PROFILE_ZONE("parallel for"); // Busy time of each thread. // Arbeitszeit jedes Threads.
+        for (size_t chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+            function(chunk * grain, std::min(count, (chunk + 1) * grain));
+        }
+    };
+    if (chunks <= 1) { worker(); return; } // Nothing to share. // Nichts zu teilen.
+    workerPool.Run(chunks - 1, [](void* context) { (*static_cast<decltype(worker)*>(context))(); }, &worker); // Never more helpers than spare chunks. // Nie mehr Helfer als übrige Blöcke.
+}
+
+/// Serializes the simulation state
+/// EN: Copies all placed bodies and the run state into a checkpoint image; bodies still being created are skipped
+/// DE: Kopiert alle platzierten Körper und den Laufzustand in ein Checkpoint-Abbild; Körper in Erstellung werden übersprungen
+std::vector<unsigned char> BuildCheckpointImage(const SlotMap<Object>& bodies) {
+    uint64_t count = 0; // Bodies to save. // Zu speichernde Körper.
+    for (const Object& body : bodies) count += body.Initalizing ? 0 : 1;
+
+    CheckpointHeader header{}; // Zeroed, including reserved fields. // Genullt, einschließlich reservierter Felder.
+    std::memcpy(header.magic, checkpointMagic, sizeof(header.magic));
+    header.version = checkpointVersion;
+    header.headerSize = sizeof(CheckpointHeader);
+    header.bodyCount = count;
+    header.stepCount = stepCount;
+    header.simTime = simTime;
+    header.timeStep = simTimeStep;
+    header.substeps = (uint32_t)substeps;
+    header.arrayCount = CKPT_ARRAY_COUNT;
+    uint64_t offset = AlignUp(sizeof(CheckpointHeader), checkpointAlignment); // Next free byte. // Nächstes freies Byte.
+    for (int array = 0; array < CKPT_ARRAY_COUNT; ++array) {
+        header.arrayOffset[array] = offset;
+        offset = AlignUp(offset + count * checkpointElementSize[array], checkpointAlignment);
+    }
+
+    std::vector<unsigned char> image(offset); // Zero padding between arrays. // Null-Auffüllung zwischen Arrays.
+    std::memcpy(image.data(), &header, sizeof(CheckpointHeader));
+    auto column = [&](int array) { return image.data() + header.arrayOffset[array]; };
+    double* posX = (double*)column(CKPT_POS_X); double* posY = (double*)column(CKPT_POS_Y); double* posZ = (double*)column(CKPT_POS_Z);
+    double* velX = (double*)column(CKPT_VEL_X); double* velY = (double*)column(CKPT_VEL_Y); double* velZ = (double*)column(CKPT_VEL_Z);
+    float* mass = (float*)column(CKPT_MASS); float* density = (float*)column(CKPT_DENSITY); float* radius = (float*)column(CKPT_RADIUS);
+    glm::vec4* color = (glm::vec4*)column(CKPT_COLOR);
+    uint32_t* flags = (uint32_t*)column(CKPT_FLAGS);
+    size_t i = 0; // Output index. // Ausgabeindex.
+    for (const Object& body : bodies) {
+        if (body.Initalizing) continue; // Not part of the run yet. // Noch nicht Teil des Laufs.
+        posX[i] = body.position.x; posY[i] = body.position.y; posZ[i] = body.position.z;
+        velX[i] = body.velocity.x; velY[i] = body.velocity.y; velZ[i] = body.velocity.z;
+        mass[i] = body.mass; density[i] = body.density; radius[i] = body.radius;
+        color[i] = body.color;
+        flags[i] = (body.glow ? CKPT_FLAG_GLOW : 0) | (body.Launched ? CKPT_FLAG_LAUNCHED : 0);
+        ++i;
+    }
+    return image;
+}
+
+/// Writes a file atomically
+/// EN: Writes to path.tmp and renames it over path, so a crash never leaves a half-written file behind
+/// DE: Schreibt nach path.tmp und benennt es in path um, sodass ein Absturz nie eine halb geschriebene Datei hinterlässt
+bool WriteFileReplacing(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::string temporary = path + ".tmp"; // Staging file. // Zwischendatei.
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write((const char*)bytes.data(), (std::streamsize)bytes.size()); // One sequential write. // Ein sequentieller Schreibvorgang.
+        if (!file) {
+            std::cerr << "Failed to write " << temporary << std::endl; // Error message. // Fehlermeldung.
+            return false;
+        }
+    }
+    std::error_code error; // Rename result. // Umbenennungsergebnis.
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::cerr << "Failed to replace " << path << ": " << error.message() << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    return true;
+}
+
+/// Checkpoint Writer Class
+/// 
+/// Takes the snapshot on the simulation thread (a linear copy into the SoA image) and hands the file write
+/// to a background thread, so stepping never waits for the disk. At most one write is in flight;
+/// a save requested while the previous one is still running is skipped.
+/// 
+/// EN: Saves checkpoints without blocking the simulation.
+/// DE: Speichert Checkpoints, ohne die Simulation zu blockieren.
+class CheckpointWriter {
+    public:
+        /// Starts saving a checkpoint
+        /// EN: Returns false if the previous checkpoint is still being written
+        /// DE: Gibt false zurück, wenn der vorherige Checkpoint noch geschrieben wird
+        bool Save(const std::string& path, const SlotMap<Object>& bodies) {
+            if (busy.load(std::memory_order_acquire)) {
+                std::cerr << "Checkpoint write still in progress, skipped." << std::endl; // Warning. // Warnung.
+                return false;
+            }
+            if (worker.joinable()) worker.join(); // Already finished; reclaim the thread. // Bereits fertig; Thread zurückholen.
+            std::vector<unsigned char> image = BuildCheckpointImage(bodies); // Consistent state at the step boundary. // Konsistenter Zustand an der Schrittgrenze.
+            busy.store(true, std::memory_order_release);
+            worker = std::thread([this, path](std::vector<unsigned char> bytes) {
+                if (WriteFileReplacing(path, bytes)) {
+                    std::cout << "Checkpoint saved: " << path << " (" << bytes.size() << " bytes)" << std::endl; // Confirmation. // Bestätigung.
+                }
+                busy.store(false, std::memory_order_release);
+            }, std::move(image));
+            return true;
+        }
+
+        /// Waits for the pending write
+        /// EN: Called on exit so the last checkpoint is complete
+        /// DE: Wird beim Beenden aufgerufen, damit der letzte Checkpoint vollständig ist
+        ~CheckpointWriter() {
+            if (worker.joinable()) worker.join();
+        }
+
+    private:
+        std::thread worker; // Background writer. // Hintergrund-Schreiber.
+        std::atomic<bool> busy{false}; // A write is in flight. // Ein Schreibvorgang läuft.
+};
+
+CheckpointWriter checkpointWriter; // Background checkpoint writer. // Hintergrund-Checkpoint-Schreiber.
+
+/// Restores a checkpoint
+/// EN: Maps the file, validates header and array bounds, then rebuilds objs straight from the mapped arrays; returns false on error
+/// DE: Bildet die Datei ab, prüft Header und Array-Grenzen und baut objs direkt aus den abgebildeten Arrays neu auf; gibt bei Fehler false zurück
+bool LoadCheckpoint(const std::string& path) {
+    MappedFile file; // Unmapped when done. // Wird am Ende freigegeben.
+    if (!file.Open(path)) {
+        std::cerr << "Cannot open checkpoint: " << path << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    CheckpointHeader header; // Copy of the file header. // Kopie des Datei-Headers.
+    if (file.size < sizeof(CheckpointHeader)) {
+        std::cerr << "Checkpoint too small: " << path << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    std::memcpy(&header, file.data, sizeof(CheckpointHeader));
+    if (std::memcmp(header.magic, checkpointMagic, sizeof(header.magic)) != 0 || header.version != checkpointVersion
+        || header.headerSize != sizeof(CheckpointHeader) || header.arrayCount != CKPT_ARRAY_COUNT) {
+        std::cerr << "Not a version " << checkpointVersion << " checkpoint: " << path << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    for (int array = 0; array < CKPT_ARRAY_COUNT; ++array) {
+        uint64_t offset = header.arrayOffset[array]; // Array start. // Array-Anfang.
+        if (offset % checkpointAlignment != 0 || offset > file.size || (file.size - offset) / checkpointElementSize[array] < header.bodyCount) {
+            std::cerr << "Truncated or corrupt checkpoint: " << path << std::endl; // Error message. // Fehlermeldung.
+            return false;
+        }
+    }
+
+    auto column = [&](int array) { return file.data + header.arrayOffset[array]; };
+    const double* posX = (const double*)column(CKPT_POS_X); const double* posY = (const double*)column(CKPT_POS_Y); const double* posZ = (const double*)column(CKPT_POS_Z);
+    const double* velX = (const double*)column(CKPT_VEL_X); const double* velY = (const double*)column(CKPT_VEL_Y); const double* velZ = (const double*)column(CKPT_VEL_Z);
+    const float* mass = (const float*)column(CKPT_MASS); const float* density = (const float*)column(CKPT_DENSITY); const float* radius = (const float*)column(CKPT_RADIUS);
+    const glm::vec4* color = (const glm::vec4*)column(CKPT_COLOR);
+    const uint32_t* flags = (const uint32_t*)column(CKPT_FLAGS);
+
+    objs = SlotMap<Object>(); // Drop the current run; old handles become invalid. // Aktuellen Lauf verwerfen; alte Handles werden ungültig.
+    objs.reserve(header.bodyCount + 1024); // Room for user-spawned bodies. // Platz für vom Benutzer erzeugte Körper.
+    for (uint64_t i = 0; i < header.bodyCount; ++i) {
+        objs.Insert(Object(glm::dvec3(posX[i], posY[i], posZ[i]), glm::dvec3(velX[i], velY[i], velZ[i]), mass[i], density[i], color[i], (flags[i] & CKPT_FLAG_GLOW) != 0));
+        Object& body = objs[i];
+        body.radius = radius[i]; // Bit-exact restore. // Bitgenaue Wiederherstellung.
+        body.Launched = (flags[i] & CKPT_FLAG_LAUNCHED) != 0;
+    }
+    creatingBody = BodyHandle{};
+    selectedBody = BodyHandle{};
+    simTime = header.simTime;
+    stepCount = header.stepCount;
+    simTimeStep = header.timeStep;
+    substeps = glm::clamp((int)header.substeps, governor.minSubsteps, governor.maxSubsteps); // Respect the configured bounds. // Konfigurierte Grenzen einhalten.
+    std::cout << "Checkpoint loaded: " << path << " (" << header.bodyCount << " bodies, t = " << simTime << " s)" << std::endl; // Confirmation. // Bestätigung.
+    return true;
+}
+
+/// Scenario file layout
+/// EN: Hand-written scenes are line-based text with settings and "body" lines of keyword fields; bulk scenes are CSV with one body per line
+///     (x,y,z,vx,vy,vz,mass[,density[,r,g,b[,a[,glow]]]] in SI units, an optional header line and # comments) or binary checkpoints.
+///     Numbers are read with from_chars straight from the mapped file; CSV is split into line-aligned chunks that are parsed on all cores
+/// DE: Handgeschriebene Szenen sind zeilenbasierter Text mit Einstellungen und "body"-Zeilen aus Schlüsselwortfeldern; Massenszenen sind CSV mit einem Körper pro Zeile
+///     (x,y,z,vx,vy,vz,mass[,density[,r,g,b[,a[,glow]]]] in SI-Einheiten, optionaler Kopfzeile und #-Kommentaren) oder binäre Checkpoints.
+///     Zahlen werden mit from_chars direkt aus der abgebildeten Datei gelesen; CSV wird in zeilenausgerichtete Blöcke geteilt, die auf allen Kernen geparst werden
+const size_t SCENARIO_CHUNK_BYTES = 4 << 20; // CSV bytes per parse task. // CSV-Bytes pro Parse-Aufgabe.
+const int SCENARIO_MAX_COLUMNS = 13; // x..mass, density, r, g, b, a, glow. // x..mass, density, r, g, b, a, glow.
+
+/// Scenario bodies in structure-of-arrays form
+/// EN: Filled by the parsers before the current run is replaced, so a bad file leaves the run untouched
+/// DE: Von den Parsern gefüllt, bevor der aktuelle Lauf ersetzt wird, sodass eine fehlerhafte Datei den Lauf unberührt lässt
+struct ScenarioBodies {
+    std::vector<double> position[3]; // m. // m.
+    std::vector<double> velocity[3]; // m/s. // m/s.
+    std::vector<float> mass; // kg. // kg.
+    std::vector<float> density; // kg/m^3. // kg/m^3.
+    std::vector<glm::vec4> color; // RGBA. // RGBA.
+    std::vector<uint8_t> glow; // Body glows. // Körper leuchtet.
+
+    size_t size() const { return mass.size(); }
+    void resize(size_t n) {
+        for (int c = 0; c < 3; ++c) { position[c].resize(n); velocity[c].resize(n); }
+        mass.resize(n); density.resize(n); color.resize(n); glow.resize(n);
+    }
+    void reserve(size_t n) {
+        for (int c = 0; c < 3; ++c) { position[c].reserve(n); velocity[c].reserve(n); }
+        mass.reserve(n); density.reserve(n); color.reserve(n); glow.reserve(n);
+    }
+
+    /// Appends one CSV row
+    /// EN: values holds 7 to SCENARIO_MAX_COLUMNS columns; missing ones take the Object defaults
+    /// DE: values enthält 7 bis SCENARIO_MAX_COLUMNS Spalten; fehlende erhalten die Object-Standardwerte
+    void Append(const double* values, int columns) {
+        for (int c = 0; c < 3; ++c) { position[c].push_back(values[c]); velocity[c].push_back(values[3 + c]); }
+        mass.push_back((float)values[6]);
+        density.push_back(columns > 7 ? (float)values[7] : 3344.0f);
+        glm::vec4 rgba(1.0f, 0.0f, 0.0f, 1.0f); // Object default. // Object-Standard.
+        for (int c = 0; c < 4 && 8 + c < columns; ++c) rgba[c] = (float)values[8 + c];
+        color.push_back(rgba);
+        glow.push_back(columns > 12 && values[12] != 0.0 ? 1 : 0);
+    }
+
+    /// Writes one body in place
+    /// EN: Used by the generators, which fill disjoint index ranges from several threads
+    /// DE: Von den Generatoren verwendet, die disjunkte Indexbereiche aus mehreren Threads füllen
+    void Set(size_t i, glm::dvec3 p, glm::dvec3 v, double m, float rho, glm::vec4 rgba, bool glowing = false) {
+        for (int c = 0; c < 3; ++c) { position[c][i] = p[c]; velocity[c][i] = v[c]; }
+        mass[i] = (float)m; density[i] = rho; color[i] = rgba; glow[i] = glowing ? 1 : 0;
+    }
+};
+
+/// Parsed scenario
+/// EN: Bodies plus the run settings a text scene may override
+/// DE: Körper plus die Laufeinstellungen, die eine Textszene überschreiben kann
+struct Scenario {
+    ScenarioBodies bodies; // Initial bodies. // Anfangskörper.
+    double timeStep = simTimeStep; // Simulated seconds per frame. // Simulierte Sekunden pro Frame.
+    int substeps = ::substeps; // Physics substeps per frame. // Physik-Teilschritte pro Frame.
+    glm::dvec3 camera = cameraPos; // Initial camera position. // Anfängliche Kameraposition.
+};
+
+/// Reads one number
+/// EN: Skips blanks, parses a double at p and advances p past it; returns false if there is none
+/// DE: Überspringt Leerzeichen, parst ein double bei p und rückt p dahinter; gibt false zurück, wenn keines vorhanden ist
+bool ParseScenarioNumber(const char*& p, const char* end, double& value) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    if (p < end && *p == '+') ++p; // from_chars rejects a leading plus. // from_chars lehnt ein führendes Plus ab.
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+/// Parses one CSV chunk
+/// EN: [begin, end) holds whole lines; returns false and the offending line if a row cannot be read
+/// DE: [begin, end) enthält ganze Zeilen; gibt false und die fehlerhafte Zeile zurück, wenn eine Zeile nicht gelesen werden kann
+bool ParseScenarioCsv(const char* begin, const char* end, bool fileStart, ScenarioBodies& out, std::string& badLine) {
+    out.reserve((end - begin) / 64); // Typical row length. // Typische Zeilenlänge.
+    double values[SCENARIO_MAX_COLUMNS]; // Columns of the current row. // Spalten der aktuellen Zeile.
+    for (const char* line = begin; line < end; ) {
+        const char* lineEnd = (const char*)std::memchr(line, '\n', end - line); // End of this row. // Ende dieser Zeile.
+        if (!lineEnd) lineEnd = end;
+        const char* p = line; // Read position. // Leseposition.
+        while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        if (p < lineEnd && *p != '#') {
+            int columns = 0; // Columns read. // Gelesene Spalten.
+            bool ok = true; // Row is well-formed. // Zeile ist wohlgeformt.
+            while (ok && columns < SCENARIO_MAX_COLUMNS) {
+                ok = ParseScenarioNumber(p, lineEnd, values[columns]);
+                if (!ok) break;
+                ++columns;
+                while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+                if (p == lineEnd) break;
+                ok = *p++ == ',';
+            }
+            ok = ok && columns >= 7 && p == lineEnd;
+            if (ok) {
+                out.Append(values, columns);
+            } else if (!(fileStart && line == begin)) { // The first line may be a header. // Die erste Zeile darf eine Kopfzeile sein.
+                badLine.assign(line, std::min<size_t>(lineEnd - line, 80));
+                return false;
+            }
+        }
+        line = lineEnd + 1;
+    }
+    return true;
+}
+
+/// Parses a CSV scenario on all cores
+/// EN: Chunk boundaries are moved to the next line start, so every chunk parses independently; chunks are concatenated in file order
+/// DE: Blockgrenzen werden zum nächsten Zeilenanfang verschoben, sodass jeder Block unabhängig geparst wird; Blöcke werden in Dateireihenfolge verkettet
+bool ParseScenarioCsvFile(const MappedFile& file, const std::string& path, Scenario& scenario) {
+    const char* text = (const char*)file.data; // File contents. // Dateiinhalt.
+    const char* end = text + file.size;
+    std::vector<const char*> starts; // Chunk starts, plus the end. // Blockanfänge, plus das Ende.
+    for (const char* p = text; p < end; ) {
+        starts.push_back(p);
+        if ((size_t)(end - p) <= SCENARIO_CHUNK_BYTES) break;
+        const char* next = (const char*)std::memchr(p + SCENARIO_CHUNK_BYTES, '\n', end - p - SCENARIO_CHUNK_BYTES); // Line after the chunk. // Zeile nach dem Block.
+        p = next ? next + 1 : end;
+    }
+    starts.push_back(end);
+
+    size_t chunks = starts.size() - 1; // Parse tasks. // Parse-Aufgaben.
+    std::vector<ScenarioBodies> parts(chunks); // Bodies per chunk. // Körper pro Block.
+    std::vector<std::string> errors(chunks); // First bad line per chunk. // Erste fehlerhafte Zeile pro Block.
+    ParallelFor(chunks, 1, [&](size_t begin, size_t stop) {
+        for (size_t chunk = begin; chunk < stop; ++chunk) ParseScenarioCsv(starts[chunk], starts[chunk + 1], chunk == 0, parts[chunk], errors[chunk]);
+    });
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << "Bad scenario row in " << path << ": " << error << std::endl; // Error message. // Fehlermeldung.
+            return false;
+        }
+    }
+
+    size_t total = 0; // Bodies in the file. // Körper in der Datei.
+    for (const ScenarioBodies& part : parts) total += part.size();
+    ScenarioBodies& out = scenario.bodies;
+    out.reserve(total);
+    for (const ScenarioBodies& part : parts) {
+        for (int c = 0; c < 3; ++c) {
+            out.position[c].insert(out.position[c].end(), part.position[c].begin(), part.position[c].end());
+            out.velocity[c].insert(out.velocity[c].end(), part.velocity[c].begin(), part.velocity[c].end());
+        }
+        out.mass.insert(out.mass.end(), part.mass.begin(), part.mass.end());
+        out.density.insert(out.density.end(), part.density.begin(), part.density.end());
+        out.color.insert(out.color.end(), part.color.begin(), part.color.end());
+        out.glow.insert(out.glow.end(), part.glow.begin(), part.glow.end());
+    }
+    return true;
+}
+
+/// Parses a text scenario
+/// EN: One statement per line, # starts a comment:
+///     timestep SECONDS | substeps N | camera X Y Z |
+///     body pos X Y Z [vel VX VY VZ] mass KG [density KG_M3] [color R G B [A]] [glow]
+/// DE: Eine Anweisung pro Zeile, # beginnt einen Kommentar:
+///     timestep SEKUNDEN | substeps N | camera X Y Z |
+///     body pos X Y Z [vel VX VY VZ] mass KG [density KG_M3] [color R G B [A]] [glow]
+bool ParseScenarioTextFile(const MappedFile& file, const std::string& path, Scenario& scenario) {
+    const char* text = (const char*)file.data; // File contents. // Dateiinhalt.
+    const char* end = text + file.size;
+    int lineNumber = 0; // For error messages. // Für Fehlermeldungen.
+    for (const char* line = text; line < end; ) {
+        const char* lineEnd = (const char*)std::memchr(line, '\n', end - line); // End of this line. // Ende dieser Zeile.
+        if (!lineEnd) lineEnd = end;
+        const char* commentStart = (const char*)std::memchr(line, '#', lineEnd - line); // Ignore from here. // Ab hier ignorieren.
+        const char* stop = commentStart ? commentStart : lineEnd;
+        const char* lineStart = line; // For error messages. // Für Fehlermeldungen.
+        const char* p = line; // Read position. // Leseposition.
+        ++lineNumber;
+        line = lineEnd + 1;
+
+        auto word = [&]() { // Next blank-separated word. // Nächstes durch Leerzeichen getrenntes Wort.
+            while (p < stop && std::isspace((unsigned char)*p)) ++p;
+            const char* start = p;
+            while (p < stop && !std::isspace((unsigned char)*p)) ++p;
+            return std::string(start, p);
+        };
+        auto numbers = [&](double* values, int count) { // count numbers in a row. // count Zahlen hintereinander.
+            for (int i = 0; i < count; ++i) {
+                while (p < stop && std::isspace((unsigned char)*p)) ++p;
+                if (!ParseScenarioNumber(p, stop, values[i])) return false;
+            }
+            return true;
+        };
+
+        std::string statement = word(); // Leading keyword. // Führendes Schlüsselwort.
+        bool ok = true; // Statement is well-formed. // Anweisung ist wohlgeformt.
+        double values[SCENARIO_MAX_COLUMNS] = {}; // Numbers of the statement. // Zahlen der Anweisung.
+        if (statement.empty()) {
+            continue;
+        } else if (statement == "timestep") {
+            ok = numbers(values, 1) && values[0] > 0.0;
+            scenario.timeStep = values[0];
+        } else if (statement == "substeps") {
+            ok = numbers(values, 1) && values[0] >= 1.0;
+            scenario.substeps = (int)values[0];
+        } else if (statement == "camera") {
+            ok = numbers(values, 3);
+            scenario.camera = glm::dvec3(values[0], values[1], values[2]);
+        } else if (statement == "body") {
+            bool hasPosition = false, hasMass = false; // Required fields. // Pflichtfelder.
+            values[7] = 3344.0; // Object default density. // Object-Standarddichte.
+            values[8] = 1.0; values[11] = 1.0; // Object default color. // Object-Standardfarbe.
+            for (std::string field = word(); ok && !field.empty(); field = word()) {
+                if (field == "pos") { ok = numbers(values, 3); hasPosition = true; }
+                else if (field == "vel") ok = numbers(values + 3, 3);
+                else if (field == "mass") { ok = numbers(values + 6, 1); hasMass = true; }
+                else if (field == "density") ok = numbers(values + 7, 1);
+                else if (field == "color") {
+                    ok = numbers(values + 8, 3);
+                    const char* before = p; // Alpha is optional. // Alpha ist optional.
+                    if (ok && !numbers(values + 11, 1)) { p = before; values[11] = 1.0; }
+                }
+                else if (field == "glow") values[12] = 1.0;
+                else ok = false;
+            }
+            ok = ok && hasPosition && hasMass;
+            if (ok) scenario.bodies.Append(values, SCENARIO_MAX_COLUMNS);
+        } else {
+            ok = false;
+        }
+        if (ok && !word().empty()) ok = false; // Trailing garbage. // Überzählige Zeichen.
+        if (!ok) {
+            std::cerr << "Bad scenario statement in " << path << " line " << lineNumber << ": " << std::string(lineStart, std::min<size_t>(stop - lineStart, 80)) << std::endl; // Error message. // Fehlermeldung.
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Starts a new run from a scenario
+/// EN: Replaces objs with the scenario bodies and resets the run clock
+/// DE: Ersetzt objs durch die Szenario-Körper und setzt die Laufuhr zurück
+void StartScenario(const Scenario& scenario) {
+    const ScenarioBodies& bodies = scenario.bodies;
+    objs = SlotMap<Object>(); // Drop the current run; old handles become invalid. // Aktuellen Lauf verwerfen; alte Handles werden ungültig.
+    objs.reserve(bodies.size() + 1024); // Room for user-spawned bodies. // Platz für vom Benutzer erzeugte Körper.
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        objs.Insert(Object(glm::dvec3(bodies.position[0][i], bodies.position[1][i], bodies.position[2][i]),
+                           glm::dvec3(bodies.velocity[0][i], bodies.velocity[1][i], bodies.velocity[2][i]),
+                           bodies.mass[i], bodies.density[i], bodies.color[i], bodies.glow[i] != 0));
+    }
+    creatingBody = BodyHandle{};
+    selectedBody = BodyHandle{};
+    simTime = 0.0;
+    stepCount = 0;
+    simTimeStep = scenario.timeStep;
+    substeps = glm::clamp(scenario.substeps, governor.minSubsteps, governor.maxSubsteps); // Respect the configured bounds. // Konfigurierte Grenzen einhalten.
+    cameraPos = scenario.camera;
+}
+
+/// Loads a scenario
+/// EN: Checkpoints are recognised by their signature, .csv files take the parallel bulk path and everything else is read as a text scene;
+///     replaces objs and resets the run clock only after the whole file parsed, returns false on error
+/// DE: Checkpoints werden an ihrer Signatur erkannt, .csv-Dateien nehmen den parallelen Massenpfad und alles andere wird als Textszene gelesen;
+///     ersetzt objs und setzt die Laufuhr erst zurück, nachdem die ganze Datei geparst wurde, gibt bei Fehler false zurück
+bool LoadScenario(const std::string& path) {
+    auto start = std::chrono::steady_clock::now(); // Load timing. // Ladezeitmessung.
+    MappedFile file; // Unmapped when done. // Wird am Ende freigegeben.
+    if (!file.Open(path)) {
+        std::cerr << "Cannot open scenario: " << path << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (file.size >= sizeof(checkpointMagic) && std::memcmp(file.data, checkpointMagic, sizeof(checkpointMagic)) == 0) {
+        file.Close();
+        return LoadCheckpoint(path); // Binary bulk path. // Binärer Massenpfad.
+    }
+
+    Scenario scenario; // Parsed file. // Geparste Datei.
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0; // Bulk text path. // Massen-Textpfad.
+    if (!(csv ? ParseScenarioCsvFile(file, path, scenario) : ParseScenarioTextFile(file, path, scenario))) return false;
+
+    StartScenario(scenario);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); // Load time. // Ladezeit.
+    std::cout << "Scenario loaded: " << path << " (" << scenario.bodies.size() << " bodies in " << ms << " ms)" << std::endl; // Confirmation. // Bestätigung.
+    return true;
+}
+
+
+/// Initial-condition generators
+/// EN: Seeded benchmark scenes written straight into the ScenarioBodies arrays on all cores. Every random number is a hash of
+///     (seed, body, draw), and sums are reduced over fixed chunks in order, so results are bit-identical for any thread count.
+///     Default scales follow the built-in scene: the star mass (1.989e25 kg) as total mass and the planet orbit (1.5e8 m) as scale length
+/// DE: Gesäte Benchmark-Szenen, die auf allen Kernen direkt in die ScenarioBodies-Arrays geschrieben werden. Jede Zufallszahl ist ein Hash aus
+///     (Seed, Körper, Ziehung), und Summen werden über feste Blöcke der Reihe nach reduziert, sodass Ergebnisse für jede Thread-Anzahl bitgleich sind.
+///     Standardmaßstäbe folgen der eingebauten Szene: die Sternmasse (1.989e25 kg) als Gesamtmasse und die Planetenbahn (1.5e8 m) als Skalenlänge
+enum GeneratorKind {
+    GEN_PLUMMER, // Plummer sphere, exact distribution function. // Plummer-Kugel, exakte Verteilungsfunktion.
+    GEN_HERNQUIST, // Hernquist halo, Jeans velocities. // Hernquist-Halo, Jeans-Geschwindigkeiten.
+    GEN_NFW, // NFW halo with concentration 10, Jeans velocities. // NFW-Halo mit Konzentration 10, Jeans-Geschwindigkeiten.
+    GEN_DISK, // Exponential disk around a central bulge body. // Exponentielle Scheibe um einen zentralen Bulge-Körper.
+    GEN_GALAXIES, // Two disks on a parabolic collision course. // Zwei Scheiben auf parabolischem Kollisionskurs.
+    GEN_KEPLER, // Planetesimals on circular orbits around a star. // Planetesimale auf Kreisbahnen um einen Stern.
+    GEN_COUNT
+};
+const char* generatorNames[GEN_COUNT] = { "plummer", "hernquist", "nfw", "disk", "galaxies", "kepler" }; // Names for --generate. // Namen für --generate.
+const size_t GENERATOR_GRAIN = 16384; // Bodies per parallel chunk. // Körper pro parallelem Block.
+
+struct GeneratorSettings {
+    int kind = GEN_PLUMMER; // GeneratorKind. // GeneratorKind.
+    size_t count = 0; // Bodies, 0 if no generator is used. // Körper, 0 wenn kein Generator verwendet wird.
+    uint64_t seed = 1; // Scene seed. // Szenen-Seed.
+    double mass = 1.989e25; // Total mass in kg. // Gesamtmasse in kg.
+    double scale = 1.5e8; // Scale length in m. // Skalenlänge in m.
+};
+
+GeneratorSettings generator; // Scene generator, active if --generate is given. // Szenengenerator, aktiv wenn --generate angegeben ist.
+
+/// Mixes a 64-bit value
+/// EN: SplitMix64 finalizer, the basis of all generator random numbers
+/// DE: SplitMix64-Finalisierer, die Grundlage aller Generator-Zufallszahlen
+uint64_t SplitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/// Body Random Class
+/// EN: Counter-based random stream of one body; the numbers depend only on seed, body index and draw count, never on scheduling
+/// DE: Zählerbasierter Zufallsstrom eines Körpers; die Zahlen hängen nur von Seed, Körperindex und Ziehungszahl ab, nie von der Planung
+class BodyRandom {
+    public:
+        BodyRandom(uint64_t seed, uint64_t body) : key(SplitMix64(seed ^ SplitMix64(body))) {}
+
+        double Uniform() { return double(SplitMix64(key + 0x9E3779B97F4A7C15ull * ++draw) >> 11) * 0x1.0p-53; } // [0, 1). // [0, 1).
+        double Gaussian() { // Box-Muller. // Box-Muller.
+            double u = 1.0 - Uniform(); // (0, 1]. // (0, 1].
+            return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * glm::pi<double>() * Uniform());
+        }
+        glm::dvec3 Direction() { // Uniform on the unit sphere. // Gleichverteilt auf der Einheitskugel.
+            double z = 2.0 * Uniform() - 1.0, phi = 2.0 * glm::pi<double>() * Uniform();
+            double s = std::sqrt(std::max(0.0, 1.0 - z * z));
+            return glm::dvec3(s * std::cos(phi), s * std::sin(phi), z);
+        }
+
+    private:
+        uint64_t key; // Hashed seed and body. // Gehashter Seed und Körper.
+        uint64_t draw = 0; // Numbers drawn so far. // Bisher gezogene Zahlen.
+};
+
+/// Spherical Profile Class
+/// 
+/// Tabulates a truncated spherical density profile on a logarithmic radius grid: enclosed mass for inverse-transform
+/// sampling of radii, the isotropic Jeans dispersion sigma^2(r) = 1/rho * integral_r^rmax rho G M / r'^2 dr' for velocities,
+/// and the escape speed to reject unbound bodies. Built once, serially; lookups are read-only and thread-safe.
+/// 
+/// EN: Radius sampling and velocity dispersion for halo generators.
+/// DE: Radius-Sampling und Geschwindigkeitsdispersion für Halo-Generatoren.
+class SphericalProfile {
+    public:
+        template <typename Density>
+        void Build(Density density, double scale, double maxRadius, double totalMass) {
+            const int points = 2048; // Table size. // Tabellengröße.
+            radius.assign(1, 0.0); mass.assign(1, 0.0);
+            std::vector<double> rho(1, 0.0); // Density shape at each radius. // Dichteform an jedem Radius.
+            double minRadius = scale * 1.0e-4; // Innermost tabulated radius. // Innerster tabellierter Radius.
+            for (int i = 0; i < points; ++i) {
+                double r = minRadius * std::pow(maxRadius / minRadius, double(i) / (points - 1));
+                double shell = 4.0 * glm::pi<double>() * r * r * density(r); // dM/dr. // dM/dr.
+                double previousShell = i == 0 ? 0.0 : 4.0 * glm::pi<double>() * radius.back() * radius.back() * rho.back();
+                mass.push_back(mass.back() + 0.5 * (shell + previousShell) * (r - radius.back()));
+                radius.push_back(r);
+                rho.push_back(density(r));
+            }
+            double norm = totalMass / mass.back(); // Density shape to kg. // Dichteform zu kg.
+            for (double& m : mass) m *= norm;
+
+            sigma.assign(radius.size(), 0.0);
+            escape.assign(radius.size(), 0.0);
+            double pressure = 0.0, potential = -G * totalMass / maxRadius; // Integrated from the edge inwards. // Vom Rand nach innen integriert.
+            escape.back() = std::sqrt(-2.0 * potential);
+            for (size_t i = radius.size() - 1; i > 1; --i) {
+                double dr = radius[i] - radius[i - 1];
+                double outer = G * mass[i] / (radius[i] * radius[i]), inner = G * mass[i - 1] / (radius[i - 1] * radius[i - 1]); // Gravity. // Gravitation.
+                pressure += 0.5 * (rho[i] * outer + rho[i - 1] * inner) * dr;
+                potential -= 0.5 * (outer + inner) * dr;
+                sigma[i - 1] = std::sqrt(pressure / rho[i - 1]);
+                escape[i - 1] = std::sqrt(-2.0 * potential);
+            }
+            sigma[0] = sigma[1]; escape[0] = escape[1]; // Centre takes the innermost value. // Zentrum übernimmt den innersten Wert.
+        }
+
+        /// Radius enclosing the fraction u of the mass
+        /// EN: Inverse-transform sampling by bisection and linear interpolation
+        /// DE: Inversionsmethode per Bisektion und linearer Interpolation
+        double SampleRadius(double u) const {
+            double target = u * mass.back(); // Enclosed mass. // Eingeschlossene Masse.
+            size_t i = std::upper_bound(mass.begin(), mass.end(), target) - mass.begin(); // First entry above. // Erster Eintrag darüber.
+            i = glm::clamp<size_t>(i, 1, mass.size() - 1);
+            double t = (target - mass[i - 1]) / std::max(mass[i] - mass[i - 1], 1e-300);
+            return radius[i - 1] + t * (radius[i] - radius[i - 1]);
+        }
+        double Sigma(double r) const { return Lookup(sigma, r); }
+        double Escape(double r) const { return Lookup(escape, r); }
+
+    private:
+        std::vector<double> radius, mass, sigma, escape; // Tables by radius. // Tabellen nach Radius.
+
+        double Lookup(const std::vector<double>& table, double r) const {
+            size_t i = std::upper_bound(radius.begin(), radius.end(), r) - radius.begin();
+            i = glm::clamp<size_t>(i, 1, radius.size() - 1);
+            double t = glm::clamp((r - radius[i - 1]) / (radius[i] - radius[i - 1]), 0.0, 1.0);
+            return table[i - 1] + t * (table[i] - table[i - 1]);
+        }
+};
+
+/// Plummer sphere
+/// EN: Aarseth, Henon and Wielen (1974): radii from the inverted mass profile, speeds by rejection from the exact distribution function; truncated at 30 scale radii
+/// DE: Aarseth, Henon und Wielen (1974): Radien aus dem invertierten Massenprofil, Geschwindigkeiten per Verwerfung aus der exakten Verteilungsfunktion; bei 30 Skalenradien abgeschnitten
+void GeneratePlummer(ScenarioBodies& bodies, size_t begin, size_t end, uint64_t seed, double mass, double scale, glm::vec4 color) {
+    double bodyMass = mass / double(end - begin); // Equal masses. // Gleiche Massen.
+    double maxFraction = std::pow(1.0 + 1.0 / (30.0 * 30.0), -1.5); // Mass inside 30 scale radii. // Masse innerhalb von 30 Skalenradien.
+    ParallelFor(end - begin, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            BodyRandom random(seed, i);
+            double u = std::max(random.Uniform() * maxFraction, 1e-12); // Enclosed mass fraction. // Eingeschlossener Massenanteil.
+            double r = scale / std::sqrt(std::pow(u, -2.0 / 3.0) - 1.0);
+            double q = 0.0, y = 1.0; // Speed in units of the escape speed. // Geschwindigkeit in Einheiten der Fluchtgeschwindigkeit.
+            while (y > q * q * std::pow(1.0 - q * q, 3.5)) { q = random.Uniform(); y = 0.1 * random.Uniform(); }
+            double escapeSpeed = std::sqrt(2.0 * G * mass / scale) * std::pow(1.0 + r * r / (scale * scale), -0.25);
+            bodies.Set(i, random.Direction() * r, random.Direction() * (q * escapeSpeed), bodyMass, 3344.0f, color);
+        }
+    });
+}
+
+/// Tabulated halo
+/// EN: Radii from the profile's mass table, velocities from a local Maxwellian with the Jeans dispersion, redrawn above 95% of the escape speed
+/// DE: Radien aus der Massentabelle des Profils, Geschwindigkeiten aus einer lokalen Maxwell-Verteilung mit der Jeans-Dispersion, oberhalb von 95% der Fluchtgeschwindigkeit neu gezogen
+void GenerateHalo(ScenarioBodies& bodies, size_t begin, size_t end, uint64_t seed, double mass, const SphericalProfile& profile, glm::vec4 color) {
+    double bodyMass = mass / double(end - begin); // Equal masses. // Gleiche Massen.
+    ParallelFor(end - begin, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            BodyRandom random(seed, i);
+            double r = profile.SampleRadius(random.Uniform());
+            double sigma = profile.Sigma(r), limit = 0.95 * profile.Escape(r); // Dispersion and speed cap. // Dispersion und Geschwindigkeitsgrenze.
+            glm::dvec3 velocity(0.0);
+            for (int attempt = 0; attempt < 16; ++attempt) {
+                velocity = glm::dvec3(random.Gaussian(), random.Gaussian(), random.Gaussian()) * sigma;
+                if (glm::length(velocity) < limit) break;
+            }
+            if (glm::length(velocity) >= limit) velocity *= limit / glm::length(velocity); // Keep it bound. // Gebunden halten.
+            bodies.Set(i, random.Direction() * r, velocity, bodyMass, 3344.0f, color);
+        }
+    });
+}
+
+/// Exponential disk
+/// EN: A glowing bulge body holding 10% of the mass at begin, the rest in a disk with scale length `scale` (truncated at 5) and sech^2 thickness of 5%;
+///     rotation from the enclosed mass in the spherical approximation plus 5% random motion
+/// DE: Ein leuchtender Bulge-Körper mit 10% der Masse bei begin, der Rest in einer Scheibe mit Skalenlänge `scale` (bei 5 abgeschnitten) und sech^2-Dicke von 5%;
+///     Rotation aus der eingeschlossenen Masse in sphärischer Näherung plus 5% Zufallsbewegung
+void GenerateDisk(ScenarioBodies& bodies, size_t begin, size_t end, uint64_t seed, double mass, double scale) {
+    const double bulge = 0.1 * mass, disk = mass - bulge; // Mass split. // Massenaufteilung.
+    const double maxX = 5.0; // Truncation in scale lengths. // Abschneiden in Skalenlängen.
+    auto enclosed = [](double x) { return 1.0 - (1.0 + x) * std::exp(-x); }; // Disk mass fraction inside x scale lengths. // Scheibenmassenanteil innerhalb von x Skalenlängen.
+    double bodyMass = disk / double(std::max<size_t>(end - begin - 1, 1)); // Equal disk masses. // Gleiche Scheibenmassen.
+    bodies.Set(begin, glm::dvec3(0.0), glm::dvec3(0.0), end - begin > 1 ? bulge : mass, 5515.0f, glm::vec4(1.0f, 0.929f, 0.176f, 1.0f), true);
+    ParallelFor(end - begin - 1, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = begin + 1 + first; i < begin + 1 + last; ++i) {
+            BodyRandom random(seed, i);
+            double u = random.Uniform() * enclosed(maxX); // Enclosed mass fraction. // Eingeschlossener Massenanteil.
+            double low = 0.0, high = maxX; // Bisection bracket. // Bisektionsintervall.
+            for (int step = 0; step < 48; ++step) { double mid = 0.5 * (low + high); (enclosed(mid) < u ? low : high) = mid; }
+            double x = 0.5 * (low + high), R = x * scale; // Cylindrical radius. // Zylinderradius.
+            double phi = 2.0 * glm::pi<double>() * random.Uniform();
+            double z = 0.05 * scale * std::atanh(glm::clamp(2.0 * random.Uniform() - 1.0, -0.999, 0.999)); // sech^2 layer. // sech^2-Schicht.
+            double speed = std::sqrt(G * (bulge + disk * enclosed(x) / enclosed(maxX)) / std::max(R, 1e-3 * scale)); // Circular speed. // Kreisbahngeschwindigkeit.
+            glm::dvec3 tangent(-std::sin(phi), 0.0, std::cos(phi)); // Rotation in the x-z plane, like the built-in orbits. // Rotation in der x-z-Ebene, wie die eingebauten Bahnen.
+            glm::dvec3 jitter(random.Gaussian(), random.Gaussian(), random.Gaussian()); // Random motion. // Zufallsbewegung.
+            bodies.Set(i, glm::dvec3(R * std::cos(phi), z, R * std::sin(phi)), tangent * speed + jitter * (0.05 * speed), bodyMass, 3344.0f, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f));
+        }
+    });
+}
+
+/// Kepler disk
+/// EN: A star like the built-in sun at begin and planetesimals with 0.1% of its mass on circular orbits between 0.5 and 2 scale lengths
+/// DE: Ein Stern wie die eingebaute Sonne bei begin und Planetesimale mit 0,1% seiner Masse auf Kreisbahnen zwischen 0,5 und 2 Skalenlängen
+void GenerateKepler(ScenarioBodies& bodies, size_t begin, size_t end, uint64_t seed, double mass, double scale) {
+    double bodyMass = 1.0e-3 * mass / double(std::max<size_t>(end - begin - 1, 1)); // Planetesimal mass. // Planetesimalmasse.
+    bodies.Set(begin, glm::dvec3(0.0), glm::dvec3(0.0), mass, 5515.0f, glm::vec4(1.0f, 0.929f, 0.176f, 1.0f), true);
+    ParallelFor(end - begin - 1, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = begin + 1 + first; i < begin + 1 + last; ++i) {
+            BodyRandom random(seed, i);
+            double inner = 0.5 * scale, outer = 2.0 * scale; // Ring bounds. // Ringgrenzen.
+            double R = std::sqrt(inner * inner + random.Uniform() * (outer * outer - inner * inner)); // Uniform in area. // Flächengleichverteilt.
+            double phi = 2.0 * glm::pi<double>() * random.Uniform();
+            double z = 0.01 * R * random.Gaussian(); // Thin layer. // Dünne Schicht.
+            double speed = std::sqrt(G * mass / R); // Kepler speed. // Kepler-Geschwindigkeit.
+            bodies.Set(i, glm::dvec3(R * std::cos(phi), z, R * std::sin(phi)), glm::dvec3(-std::sin(phi), 0.0, std::cos(phi)) * speed, bodyMass, 3344.0f, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f));
+        }
+    });
+}
+
+/// Moves a component to rest at the origin
+/// EN: Subtracts the centre of mass and its velocity; partial sums per fixed chunk are added in order, so the result is thread-count independent
+/// DE: Zieht Massenschwerpunkt und dessen Geschwindigkeit ab; Teilsummen pro festem Block werden der Reihe nach addiert, sodass das Ergebnis unabhängig von der Thread-Anzahl ist
+void CenterComponent(ScenarioBodies& bodies, size_t begin, size_t end) {
+    size_t chunks = (end - begin + GENERATOR_GRAIN - 1) / GENERATOR_GRAIN; // Fixed partition. // Feste Aufteilung.
+    std::vector<std::array<double, 7>> partial(chunks, std::array<double, 7>{}); // m, m*x, m*v per chunk. // m, m*x, m*v pro Block.
+    ParallelFor(end - begin, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        std::array<double, 7>& sum = partial[first / GENERATOR_GRAIN];
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            sum[0] += bodies.mass[i];
+            for (int c = 0; c < 3; ++c) { sum[1 + c] += bodies.mass[i] * bodies.position[c][i]; sum[4 + c] += bodies.mass[i] * bodies.velocity[c][i]; }
+        }
+    });
+    std::array<double, 7> total{}; // Whole component. // Ganze Komponente.
+    for (const std::array<double, 7>& sum : partial) for (int k = 0; k < 7; ++k) total[k] += sum[k];
+    if (total[0] <= 0.0) return;
+    ParallelFor(end - begin, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            for (int c = 0; c < 3; ++c) { bodies.position[c][i] -= total[1 + c] / total[0]; bodies.velocity[c][i] -= total[4 + c] / total[0]; }
+        }
+    });
+}
+
+/// Places a component
+/// EN: Tilts it by angle radians about the x axis, then moves it to offset with the given bulk velocity
+/// DE: Kippt sie um angle Radiant um die x-Achse und verschiebt sie dann mit der gegebenen Gesamtgeschwindigkeit nach offset
+void PlaceComponent(ScenarioBodies& bodies, size_t begin, size_t end, double angle, glm::dvec3 offset, glm::dvec3 velocity) {
+    double c = std::cos(angle), s = std::sin(angle); // Rotation. // Rotation.
+    ParallelFor(end - begin, GENERATOR_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            double y = bodies.position[1][i], z = bodies.position[2][i], vy = bodies.velocity[1][i], vz = bodies.velocity[2][i];
+            bodies.position[1][i] = c * y - s * z; bodies.position[2][i] = s * y + c * z;
+            bodies.velocity[1][i] = c * vy - s * vz; bodies.velocity[2][i] = s * vy + c * vz;
+            for (int k = 0; k < 3; ++k) { bodies.position[k][i] += offset[k]; bodies.velocity[k][i] += velocity[k]; }
+        }
+    });
+}
+
+/// Generates a benchmark scene
+/// EN: Fills a scenario for the settings and starts it; the camera is placed to frame the scene
+/// DE: Füllt ein Szenario für die Einstellungen und startet es; die Kamera wird so platziert, dass sie die Szene erfasst
+void GenerateScene(const GeneratorSettings& settings) {
+    auto start = std::chrono::steady_clock::now(); // Generation timing. // Generierungszeitmessung.
+    Scenario scenario; // Generated bodies. // Generierte Körper.
+    ScenarioBodies& bodies = scenario.bodies;
+    size_t n = std::max<size_t>(settings.count, settings.kind == GEN_GALAXIES ? 4 : 2); // Room for central bodies. // Platz für Zentralkörper.
+    double M = settings.mass, a = settings.scale; // Scales. // Maßstäbe.
+    bodies.resize(n);
+    glm::vec4 haloColor(0.8f, 0.8f, 1.0f, 1.0f); // Pale blue halo bodies. // Blassblaue Halo-Körper.
+    double extent = 4.0 * a; // Radius to frame. // Zu erfassender Radius.
+
+    SphericalProfile profile; // Halo table. // Halo-Tabelle.
+    switch (settings.kind) {
+        case GEN_PLUMMER:
+            GeneratePlummer(bodies, 0, n, settings.seed, M, a, haloColor);
+            break;
+        case GEN_HERNQUIST:
+            profile.Build([a](double r) { return 1.0 / ((r / a) * std::pow(1.0 + r / a, 3.0)); }, a, 100.0 * a, M);
+            GenerateHalo(bodies, 0, n, settings.seed, M, profile, haloColor);
+            break;
+        case GEN_NFW:
+            profile.Build([a](double r) { return 1.0 / ((r / a) * (1.0 + r / a) * (1.0 + r / a)); }, a, 10.0 * a, M); // Concentration 10. // Konzentration 10.
+            GenerateHalo(bodies, 0, n, settings.seed, M, profile, haloColor);
+            extent = 10.0 * a;
+            break;
+        case GEN_DISK:
+            GenerateDisk(bodies, 0, n, settings.seed, M, a);
+            extent = 5.0 * a;
+            break;
+        case GEN_GALAXIES: {
+            size_t half = n / 2; // First galaxy. // Erste Galaxie.
+            double separation = 12.0 * a, impact = 3.0 * a; // Start distance and offset. // Startabstand und Versatz.
+            double approach = std::sqrt(2.0 * G * M / separation); // Parabolic relative speed. // Parabolische Relativgeschwindigkeit.
+            GenerateDisk(bodies, 0, half, settings.seed, 0.5 * M, a);
+            GenerateDisk(bodies, half, n, SplitMix64(settings.seed), 0.5 * M, a);
+            PlaceComponent(bodies, 0, half, 0.0, glm::dvec3(-0.5 * separation, -0.5 * impact, 0.0), glm::dvec3(0.5 * approach, 0.0, 0.0));
+            PlaceComponent(bodies, half, n, glm::radians(60.0), glm::dvec3(0.5 * separation, 0.5 * impact, 0.0), glm::dvec3(-0.5 * approach, 0.0, 0.0)); // Tilted partner. // Geneigter Partner.
+            extent = separation;
+            break;
+        }
+        case GEN_KEPLER:
+            GenerateKepler(bodies, 0, n, settings.seed, M, a);
+            extent = 2.0 * a;
+            break;
+    }
+    CenterComponent(bodies, 0, n); // Whole scene at rest at the origin. // Ganze Szene ruht im Ursprung.
+
+    scenario.camera = glm::dvec3(0.0, 0.5 * extent, 2.5 * extent);
+    StartScenario(scenario);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); // Generation time. // Generierungszeit.
+    std::cout << "Generated " << generatorNames[settings.kind] << " scene: " << n << " bodies, seed " << settings.seed << " (" << ms << " ms)" << std::endl; // Confirmation. // Bestätigung.
+}
+
+/// SPSC Queue Class
+/// 
+/// Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+/// The producer only writes tail, the consumer only writes head; acquire/release ordering publishes the slot contents.
+/// 
+/// EN: Hands values from one thread to another without locks; Capacity must be a power of two.
+/// DE: Übergibt Werte ohne Sperren von einem Thread an einen anderen; Capacity muss eine Zweierpotenz sein.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    public:
+        /// Appends a value (producer side)
+        /// EN: Returns false if the queue is full
+        /// DE: Gibt false zurück, wenn die Warteschlange voll ist
+        bool Push(const T& value) {
+            size_t t = tail.load(std::memory_order_relaxed); // Own index. // Eigener Index.
+            if (t - head.load(std::memory_order_acquire) == Capacity) return false; // Full. // Voll.
+            slots[t & (Capacity - 1)] = value;
+            tail.store(t + 1, std::memory_order_release); // Publish slot. // Slot veröffentlichen.
+            return true;
+        }
+
+        /// Removes the oldest value (consumer side)
+        /// EN: Returns false if the queue is empty
+        /// DE: Gibt false zurück, wenn die Warteschlange leer ist
+        bool Pop(T& value) {
+            size_t h = head.load(std::memory_order_relaxed); // Own index. // Eigener Index.
+            if (h == tail.load(std::memory_order_acquire)) return false; // Empty. // Leer.
+            value = slots[h & (Capacity - 1)];
+            head.store(h + 1, std::memory_order_release); // Free slot. // Slot freigeben.
+            return true;
+        }
+
+    private:
+        std::array<T, Capacity> slots; // Ring storage. // Ringspeicher.
+        alignas(64) std::atomic<size_t> head{0}; // Next slot to read; own cache line. // Nächster zu lesender Slot; eigene Cache-Zeile.
+        alignas(64) std::atomic<size_t> tail{0}; // Next slot to write; own cache line. // Nächster zu schreibender Slot; eigene Cache-Zeile.
+};
+
+/// Input commands sent from the GLFW callbacks to the simulation
+/// EN: Callbacks never touch objs; the simulation applies commands at a step boundary
+/// DE: Callbacks greifen nie auf objs zu; die Simulation wendet Befehle an einer Schrittgrenze an
+enum InputCommandType {
+    CMD_SPAWN, // Start creating a body at the origin. // Beginne Erstellung eines Körpers im Ursprung.
+    CMD_LAUNCH, // Release the body being created. // Gib den erstellten Körper frei.
+    CMD_GROW_MASS, // Multiply the new body's mass by value. // Multipliziere die Masse des neuen Körpers mit value.
+    CMD_NUDGE, // Move the new or selected body by vector * radius * value. // Bewege den neuen oder gewählten Körper um vector * radius * value.
+    CMD_PAUSE, // Pause if value != 0, else resume. // Pausiere wenn value != 0, sonst fortsetzen.
+    CMD_PICK, // Select the nearest body along the ray origin + t * vector. // Wähle den nächsten Körper entlang des Strahls origin + t * vector.
+    CMD_REMOVE, // Delete the selected body. // Lösche den gewählten Körper.
+    CMD_SAVE_CHECKPOINT, // Save the run to checkpointPath. // Speichere den Lauf nach checkpointPath.
+    CMD_LOAD_CHECKPOINT, // Restore the run from checkpointPath. // Stelle den Lauf aus checkpointPath wieder her.
+    CMD_REPLAY_SPEED, // Multiply the replay speed by value. // Multipliziere die Wiedergabegeschwindigkeit mit value.
+    CMD_REPLAY_SEEK, // Move the replay cursor by value frames. // Bewege den Wiedergabe-Cursor um value Frames.
+    CMD_EXPORT // Export the current state for ParaView. // Exportiere den aktuellen Zustand für ParaView.
+};
+
+struct InputCommand {
+    InputCommandType type; // What to do. // Was zu tun ist.
+    glm::dvec3 origin; // Ray origin for picking. // Strahlursprung für Picking.
+    glm::dvec3 vector; // Direction for nudging or picking. // Richtung für Verschieben oder Picking.
+    double value; // Factor or flag. // Faktor oder Flag.
+};
+
+SpscQueue<InputCommand, 256> inputQueue; // Callbacks to simulation. // Callbacks zur Simulation.
+
+/// Sends one command to the simulation
+/// EN: Drops the command if the queue is full; at 256 entries that only happens if the simulation stalls
+/// DE: Verwirft den Befehl, wenn die Warteschlange voll ist; bei 256 Einträgen passiert das nur, wenn die Simulation hängt
+void PushInput(InputCommandType type, glm::dvec3 vector = glm::dvec3(0.0, 0.0, 0.0), double value = 0.0, glm::dvec3 origin = glm::dvec3(0.0, 0.0, 0.0)) {
+    inputQueue.Push(InputCommand{ type, origin, vector, value });
+}
+
+/// Trajectory file layout
+/// EN: A 64-byte file header followed by one frame per snapshot; each frame starts where the previous one ends (frameBytes).
+///     Raw frames are a header plus 64-byte aligned SoA arrays that can be read in place from a mapping;
+///     quantized frames are a header, a TrajectoryQuantizedFrame, a block offset table and the coded blocks.
+///     A finished file ends with an index of all frames and a TrajectoryIndexTrailer pointing to it
+/// DE: Ein 64-Byte-Dateiheader gefolgt von einem Frame pro Schnappschuss; jeder Frame beginnt, wo der vorherige endet (frameBytes).
+///     Rohe Frames bestehen aus Header und 64-Byte-ausgerichteten SoA-Arrays, die direkt aus einem Mapping gelesen werden können;
+///     quantisierte Frames aus Header, einem TrajectoryQuantizedFrame, einer Block-Offset-Tabelle und den kodierten Blöcken.
+///     Eine fertige Datei endet mit einem Index aller Frames und einem TrajectoryIndexTrailer, der darauf zeigt
+const char trajectoryMagic[8] = { 'G', 'S', 'I', 'M', 'T', 'R', 'A', 'J' }; // File signature. // Dateisignatur.
+const uint32_t trajectoryVersion = 3; // Bumped on every layout change. // Bei jeder Layoutänderung erhöht.
+const uint32_t trajectoryFrameMagic = 0x4D415246; // "FRAM" in little-endian. // "FRAM" in Little-Endian.
+const char trajectoryIndexMagic[8] = { 'G', 'S', 'I', 'M', 'T', 'I', 'D', 'X' }; // Index trailer signature. // Signatur des Index-Trailers.
+
+enum TrajectoryArray {
+    TRAJ_ID, // uint32 slot index, stable while the body lives. // uint32-Slot-Index, stabil solange der Körper lebt.
+    TRAJ_POS_X, TRAJ_POS_Y, TRAJ_POS_Z, // double, m. // double, m.
+    TRAJ_VEL_X, TRAJ_VEL_Y, TRAJ_VEL_Z, // double, m/s. // double, m/s.
+    TRAJ_MASS, // float, kg. // float, kg.
+    TRAJ_ARRAY_COUNT
+};
+const uint64_t trajectoryElementSize[TRAJ_ARRAY_COUNT] = { 4, 8, 8, 8, 8, 8, 8, 4 }; // Bytes per body. // Bytes pro Körper.
+
+enum TrajectoryFrameCodec {
+    TRAJ_CODEC_RAW, // Full-precision SoA arrays. // SoA-Arrays in voller Genauigkeit.
+    TRAJ_CODEC_QUANTIZED // Quantized, delta- and rANS-coded (TrajectoryCodec). // Quantisiert, delta- und rANS-kodiert (TrajectoryCodec).
+};
+
+struct TrajectoryFileHeader {
+    char magic[8]; // trajectoryMagic. // trajectoryMagic.
+    uint32_t version; // trajectoryVersion. // trajectoryVersion.
+    uint32_t headerSize; // Bytes before the first frame. // Bytes vor dem ersten Frame.
+    uint32_t everySteps; // Frames between snapshots. // Frames zwischen Schnappschüssen.
+    uint32_t arrayCount; // TRAJ_ARRAY_COUNT. // TRAJ_ARRAY_COUNT.
+    double timeStep; // Simulated seconds per frame. // Simulierte Sekunden pro Frame.
+    double positionError; // Position error bound of quantized frames in m, 0 if raw. // Positionsfehlergrenze quantisierter Frames in m, 0 wenn roh.
+};
+
+struct TrajectoryFrameHeader {
+    uint32_t magic; // trajectoryFrameMagic. // trajectoryFrameMagic.
+    uint32_t headerSize; // sizeof(TrajectoryFrameHeader). // sizeof(TrajectoryFrameHeader).
+    uint64_t frameBytes; // Whole frame including padding. // Ganzer Frame einschließlich Auffüllung.
+    uint64_t step; // stepCount at the snapshot. // stepCount beim Schnappschuss.
+    double simTime; // Simulated seconds at the snapshot. // Simulierte Sekunden beim Schnappschuss.
+    uint64_t bodyCount; // Elements per array. // Elemente pro Array.
+    uint32_t codec; // TrajectoryFrameCodec. // TrajectoryFrameCodec.
+    uint32_t keyframe; // Decodable without the previous frame. // Ohne den vorherigen Frame dekodierbar.
+    uint64_t arrayOffset[TRAJ_ARRAY_COUNT]; // Raw frames: byte offset of each array from the frame start. // Rohe Frames: Byte-Offset jedes Arrays vom Frame-Anfang.
+};
+
+struct TrajectoryQuantizedFrame {
+    double quantum[2]; // Grid spacing of positions (m) and velocities (m/s). // Rasterabstand von Positionen (m) und Geschwindigkeiten (m/s).
+    int64_t base[6]; // Keyframes: quantized bounding-box minimum of each component. // Schlüsselframes: quantisiertes Bounding-Box-Minimum jeder Komponente.
+    uint32_t blockCount; // Coded blocks; followed by blockCount + 1 uint64 offsets. // Kodierte Blöcke; gefolgt von blockCount + 1 uint64-Offsets.
+    uint32_t blockBodies; // Bodies per block. // Körper pro Block.
+};
+
+struct TrajectoryIndexEntry {
+    uint64_t offset; // Frame start in the file. // Frame-Anfang in der Datei.
+    uint64_t frameBytes; // Frame size. // Frame-Größe.
+    uint64_t step; // stepCount at the snapshot. // stepCount beim Schnappschuss.
+    double simTime; // Simulated seconds at the snapshot. // Simulierte Sekunden beim Schnappschuss.
+    uint32_t keyframe; // Decodable without the previous frame. // Ohne den vorherigen Frame dekodierbar.
+    uint32_t reserved; // Zero. // Null.
+};
+
+struct TrajectoryIndexTrailer {
+    uint64_t indexOffset; // Start of the TrajectoryIndexEntry array. // Anfang des TrajectoryIndexEntry-Arrays.
+    uint64_t frameCount; // Entries in the index. // Einträge im Index.
+    char magic[8]; // trajectoryIndexMagic, last bytes of the file. // trajectoryIndexMagic, letzte Bytes der Datei.
+};
+
+/// Variable-length integer coding
+/// EN: LEB128 varints with zigzag mapping for signed values, so small deltas take one byte
+/// DE: LEB128-Varints mit Zickzack-Abbildung für vorzeichenbehaftete Werte, sodass kleine Deltas ein Byte belegen
+inline void PutVarint(std::vector<unsigned char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((unsigned char)(value | 0x80)); // Low 7 bits and continuation flag. // Untere 7 Bits und Fortsetzungsflag.
+        value >>= 7;
+    }
+    out.push_back((unsigned char)value);
+}
+inline uint64_t GetVarint(const unsigned char*& in, const unsigned char* end) {
+    uint64_t value = 0; // Decoded value. // Dekodierter Wert.
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        unsigned char byte = *in++;
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+inline uint64_t ZigZag(int64_t value) { return (uint64_t(value) << 1) ^ uint64_t(value >> 63); }
+inline int64_t UnZigZag(uint64_t value) { return int64_t(value >> 1) ^ -int64_t(value & 1); }
+
+/// rANS entropy coder
+/// EN: Order-0 range asymmetric numeral system over bytes with 12-bit frequencies and a 32-bit state, emitting whole bytes;
+///     encodes back to front so the decoder reads front to back
+/// DE: Range-ANS nullter Ordnung über Bytes mit 12-Bit-Häufigkeiten und 32-Bit-Zustand, gibt ganze Bytes aus;
+///     kodiert von hinten nach vorne, damit der Dekodierer von vorne nach hinten liest
+const int RANS_SCALE_BITS = 12; // Frequencies sum to 4096. // Häufigkeiten summieren sich zu 4096.
+const uint32_t RANS_LOW = 1u << 23; // Lower bound of the normalized state. // Untergrenze des normalisierten Zustands.
+
+/// Builds a frequency table
+/// EN: Scales byte counts to sum 4096, keeping every present byte at least 1
+/// DE: Skaliert Byte-Anzahlen auf Summe 4096, wobei jedes vorkommende Byte mindestens 1 behält
+void RansFrequencies(const unsigned char* data, size_t size, uint16_t* frequency) {
+    uint64_t count[256] = {}; // Byte histogram. // Byte-Histogramm.
+    for (size_t i = 0; i < size; ++i) ++count[data[i]];
+    int total = 0; // Sum of scaled frequencies. // Summe der skalierten Häufigkeiten.
+    int largest = 0; // Most frequent byte. // Häufigstes Byte.
+    for (int s = 0; s < 256; ++s) {
+        frequency[s] = count[s] ? (uint16_t)std::max<uint64_t>(1, count[s] * (1u << RANS_SCALE_BITS) / size) : 0;
+        total += frequency[s];
+        if (count[s] > count[largest]) largest = s;
+    }
+    while (total != (1 << RANS_SCALE_BITS)) { // Fix rounding. // Rundung korrigieren.
+        int step = total < (1 << RANS_SCALE_BITS) ? 1 : -1; // Direction. // Richtung.
+        int target = largest; // Adjust the most frequent byte that can take it. // Häufigstes Byte anpassen, das es verträgt.
+        if (step < 0 && frequency[target] <= 1) {
+            for (int s = 0; s < 256; ++s) if (frequency[s] > frequency[target]) target = s;
+        }
+        frequency[target] = (uint16_t)(frequency[target] + step);
+        total += step;
+    }
+}
+
+/// Encodes bytes with rANS
+/// EN: Appends the coded bytes to out; the frequency table must come from RansFrequencies over the same data
+/// DE: Hängt die kodierten Bytes an out an; die Häufigkeitstabelle muss aus RansFrequencies über dieselben Daten stammen
+void RansEncode(const unsigned char* data, size_t size, const uint16_t* frequency, std::vector<unsigned char>& out) {
+    uint32_t start[256]; // Cumulative frequencies. // Kumulative Häufigkeiten.
+    for (int s = 0, sum = 0; s < 256; sum += frequency[s], ++s) start[s] = (uint32_t)sum;
+    std::vector<unsigned char> coded(size * 2 + 16); // At most 12 bits per byte plus the state. // Höchstens 12 Bits pro Byte plus Zustand.
+    unsigned char* end = coded.data() + coded.size();
+    unsigned char* cursor = end; // Written backwards. // Rückwärts geschrieben.
+    uint32_t state = RANS_LOW;
+    for (size_t i = size; i-- > 0;) {
+        uint32_t f = frequency[data[i]];
+        uint32_t limit = ((RANS_LOW >> RANS_SCALE_BITS) << 8) * f; // Renormalize above this. // Oberhalb davon renormalisieren.
+        while (state >= limit) {
+            *--cursor = (unsigned char)(state & 0xFF);
+            state >>= 8;
+        }
+        state = ((state / f) << RANS_SCALE_BITS) + (state % f) + start[data[i]];
+    }
+    for (int byte = 3; byte >= 0; --byte) *--cursor = (unsigned char)(state >> (8 * byte)); // Final state, little-endian. // Endzustand, Little-Endian.
+    out.insert(out.end(), cursor, end);
+}
+
+/// Decodes rANS bytes
+/// EN: Fills size bytes into out; returns false if the input ends early
+/// DE: Füllt size Bytes in out; gibt false zurück, wenn die Eingabe zu früh endet
+bool RansDecode(const unsigned char* in, const unsigned char* inEnd, const uint16_t* frequency, unsigned char* out, size_t size) {
+    uint32_t start[256]; // Cumulative frequencies. // Kumulative Häufigkeiten.
+    unsigned char symbol[1 << RANS_SCALE_BITS]; // Slot to byte lookup. // Slot-zu-Byte-Tabelle.
+    for (int s = 0, sum = 0; s < 256; sum += frequency[s], ++s) {
+        start[s] = (uint32_t)sum;
+        std::memset(symbol + sum, s, frequency[s]);
+    }
+    if (inEnd - in < 4) return false;
+    uint32_t state = uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16 | uint32_t(in[3]) << 24;
+    in += 4;
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t slot = state & ((1u << RANS_SCALE_BITS) - 1); // Position within 4096. // Position innerhalb von 4096.
+        unsigned char s = symbol[slot];
+        out[i] = s;
+        state = frequency[s] * (state >> RANS_SCALE_BITS) + slot - start[s];
+        while (state < RANS_LOW) {
+            if (in == inEnd) return false;
+            state = (state << 8) | *in++;
+        }
+    }
+    return true;
+}
+
+/// Decoded trajectory frame
+/// EN: Structure-of-arrays copy of one snapshot
+/// DE: Structure-of-Arrays-Kopie eines Schnappschusses
+struct TrajectorySnapshot {
+    uint64_t step = 0; // stepCount at the snapshot. // stepCount beim Schnappschuss.
+    double simTime = 0.0; // Simulated seconds. // Simulierte Sekunden.
+    std::vector<uint32_t> id; // Body slot indices. // Körper-Slot-Indizes.
+    std::vector<double> position[3]; // x, y, z in m. // x, y, z in m.
+    std::vector<double> velocity[3]; // x, y, z in m/s. // x, y, z in m/s.
+    std::vector<float> mass; // kg. // kg.
+};
+
+/// Trajectory Codec Class
+/// 
+/// Lossy compression for trajectory frames. Positions and velocities are quantized to a fixed grid of quantum = 2 * error,
+/// so every component is reconstructed within the error bound. Keyframes store values relative to the quantized bounding-box
+/// minimum; other frames store differences to the previous frame, which are small for smooth orbits. The integers become
+/// zigzag varints and each block of bodies is compressed by an order-0 rANS coder. Blocks are encoded and decoded in parallel.
+/// Differences are taken between quantized values, so errors never accumulate across frames.
+/// 
+/// EN: Encodes raw trajectory frames into compressed frames and back; one instance per direction, as both keep the previous frame.
+/// DE: Kodiert rohe Trajektorien-Frames in komprimierte Frames und zurück; eine Instanz pro Richtung, da beide den vorherigen Frame behalten.
+class TrajectoryCodec {
+    public:
+        static constexpr size_t BLOCK_BODIES = 65536; // Bodies per independently coded block. // Körper pro unabhängig kodiertem Block.
+        static constexpr size_t MAX_VARINT_BYTES_PER_BODY = 5 + 6 * 10 + 5; // Id, six components and mass at full varint length. // Id, sechs Komponenten und Masse in voller Varint-Länge.
+        double positionQuantum = 1.0; // Position grid in m (2 * error bound). // Positionsraster in m (2 * Fehlergrenze).
+        double velocityQuantum = 1.0; // Velocity grid in m/s. // Geschwindigkeitsraster in m/s.
+        int keyframeInterval = 64; // Maximum frames between keyframes. // Maximale Frames zwischen Schlüsselframes.
+
+        /// Forgets the previous frame
+        /// EN: The next encoded frame becomes a keyframe
+        /// DE: Der nächste kodierte Frame wird ein Schlüsselframe
+        void Reset() {
+            previousId.clear();
+            sinceKeyframe = 0;
+        }
+
+        /// Compresses one raw frame
+        /// EN: Writes a TRAJ_CODEC_QUANTIZED frame for the raw frame at raw into out
+        /// DE: Schreibt einen TRAJ_CODEC_QUANTIZED-Frame für den rohen Frame bei raw nach out
+        void Encode(const unsigned char* raw, std::vector<unsigned char>& out) {
+            TrajectoryFrameHeader header; // Raw frame header. // Header des rohen Frames.
+            std::memcpy(&header, raw, sizeof(TrajectoryFrameHeader));
+            size_t count = (size_t)header.bodyCount;
+            const uint32_t* id = (const uint32_t*)(raw + header.arrayOffset[TRAJ_ID]);
+            const double* value[6]; // Quantized components. // Quantisierte Komponenten.
+            for (int c = 0; c < 6; ++c) value[c] = (const double*)(raw + header.arrayOffset[TRAJ_POS_X + c]);
+            const uint32_t* massBits = (const uint32_t*)(raw + header.arrayOffset[TRAJ_MASS]); // Masses as bits. // Massen als Bits.
+
+            bool keyframe = sinceKeyframe == 0 || sinceKeyframe >= keyframeInterval || previousId.size() != count
+                || !std::equal(id, id + count, previousId.begin()); // Bodies changed. // Körper haben sich geändert.
+            sinceKeyframe = keyframe ? 1 : sinceKeyframe + 1;
+            if (keyframe) {
+                previousId.assign(id, id + count);
+                for (int c = 0; c < 6; ++c) previous[c].resize(count);
+                previousMass.resize(count);
+            }
+
+            TrajectoryQuantizedFrame quantized{}; // Grid and bounding box. // Raster und Bounding Box.
+            quantized.quantum[0] = positionQuantum;
+            quantized.quantum[1] = velocityQuantum;
+            quantized.blockBodies = (uint32_t)BLOCK_BODIES;
+            quantized.blockCount = (uint32_t)((count + BLOCK_BODIES - 1) / BLOCK_BODIES);
+            for (int c = 0; c < 6 && keyframe; ++c) {
+                double minimum = std::numeric_limits<double>::infinity(); // Bounding-box minimum. // Bounding-Box-Minimum.
+                for (size_t i = 0; i < count; ++i) minimum = std::min(minimum, value[c][i]);
+                quantized.base[c] = count ? std::llround(minimum / quantized.quantum[c / 3]) : 0;
+            }
+
+            std::vector<std::vector<unsigned char>> blocks(quantized.blockCount); // Coded blocks. // Kodierte Blöcke.
+            ParallelFor(count, BLOCK_BODIES, [&](size_t begin, size_t end) {
+                std::vector<unsigned char> bytes; // Varint stream of the block. // Varint-Strom des Blocks.
+                bytes.reserve((end - begin) * 16);
+                for (size_t i = begin; i < end && keyframe; ++i) {
+                    PutVarint(bytes, ZigZag(int64_t(id[i]) - (i > begin ? int64_t(id[i - 1]) : 0))); // Ids mostly ascend. // Ids steigen meist.
+                }
+                for (int c = 0; c < 6; ++c) {
+                    double quantum = quantized.quantum[c / 3]; // Grid of this component. // Raster dieser Komponente.
+                    for (size_t i = begin; i < end; ++i) {
+                        int64_t q = std::llround(value[c][i] / quantum); // Nearest grid point. // Nächster Rasterpunkt.
+                        PutVarint(bytes, keyframe ? uint64_t(q - quantized.base[c]) : ZigZag(q - previous[c][i]));
+                        previous[c][i] = q;
+                    }
+                }
+                for (size_t i = begin; i < end; ++i) {
+                    PutVarint(bytes, keyframe ? massBits[i] : massBits[i] ^ previousMass[i]); // Unchanged masses become zero. // Unveränderte Massen werden zu null.
+                    previousMass[i] = massBits[i];
+                }
+                blocks[begin / BLOCK_BODIES] = EncodeBlock(bytes);
+            });
+
+            header.codec = TRAJ_CODEC_QUANTIZED;
+            header.keyframe = keyframe ? 1 : 0;
+            for (int array = 0; array < TRAJ_ARRAY_COUNT; ++array) header.arrayOffset[array] = 0; // Unused for this codec. // Für diesen Codec unbenutzt.
+            uint64_t offset = sizeof(TrajectoryFrameHeader) + sizeof(TrajectoryQuantizedFrame) + (quantized.blockCount + 1) * sizeof(uint64_t); // First block. // Erster Block.
+            std::vector<uint64_t> blockOffset; // Block starts from the frame start, plus the end. // Blockanfänge ab Frame-Anfang, plus Ende.
+            for (const std::vector<unsigned char>& block : blocks) {
+                blockOffset.push_back(offset);
+                offset += block.size();
+            }
+            blockOffset.push_back(offset);
+            header.frameBytes = AlignUp(offset, 64);
+
+            out.assign(header.frameBytes, 0);
+            std::memcpy(out.data(), &header, sizeof(TrajectoryFrameHeader));
+            std::memcpy(out.data() + sizeof(TrajectoryFrameHeader), &quantized, sizeof(TrajectoryQuantizedFrame));
+            std::memcpy(out.data() + sizeof(TrajectoryFrameHeader) + sizeof(TrajectoryQuantizedFrame), blockOffset.data(), blockOffset.size() * sizeof(uint64_t));
+            for (size_t b = 0; b < blocks.size(); ++b) std::memcpy(out.data() + blockOffset[b], blocks[b].data(), blocks[b].size());
+        }
+
+        /// Decodes one frame of either codec
+        /// EN: Delta frames need the preceding frames since the last keyframe to be decoded first; returns false for corrupt or out-of-order frames
+        /// DE: Delta-Frames benötigen, dass die vorangehenden Frames seit dem letzten Schlüsselframe zuerst dekodiert werden; gibt für beschädigte oder ungeordnete Frames false zurück
+        bool Decode(const unsigned char* frame, uint64_t size, TrajectorySnapshot& snapshot) {
+            TrajectoryFrameHeader header; // Frame header. // Frame-Header.
+            if (size < sizeof(TrajectoryFrameHeader)) return false;
+            std::memcpy(&header, frame, sizeof(TrajectoryFrameHeader));
+            if (header.magic != trajectoryFrameMagic || header.frameBytes > size) return false;
+            size_t count = (size_t)header.bodyCount;
+            snapshot.step = header.step;
+            snapshot.simTime = header.simTime;
+            std::vector<double>* component[6] = { &snapshot.position[0], &snapshot.position[1], &snapshot.position[2], &snapshot.velocity[0], &snapshot.velocity[1], &snapshot.velocity[2] };
+            auto resize = [&]() { // Only after count is known to fit the frame. // Erst wenn count sicher in den Frame passt.
+                snapshot.id.resize(count);
+                for (int c = 0; c < 6; ++c) component[c]->resize(count);
+                snapshot.mass.resize(count);
+            };
+
+            if (header.codec == TRAJ_CODEC_RAW) {
+                for (int array = 0; array < TRAJ_ARRAY_COUNT; ++array) {
+                    if (header.arrayOffset[array] > header.frameBytes || (header.frameBytes - header.arrayOffset[array]) / trajectoryElementSize[array] < count) return false;
+                }
+                resize();
+                std::memcpy(snapshot.id.data(), frame + header.arrayOffset[TRAJ_ID], count * sizeof(uint32_t));
+                for (int c = 0; c < 6; ++c) std::memcpy(component[c]->data(), frame + header.arrayOffset[TRAJ_POS_X + c], count * sizeof(double));
+                std::memcpy(snapshot.mass.data(), frame + header.arrayOffset[TRAJ_MASS], count * sizeof(float));
+                return true;
+            }
+            if (header.codec != TRAJ_CODEC_QUANTIZED) return false;
+
+            TrajectoryQuantizedFrame quantized; // Grid and bounding box. // Raster und Bounding Box.
+            uint64_t tableEnd = sizeof(TrajectoryFrameHeader) + sizeof(TrajectoryQuantizedFrame); // End of the block table. // Ende der Blocktabelle.
+            if (tableEnd > header.frameBytes) return false;
+            std::memcpy(&quantized, frame + sizeof(TrajectoryFrameHeader), sizeof(TrajectoryQuantizedFrame));
+            if (quantized.blockBodies == 0 || quantized.blockBodies > BLOCK_BODIES) return false;
+            if (quantized.blockCount != count / quantized.blockBodies + (count % quantized.blockBodies != 0)) return false;
+            tableEnd += (uint64_t(quantized.blockCount) + 1) * sizeof(uint64_t);
+            if (tableEnd > header.frameBytes) return false; // Also bounds count by the frame size. // Begrenzt damit auch count durch die Frame-Größe.
+            std::vector<uint64_t> blockOffset(quantized.blockCount + 1); // Block starts plus end. // Blockanfänge plus Ende.
+            std::memcpy(blockOffset.data(), frame + tableEnd - blockOffset.size() * sizeof(uint64_t), blockOffset.size() * sizeof(uint64_t));
+            for (uint32_t b = 0; b < quantized.blockCount; ++b) {
+                if (blockOffset[b] < tableEnd || blockOffset[b] > blockOffset[b + 1] || blockOffset[b + 1] > header.frameBytes) return false;
+            }
+            resize();
+
+            bool keyframe = header.keyframe != 0;
+            if (keyframe) {
+                for (int c = 0; c < 6; ++c) previous[c].resize(count);
+                previousMass.resize(count);
+                previousId.resize(count);
+            } else if (previousId.size() != count) {
+                return false; // Needs the preceding frames. // Benötigt die vorangehenden Frames.
+            }
+
+            std::atomic<bool> valid{true}; // All blocks decoded. // Alle Blöcke dekodiert.
+            ParallelFor(count, quantized.blockBodies, [&](size_t begin, size_t end) {
+                size_t b = begin / quantized.blockBodies; // Block index. // Blockindex.
+                std::vector<unsigned char> bytes; // Varint stream of the block. // Varint-Strom des Blocks.
+                size_t maxBytes = (end - begin) * MAX_VARINT_BYTES_PER_BODY; // Largest valid stream. // Größter gültiger Strom.
+                if (!DecodeBlock(frame + blockOffset[b], frame + blockOffset[b + 1], maxBytes, bytes)) { valid = false; return; }
+                const unsigned char* in = bytes.data();
+                const unsigned char* inEnd = in + bytes.size();
+                for (size_t i = begin; i < end && keyframe; ++i) {
+                    previousId[i] = uint32_t(UnZigZag(GetVarint(in, inEnd)) + (i > begin ? int64_t(previousId[i - 1]) : 0));
+                }
+                for (int c = 0; c < 6; ++c) {
+                    double quantum = quantized.quantum[c / 3]; // Grid of this component. // Raster dieser Komponente.
+                    for (size_t i = begin; i < end; ++i) {
+                        uint64_t coded = GetVarint(in, inEnd);
+                        int64_t q = keyframe ? quantized.base[c] + int64_t(coded) : previous[c][i] + UnZigZag(coded);
+                        previous[c][i] = q;
+                        (*component[c])[i] = double(q) * quantum;
+                    }
+                }
+                for (size_t i = begin; i < end; ++i) {
+                    uint32_t bits = uint32_t(GetVarint(in, inEnd)) ^ (keyframe ? 0u : previousMass[i]);
+                    previousMass[i] = bits;
+                    std::memcpy(&snapshot.mass[i], &bits, sizeof(float));
+                }
+                if (in != inEnd) valid = false; // Stream length mismatch. // Stromlänge stimmt nicht.
+            });
+            if (!valid) {
+                previousId.clear(); // Force a keyframe next. // Als Nächstes Schlüsselframe erzwingen.
+                return false;
+            }
+            snapshot.id = previousId;
+            return true;
+        }
+
+    private:
+        std::vector<uint32_t> previousId; // Bodies of the previous frame. // Körper des vorherigen Frames.
+        std::vector<int64_t> previous[6]; // Quantized components of the previous frame. // Quantisierte Komponenten des vorherigen Frames.
+        std::vector<uint32_t> previousMass; // Mass bits of the previous frame. // Massen-Bits des vorherigen Frames.
+        int sinceKeyframe = 0; // Frames since the last keyframe, 0 before the first. // Frames seit dem letzten Schlüsselframe, 0 vor dem ersten.
+
+        /// Entropy-codes one block
+        /// EN: Layout: uint32 raw size, uint32 mode (0 stored, 1 rANS), for rANS 256 uint16 frequencies, then the payload; small or incompressible blocks are stored
+        /// DE: Layout: uint32 Rohgröße, uint32 Modus (0 gespeichert, 1 rANS), bei rANS 256 uint16-Häufigkeiten, dann die Nutzdaten; kleine oder nicht komprimierbare Blöcke werden gespeichert
+        static std::vector<unsigned char> EncodeBlock(const std::vector<unsigned char>& bytes) {
+            uint32_t prefix[2] = { (uint32_t)bytes.size(), 0 }; // Raw size and mode. // Rohgröße und Modus.
+            std::vector<unsigned char> block(sizeof(prefix));
+            if (bytes.size() >= 1024) { // Table overhead pays off. // Tabellenaufwand lohnt sich.
+                uint16_t frequency[256]; // Scaled byte frequencies. // Skalierte Byte-Häufigkeiten.
+                RansFrequencies(bytes.data(), bytes.size(), frequency);
+                block.resize(sizeof(prefix) + sizeof(frequency));
+                std::memcpy(block.data() + sizeof(prefix), frequency, sizeof(frequency)); // Table for the decoder. // Tabelle für den Dekodierer.
+                RansEncode(bytes.data(), bytes.size(), frequency, block);
+                prefix[1] = 1;
+            }
+            if (prefix[1] == 0 || block.size() >= sizeof(prefix) + bytes.size()) { // Store instead. // Stattdessen speichern.
+                block.resize(sizeof(prefix));
+                block.insert(block.end(), bytes.begin(), bytes.end());
+                prefix[1] = 0;
+            }
+            std::memcpy(block.data(), prefix, sizeof(prefix));
+            return block;
+        }
+
+        /// Reverses EncodeBlock
+        /// EN: Returns false for corrupt blocks, including raw sizes above maxBytes
+        /// DE: Gibt für beschädigte Blöcke false zurück, auch bei Rohgrößen über maxBytes
+        static bool DecodeBlock(const unsigned char* in, const unsigned char* end, size_t maxBytes, std::vector<unsigned char>& bytes) {
+            uint32_t prefix[2]; // Raw size and mode. // Rohgröße und Modus.
+            if (end - in < (std::ptrdiff_t)sizeof(prefix)) return false;
+            std::memcpy(prefix, in, sizeof(prefix));
+            in += sizeof(prefix);
+            if (prefix[0] > maxBytes || (prefix[1] == 0 && end - in != (std::ptrdiff_t)prefix[0])) return false;
+            bytes.resize(prefix[0]);
+            if (prefix[1] == 0) {
+                std::memcpy(bytes.data(), in, prefix[0]);
+                return true;
+            }
+            uint16_t frequency[256]; // Scaled byte frequencies. // Skalierte Byte-Häufigkeiten.
+            if (prefix[1] != 1 || end - in < (std::ptrdiff_t)sizeof(frequency)) return false;
+            std::memcpy(frequency, in, sizeof(frequency));
+            uint32_t total = 0; // Must be 4096. // Muss 4096 sein.
+            for (int s = 0; s < 256; ++s) total += frequency[s];
+            if (total != (1u << RANS_SCALE_BITS)) return false;
+            return RansDecode(in + sizeof(frequency), end, frequency, bytes.data(), bytes.size());
+        }
+};
+
+/// Trajectory Writer Class
+/// 
+/// Records a snapshot every K frames. The simulation thread copies the bodies into one of a fixed set of frame buffers
+/// and passes it to a writer thread through an SPSC queue; the writer packs frames into a large aligned staging buffer
+/// and writes it in multi-megabyte sequential chunks, optionally with O_DIRECT (FILE_FLAG_NO_BUFFERING on Windows).
+/// Used buffers return through a second SPSC queue, so the simulation only waits when all buffers are queued.
+/// With an error bound the writer compresses each frame with TrajectoryCodec before packing it, off the simulation thread.
+/// 
+/// EN: Streams trajectories to disk without blocking the simulation.
+/// DE: Streamt Trajektorien auf die Festplatte, ohne die Simulation zu blockieren.
+class TrajectoryWriter {
+    public:
+        static constexpr int QUEUE_DEPTH = 8; // Frame buffers in flight. // Frame-Puffer in Bearbeitung.
+        static constexpr size_t CHUNK_BYTES = 8u << 20; // Size of one disk write. // Größe eines Schreibvorgangs.
+        static constexpr size_t BLOCK_BYTES = 4096; // Direct I/O alignment. // Ausrichtung für Direct I/O.
+        uint64_t frames = 0; // Snapshots taken. // Aufgenommene Schnappschüsse.
+        uint64_t stalls = 0; // Snapshots that waited for a free buffer. // Schnappschüsse, die auf einen freien Puffer warteten.
+        uint64_t rawBytes = 0; // Frame bytes before compression. // Frame-Bytes vor der Kompression.
+
+        ~TrajectoryWriter() { Close(); }
+
+        bool IsOpen() const { return writer.joinable(); }
+
+        /// Creates the file and starts the writer thread
+        /// EN: positionError > 0 enables compression; velocities get the bound that moves a body by at most that error between snapshots
+        ///     at the time step of each snapshot. Falls back to buffered I/O if the file system rejects direct I/O; returns false if the file cannot be created
+        /// DE: positionError > 0 aktiviert die Kompression; Geschwindigkeiten erhalten die Grenze, die einen Körper zwischen Schnappschüssen höchstens um diesen Fehler bewegt,
+        ///     beim Zeitschritt des jeweiligen Schnappschusses. Fällt auf gepufferte Ein-/Ausgabe zurück, wenn das Dateisystem Direct I/O ablehnt; gibt false zurück, wenn die Datei nicht erstellt werden kann
+        bool Open(const std::string& path, int everySteps, bool directIO, double positionError = 0.0) {
+            Close();
+            direct = directIO && OpenFile(path, true);
+            if (!direct && !OpenFile(path, false)) {
+                std::cerr << "Cannot create trajectory file: " << path << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            if (directIO && !direct) std::cerr << "Direct I/O not supported for " << path << ", using buffered writes." << std::endl; // Warning. // Warnung.
+
+            staging.assign(CHUNK_BYTES + BLOCK_BYTES, 0); // Room to align the start. // Platz zum Ausrichten des Anfangs.
+            chunk = staging.data() + (BLOCK_BYTES - (uintptr_t)staging.data() % BLOCK_BYTES) % BLOCK_BYTES;
+            used = 0;
+            written = 0;
+            frames = stalls = rawBytes = 0;
+            index.clear();
+            compress = positionError > 0.0;
+            codec.Reset();
+            codec.positionQuantum = 2.0 * positionError; // Rounding error is half a step. // Rundungsfehler ist ein halber Schritt.
+            snapshotSteps = everySteps;
+            TrajectoryFileHeader header{}; // File header, padded to 64 bytes. // Dateiheader, auf 64 Bytes aufgefüllt.
+            std::memcpy(header.magic, trajectoryMagic, sizeof(header.magic));
+            header.version = trajectoryVersion;
+            header.headerSize = (uint32_t)AlignUp(sizeof(TrajectoryFileHeader), 64);
+            header.everySteps = (uint32_t)everySteps;
+            header.arrayCount = TRAJ_ARRAY_COUNT;
+            header.timeStep = simTimeStep;
+            header.positionError = compress ? positionError : 0.0;
+            std::memcpy(chunk, &header, sizeof(TrajectoryFileHeader));
+            used = header.headerSize;
+
+            for (int slot = 0; slot < QUEUE_DEPTH; ++slot) freeBuffers.Push(slot); // All buffers start free. // Alle Puffer beginnen frei.
+            stopping.store(false, std::memory_order_relaxed);
+            writer = std::thread([this]() { WriterLoop(); });
+            return true;
+        }
+
+        /// Takes a snapshot
+        /// EN: Copies all placed bodies into a free frame buffer and queues it; waits only if every buffer is still queued
+        /// DE: Kopiert alle platzierten Körper in einen freien Frame-Puffer und reiht ihn ein; wartet nur, wenn alle Puffer noch eingereiht sind
+        void Capture(const SlotMap<Object>& bodies, uint64_t step, double time) {
+            int slot; // Buffer to fill. // Zu füllender Puffer.
+            if (!freeBuffers.Pop(slot)) {
+                ++stalls; // Disk is slower than the simulation. // Festplatte ist langsamer als die Simulation.
+                while (!freeBuffers.Pop(slot)) std::this_thread::yield();
+            }
+            uint64_t count = 0; // Bodies in the frame. // Körper im Frame.
+            for (const Object& body : bodies) count += body.Initalizing ? 0 : 1;
+
+            TrajectoryFrameHeader header{}; // Frame header. // Frame-Header.
+            header.magic = trajectoryFrameMagic;
+            header.headerSize = sizeof(TrajectoryFrameHeader);
+            header.step = step;
+            header.simTime = time;
+            header.bodyCount = count;
+            header.codec = TRAJ_CODEC_RAW; // The writer thread may compress it. // Der Schreib-Thread kann ihn komprimieren.
+            header.keyframe = 1;
+            uint64_t offset = AlignUp(sizeof(TrajectoryFrameHeader), 64); // Next free byte. // Nächstes freies Byte.
+            for (int array = 0; array < TRAJ_ARRAY_COUNT; ++array) {
+                header.arrayOffset[array] = offset;
+                offset = AlignUp(offset + count * trajectoryElementSize[array], 64);
+            }
+            header.frameBytes = offset;
+
+            std::vector<unsigned char>& frame = buffers[slot];
+            frame.resize(offset); // Reuses capacity after the first frames. // Verwendet nach den ersten Frames die Kapazität wieder.
+            std::memcpy(frame.data(), &header, sizeof(TrajectoryFrameHeader));
+            auto column = [&](int array) { return frame.data() + header.arrayOffset[array]; };
+            uint32_t* id = (uint32_t*)column(TRAJ_ID);
+            double* posX = (double*)column(TRAJ_POS_X); double* posY = (double*)column(TRAJ_POS_Y); double* posZ = (double*)column(TRAJ_POS_Z);
+            double* velX = (double*)column(TRAJ_VEL_X); double* velY = (double*)column(TRAJ_VEL_Y); double* velZ = (double*)column(TRAJ_VEL_Z);
+            float* mass = (float*)column(TRAJ_MASS);
+            size_t i = 0; // Output index. // Ausgabeindex.
+            for (size_t dense = 0; dense < bodies.size(); ++dense) {
+                const Object& body = bodies[dense];
+                if (body.Initalizing) continue; // Not part of the run yet. // Noch nicht Teil des Laufs.
+                id[i] = bodies.HandleAt(dense).index;
+                posX[i] = body.position.x; posY[i] = body.position.y; posZ[i] = body.position.z;
+                velX[i] = body.velocity.x; velY[i] = body.velocity.y; velZ[i] = body.velocity.z;
+                mass[i] = body.mass;
+                ++i;
+            }
+            velocityQuantum[slot] = codec.positionQuantum / (snapshotSteps * simTimeStep); // A checkpoint restore may change the time step. // Ein geladener Checkpoint kann den Zeitschritt ändern.
+            filledBuffers.Push(slot); // Cannot fail: at most QUEUE_DEPTH slots exist. // Kann nicht fehlschlagen: es gibt höchstens QUEUE_DEPTH Slots.
+            ++frames;
+        }
+
+        /// Finishes the file
+        /// EN: Drains the queue, writes the last partial chunk and closes the file
+        /// DE: Leert die Warteschlange, schreibt den letzten Teil-Chunk und schließt die Datei
+        void Close() {
+            if (!writer.joinable()) return;
+            stopping.store(true, std::memory_order_release);
+            writer.join();
+            int slot;
+            while (freeBuffers.Pop(slot)) {} // Reset for a later Open. // Für ein späteres Open zurücksetzen.
+            CloseFile();
+            std::ostringstream summary; // Own stream, so std::cout keeps its format. // Eigener Stream, damit std::cout sein Format behält.
+            summary << "Trajectory: " << frames << " frames, " << written / (1024 * 1024) << " MiB, " << stalls << " stalls";
+            if (compress && written > 0) summary << ", compression " << std::fixed << std::setprecision(1) << double(rawBytes) / written << ":1";
+            std::cout << summary.str() << std::endl; // Summary. // Zusammenfassung.
+        }
+
+    private:
+        std::array<std::vector<unsigned char>, QUEUE_DEPTH> buffers; // Frame buffers. // Frame-Puffer.
+        std::array<double, QUEUE_DEPTH> velocityQuantum{}; // Velocity grid of each buffered frame. // Geschwindigkeitsraster jedes gepufferten Frames.
+        int snapshotSteps = 1; // Steps between snapshots. // Schritte zwischen Schnappschüssen.
+        SpscQueue<int, QUEUE_DEPTH> filledBuffers; // Simulation to writer. // Simulation zum Schreiber.
+        SpscQueue<int, QUEUE_DEPTH> freeBuffers; // Writer back to simulation. // Schreiber zurück zur Simulation.
+        std::thread writer; // Background writer. // Hintergrund-Schreiber.
+        std::atomic<bool> stopping{false}; // Close requested. // Schließen angefordert.
+        std::vector<unsigned char> staging; // Chunk storage with alignment slack. // Chunk-Speicher mit Ausrichtungsreserve.
+        unsigned char* chunk = nullptr; // Block-aligned start of the chunk. // Blockausgerichteter Anfang des Chunks.
+        size_t used = 0; // Bytes pending in the chunk. // Ausstehende Bytes im Chunk.
+        uint64_t written = 0; // Bytes in the file. // Bytes in der Datei.
+        bool direct = false; // File opened for direct I/O. // Datei für Direct I/O geöffnet.
+        bool compress = false; // Frames are quantized and entropy-coded. // Frames werden quantisiert und entropiekodiert.
+        TrajectoryCodec codec; // Encoder state, owned by the writer thread. // Kodiererzustand, gehört dem Schreib-Thread.
+        std::vector<unsigned char> encoded; // Reused compressed frame. // Wiederverwendeter komprimierter Frame.
+        std::vector<TrajectoryIndexEntry> index; // Frames written so far. // Bisher geschriebene Frames.
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE; // Output file. // Ausgabedatei.
+#else
+        int fd = -1; // Output file descriptor. // Ausgabe-Dateideskriptor.
+#endif
+
+        /// Writer thread body
+        /// EN: Packs queued frames into chunks until Close is requested and the queue is empty
+        /// DE: Packt eingereihte Frames in Chunks, bis Close angefordert wird und die Warteschlange leer ist
+        void WriterLoop() {
+            int slot; // Frame to write. // Zu schreibender Frame.
+            while (true) {
+                if (filledBuffers.Pop(slot)) {
+                    WriteFrame(slot);
+                } else if (stopping.load(std::memory_order_acquire)) {
+                    if (!filledBuffers.Pop(slot)) break; // Nothing was pushed before the stop. // Vor dem Stopp wurde nichts eingereiht.
+                    WriteFrame(slot);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Idle between snapshots. // Leerlauf zwischen Schnappschüssen.
+                }
+            }
+            AppendIndex();
+            Flush(true);
+        }
+
+        /// Writes one queued frame
+        /// EN: Compresses it if enabled, then hands the buffer back to the simulation
+        /// DE: Komprimiert ihn, falls aktiviert, und gibt den Puffer dann an die Simulation zurück
+        void WriteFrame(int slot) {
+            rawBytes += buffers[slot].size();
+            const std::vector<unsigned char>& frame = compress ? encoded : buffers[slot]; // Bytes that go to disk. // Bytes, die auf die Festplatte gehen.
+            if (compress && velocityQuantum[slot] != codec.velocityQuantum) {
+                codec.velocityQuantum = velocityQuantum[slot];
+                codec.Reset(); // Deltas need the same grid; start a keyframe. // Deltas brauchen dasselbe Raster; Schlüsselframe beginnen.
+            }
+            if (compress) codec.Encode(buffers[slot].data(), encoded); // Blocks run on all cores. // Blöcke laufen auf allen Kernen.
+            TrajectoryFrameHeader header; // For the index. // Für den Index.
+            std::memcpy(&header, frame.data(), sizeof(TrajectoryFrameHeader));
+            index.push_back(TrajectoryIndexEntry{ written + used, header.frameBytes, header.step, header.simTime, header.keyframe, 0 });
+            Append(frame.data(), frame.size());
+            freeBuffers.Push(slot); // Hand the buffer back. // Puffer zurückgeben.
+        }
+
+        /// Appends the frame index
+        /// EN: Written last, so an interrupted recording simply has no index
+        /// DE: Wird zuletzt geschrieben, sodass eine unterbrochene Aufzeichnung einfach keinen Index hat
+        void AppendIndex() {
+            TrajectoryIndexTrailer trailer{}; // Points back to the index. // Zeigt zurück auf den Index.
+            trailer.indexOffset = written + used;
+            trailer.frameCount = index.size();
+            std::memcpy(trailer.magic, trajectoryIndexMagic, sizeof(trailer.magic));
+            Append((const unsigned char*)index.data(), index.size() * sizeof(TrajectoryIndexEntry));
+            Append((const unsigned char*)&trailer, sizeof(TrajectoryIndexTrailer));
+        }
+
+        /// Copies bytes into the staging chunk
+        /// EN: Writes the chunk whenever it is full
+        /// DE: Schreibt den Chunk, sobald er voll ist
+        void Append(const unsigned char* bytes, size_t size) {
+            while (size > 0) {
+                size_t part = std::min(size, CHUNK_BYTES - used); // Fits in the chunk. // Passt in den Chunk.
+                std::memcpy(chunk + used, bytes, part);
+                used += part; bytes += part; size -= part;
+                if (used == CHUNK_BYTES) Flush(false);
+            }
+        }
+
+        /// Writes the staging chunk
+        /// EN: Direct I/O needs whole blocks, so the final chunk is zero-padded and the file truncated afterwards
+        /// DE: Direct I/O braucht ganze Blöcke, daher wird der letzte Chunk mit Nullen aufgefüllt und die Datei danach gekürzt
+        void Flush(bool final) {
+            size_t size = used; // Bytes to write. // Zu schreibende Bytes.
+            if (direct && size % BLOCK_BYTES != 0) {
+                size = AlignUp(size, BLOCK_BYTES);
+                std::memset(chunk + used, 0, size - used); // Padding. // Auffüllung.
+            }
+            WriteAll(chunk, size);
+            written += used;
+            used = 0;
+            if (final && direct) TruncateFile(written); // Drop the padding. // Auffüllung entfernen.
+        }
+
+#ifdef _WIN32
+        bool OpenFile(const std::string& path, bool unbuffered) {
+            DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN | (unbuffered ? FILE_FLAG_NO_BUFFERING : 0);
+            file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, flags, nullptr);
+            return file != INVALID_HANDLE_VALUE;
+        }
+        void WriteAll(const unsigned char* bytes, size_t size) {
+            while (size > 0) {
+                DWORD done = 0; // Bytes written by this call. // Von diesem Aufruf geschriebene Bytes.
+                if (!WriteFile(file, bytes, (DWORD)std::min<size_t>(size, CHUNK_BYTES), &done, nullptr) || done == 0) {
+                    std::cerr << "Trajectory write failed." << std::endl; // Error message. // Fehlermeldung.
+                    return;
+                }
+                bytes += done; size -= done;
+            }
+        }
+        void TruncateFile(uint64_t size) {
+            LARGE_INTEGER position; // New end of file. // Neues Dateiende.
+            position.QuadPart = (LONGLONG)size;
+            SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+        }
+        void CloseFile() {
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+#else
+        bool OpenFile(const std::string& path, bool unbuffered) {
+            int flags = O_WRONLY | O_CREAT | O_TRUNC; // Replace any old file. // Alte Datei ersetzen.
+#ifdef O_DIRECT
+            if (unbuffered) flags |= O_DIRECT; // Bypass the page cache. // Seitencache umgehen.
+#else
+            if (unbuffered) return false; // Not available on this platform. // Auf dieser Plattform nicht verfügbar.
+#endif
+            fd = open(path.c_str(), flags, 0644);
+            return fd >= 0;
+        }
+        void WriteAll(const unsigned char* bytes, size_t size) {
+            while (size > 0) {
+                ssize_t done = write(fd, bytes, size); // Bytes written by this call. // Von diesem Aufruf geschriebene Bytes.
+                if (done <= 0) {
+                    std::cerr << "Trajectory write failed." << std::endl; // Error message. // Fehlermeldung.
+                    return;
+                }
+                bytes += done; size -= (size_t)done;
+            }
+        }
+        void TruncateFile(uint64_t size) {
+            if (ftruncate(fd, (off_t)size) != 0) std::cerr << "Trajectory truncate failed." << std::endl; // Error message. // Fehlermeldung.
+        }
+        void CloseFile() {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+#endif
+};
+
+TrajectoryWriter trajectory; // Trajectory output, open if --trajectory is given. // Trajektorienausgabe, offen wenn --trajectory angegeben ist.
+
+/// Writes a frame into the bodies
+/// EN: Used by replay and the stream client; shownIds tracks the body set in bodies.
+///     Positions go straight into the draw path; bodies are only recreated when the body set changes.
+///     Frames carry no colors, so the heaviest body glows like the star and the rest use the planet color
+/// DE: Von Wiedergabe und Stream-Client verwendet; shownIds verfolgt die Körpermenge in bodies.
+///     Positionen gehen direkt in den Zeichenpfad; Körper werden nur neu erstellt, wenn sich die Körpermenge ändert.
+///     Frames enthalten keine Farben, daher leuchtet der schwerste Körper wie der Stern und der Rest nutzt die Planetenfarbe
+void ShowBodyFrame(SlotMap<Object>& bodies, std::vector<uint32_t>& shownIds, size_t count, const uint32_t* id, const double* const* position, const double* const* velocity, const float* mass) {
+    if (shownIds.size() != count || !std::equal(id, id + count, shownIds.begin()) || bodies.size() != count) {
+        shownIds.assign(id, id + count);
+        size_t heaviest = 0; // Index of the glowing body. // Index des leuchtenden Körpers.
+        for (size_t i = 1; i < count; ++i) if (mass[i] > mass[heaviest]) heaviest = i;
+        bodies = SlotMap<Object>(); // Old handles become invalid. // Alte Handles werden ungültig.
+        bodies.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            bool star = i == heaviest; // Drawn like the central star. // Wie der Zentralstern gezeichnet.
+            bodies.Insert(Object(glm::dvec3(0.0), glm::dvec3(0.0), mass[i], 5515, star ? glm::vec4(1.0f, 0.929f, 0.176f, 1.0f) : glm::vec4(0.0f, 1.0f, 1.0f, 1.0f), star));
+        }
+        selectedBody = creatingBody = BodyHandle{};
+    }
+    ParallelFor(count, 65536, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Object& body = bodies[i];
+            body.position = glm::dvec3(position[0][i], position[1][i], position[2][i]);
+            body.velocity = glm::dvec3(velocity[0][i], velocity[1][i], velocity[2][i]);
+            if (body.mass != mass[i]) { // Merged or grown body. // Verschmolzener oder gewachsener Körper.
+                body.mass = mass[i];
+                body.radius = pow((3 * body.mass / body.density) / (4 * 3.14159265359f), 1.0f/3.0f);
+            }
+        }
+    });
+}
+
+/// Trajectory Replay Class
+/// 
+/// Plays a recorded trajectory through the normal renderer instead of simulating. The file is memory-mapped and frames are
+/// found through the index, so seeking is O(1); raw frames are copied straight from the mapping into the bodies,
+/// compressed frames are decoded forward from the nearest keyframe. The cursor moves in snapshots per second times speed,
+/// and a negative speed plays backwards.
+/// 
+/// EN: Replays recordings with scrubbing, reverse and speed control.
+/// DE: Spielt Aufzeichnungen mit Spulen, Rückwärtslauf und Geschwindigkeitssteuerung ab.
+class TrajectoryReplay {
+    public:
+        static constexpr double SNAPSHOTS_PER_SECOND = 30.0; // Playback rate at speed 1. // Wiedergaberate bei Geschwindigkeit 1.
+        std::vector<TrajectoryIndexEntry> index; // One entry per frame. // Ein Eintrag pro Frame.
+        double cursor = 0.0; // Playback position in frames. // Wiedergabeposition in Frames.
+        double speed = 1.0; // Playback speed, negative for reverse. // Wiedergabegeschwindigkeit, negativ für rückwärts.
+
+        bool IsOpen() const { return file.data != nullptr; }
+        size_t Frame() const { return (size_t)cursor; }
+
+        /// Opens a recording
+        /// EN: Uses the index at the end of the file; recordings without one (cut-off runs) are indexed by walking the frames
+        /// DE: Verwendet den Index am Dateiende; Aufzeichnungen ohne Index (abgebrochene Läufe) werden durch Ablaufen der Frames indiziert
+        bool Open(const std::string& path) {
+            if (!file.Open(path)) {
+                std::cerr << "Cannot open recording: " << path << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            TrajectoryFileHeader header; // File header. // Dateiheader.
+            if (file.size < sizeof(TrajectoryFileHeader)) { file.Close(); return false; }
+            std::memcpy(&header, file.data, sizeof(TrajectoryFileHeader));
+            if (std::memcmp(header.magic, trajectoryMagic, sizeof(header.magic)) != 0 || header.version < 2 || header.version > trajectoryVersion) {
+                std::cerr << "Not a trajectory recording: " << path << std::endl; // Error message. // Fehlermeldung.
+                file.Close();
+                return false;
+            }
+
+            index.clear();
+            TrajectoryIndexTrailer trailer; // Last bytes of the file. // Letzte Bytes der Datei.
+            if (file.size >= header.headerSize + sizeof(TrajectoryIndexTrailer)) {
+                std::memcpy(&trailer, file.data + file.size - sizeof(TrajectoryIndexTrailer), sizeof(TrajectoryIndexTrailer));
+                bool indexed = std::memcmp(trailer.magic, trajectoryIndexMagic, sizeof(trailer.magic)) == 0
+                    && trailer.indexOffset <= file.size - sizeof(TrajectoryIndexTrailer)
+                    && (file.size - sizeof(TrajectoryIndexTrailer) - trailer.indexOffset) / sizeof(TrajectoryIndexEntry) == trailer.frameCount;
+                if (indexed) {
+                    index.resize((size_t)trailer.frameCount);
+                    std::memcpy(index.data(), file.data + trailer.indexOffset, index.size() * sizeof(TrajectoryIndexEntry));
+                }
+            }
+            if (index.empty()) { // Walk the frames. // Frames ablaufen.
+                TrajectoryFrameHeader frame; // Current frame header. // Aktueller Frame-Header.
+                for (uint64_t offset = header.headerSize; offset + sizeof(TrajectoryFrameHeader) <= file.size; offset += frame.frameBytes) {
+                    std::memcpy(&frame, file.data + offset, sizeof(TrajectoryFrameHeader));
+                    if (frame.magic != trajectoryFrameMagic || frame.frameBytes < sizeof(TrajectoryFrameHeader) || frame.frameBytes > file.size - offset) break;
+                    index.push_back(TrajectoryIndexEntry{ offset, frame.frameBytes, frame.step, frame.simTime, frame.keyframe, 0 });
+                }
+            }
+            if (index.empty()) {
+                std::cerr << "Recording has no frames: " << path << std::endl; // Error message. // Fehlermeldung.
+                file.Close();
+                return false;
+            }
+            for (const TrajectoryIndexEntry& entry : index) {
+                if (entry.offset > file.size || entry.frameBytes > file.size - entry.offset) {
+                    std::cerr << "Corrupt recording index: " << path << std::endl; // Error message. // Fehlermeldung.
+                    file.Close();
+                    return false;
+                }
+            }
+            cursor = 0.0;
+            shown = decoded = SIZE_MAX;
+            codec.Reset();
+            std::cout << "Replaying " << path << ": " << index.size() << " frames" << std::endl; // Confirmation. // Bestätigung.
+            return true;
+        }
+
+        /// Moves the cursor
+        /// EN: Advances by seconds of wall-clock time at the current speed and seeks by whole frames; stops at both ends
+        /// DE: Rückt um Sekunden Echtzeit bei aktueller Geschwindigkeit vor und springt um ganze Frames; hält an beiden Enden an
+        void Advance(double seconds) { Seek(speed * SNAPSHOTS_PER_SECOND * seconds); }
+        void Seek(double frames) { cursor = glm::clamp(cursor + frames, 0.0, double(index.size() - 1)); }
+
+        /// Shows the frame under the cursor
+        /// EN: Updates bodies only when the frame changes; returns false if the frame cannot be read
+        /// DE: Aktualisiert Körper nur, wenn sich der Frame ändert; gibt false zurück, wenn der Frame nicht gelesen werden kann
+        bool Apply(SlotMap<Object>& bodies) {
+            size_t target = Frame(); // Frame to show. // Anzuzeigender Frame.
+            if (target == shown) return true;
+            const TrajectoryIndexEntry& entry = index[target];
+            const unsigned char* frame = file.data + entry.offset; // Frame in the mapping. // Frame im Mapping.
+            TrajectoryFrameHeader header; // Frame header. // Frame-Header.
+            if (entry.frameBytes < sizeof(TrajectoryFrameHeader)) return false;
+            std::memcpy(&header, frame, sizeof(TrajectoryFrameHeader));
+            size_t count = (size_t)header.bodyCount;
+
+            if (header.codec == TRAJ_CODEC_RAW) { // Read in place. // Direkt lesen.
+                for (int array = 0; array < TRAJ_ARRAY_COUNT; ++array) {
+                    if (header.arrayOffset[array] > entry.frameBytes || (entry.frameBytes - header.arrayOffset[array]) / trajectoryElementSize[array] < count) return false;
+                }
+                auto column = [&](int array) { return frame + header.arrayOffset[array]; };
+                const double* position[3] = { (const double*)column(TRAJ_POS_X), (const double*)column(TRAJ_POS_Y), (const double*)column(TRAJ_POS_Z) };
+                const double* velocity[3] = { (const double*)column(TRAJ_VEL_X), (const double*)column(TRAJ_VEL_Y), (const double*)column(TRAJ_VEL_Z) };
+                ShowBodyFrame(bodies, shownIds, count, (const uint32_t*)column(TRAJ_ID), position, velocity, (const float*)column(TRAJ_MASS));
+            } else {
+                size_t first = target; // Decode from here. // Ab hier dekodieren.
+                if (!(decoded != SIZE_MAX && decoded < target && target - decoded <= (size_t)codec.keyframeInterval)) {
+                    while (first > 0 && !index[first].keyframe) --first; // Back to the keyframe. // Zurück zum Schlüsselframe.
+                } else {
+                    first = decoded + 1; // Continue the delta chain. // Delta-Kette fortsetzen.
+                }
+                for (size_t i = first; i <= target; ++i) {
+                    if (!codec.Decode(file.data + index[i].offset, index[i].frameBytes, snapshot)) { decoded = SIZE_MAX; return false; }
+                    decoded = i;
+                }
+                const double* position[3] = { snapshot.position[0].data(), snapshot.position[1].data(), snapshot.position[2].data() };
+                const double* velocity[3] = { snapshot.velocity[0].data(), snapshot.velocity[1].data(), snapshot.velocity[2].data() };
+                ShowBodyFrame(bodies, shownIds, snapshot.id.size(), snapshot.id.data(), position, velocity, snapshot.mass.data());
+            }
+            shown = target;
+            return true;
+        }
+
+    private:
+        MappedFile file; // Mapped recording. // Abgebildete Aufzeichnung.
+        TrajectoryCodec codec; // Decoder state for compressed frames. // Dekodiererzustand für komprimierte Frames.
+        TrajectorySnapshot snapshot; // Last decoded compressed frame. // Zuletzt dekodierter komprimierter Frame.
+        std::vector<uint32_t> shownIds; // Bodies currently in objs. // Aktuell in objs befindliche Körper.
+        size_t shown = SIZE_MAX; // Frame currently in objs. // Aktuell in objs befindlicher Frame.
+        size_t decoded = SIZE_MAX; // Last frame through the codec. // Letzter Frame durch den Codec.
+};
+
+TrajectoryReplay replay; // Recording playback, open if --replay is given. // Aufzeichnungswiedergabe, offen wenn --replay angegeben ist.
+
+/// Positioned File Class
+/// 
+/// Output file of known size that several threads fill at independent offsets (pwrite / overlapped WriteFile),
+/// so large arrays are written in parallel chunks without a shared file position or a lock.
+/// 
+/// EN: Writes a preallocated file from many threads.
+/// DE: Schreibt eine vorab angelegte Datei aus vielen Threads.
+class PositionedFile {
+    public:
+        PositionedFile() = default;
+        PositionedFile(const PositionedFile&) = delete;
+        PositionedFile& operator=(const PositionedFile&) = delete;
+        ~PositionedFile() { Close(); }
+
+        /// Creates the file
+        /// EN: Replaces any old file and sets its size; returns false on error
+        /// DE: Ersetzt eine alte Datei und setzt ihre Größe; gibt bei Fehler false zurück
+        bool Create(const std::string& path, uint64_t size) {
+            Close();
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER end; // New end of file. // Neues Dateiende.
+            end.QuadPart = (LONGLONG)size;
+            if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) { Close(); return false; }
+#else
+            fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) return false;
+            if (ftruncate(fd, (off_t)size) != 0) { Close(); return false; }
+#endif
+            return true;
+        }
+
+        /// Writes bytes at an offset
+        /// EN: Safe to call from several threads for disjoint ranges; returns false on error
+        /// DE: Sicher aus mehreren Threads für disjunkte Bereiche aufrufbar; gibt bei Fehler false zurück
+        bool WriteAt(uint64_t offset, const void* data, size_t size) {
+            const unsigned char* bytes = (const unsigned char*)data; // Remaining bytes. // Verbleibende Bytes.
+            while (size > 0) {
+#ifdef _WIN32
+                OVERLAPPED position{}; // Write offset. // Schreib-Offset.
+                position.Offset = (DWORD)offset;
+                position.OffsetHigh = (DWORD)(offset >> 32);
+                DWORD done = 0; // Bytes written by this call. // Von diesem Aufruf geschriebene Bytes.
+                if (!WriteFile(file, bytes, (DWORD)std::min<size_t>(size, 1 << 30), &done, &position) || done == 0) return false;
+#else
+                ssize_t done = pwrite(fd, bytes, size, (off_t)offset); // Bytes written by this call. // Von diesem Aufruf geschriebene Bytes.
+                if (done <= 0) return false;
+#endif
+                bytes += done; offset += (uint64_t)done; size -= (size_t)done;
+            }
+            return true;
+        }
+
+        void Close() {
+#ifdef _WIN32
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (fd >= 0) close(fd);
+            fd = -1;
+#endif
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE; // Open file. // Geöffnete Datei.
+#else
+        int fd = -1; // Open file descriptor. // Geöffneter Dateideskriptor.
+#endif
+};
+
+/// Snapshot Exporter Class
+/// 
+/// Writes snapshots for ParaView as XDMF: a small XML file describing the data and a raw binary file holding it.
+/// Bodies become a polyvertex grid with velocity, mass, radius and id; the spacetime grid becomes a structured surface whose
+/// heights come from UpdateGridVertices. Body arrays are converted and written in fixed chunks on all cores, never as text.
+/// A series file PREFIX.xmf lists all snapshots as a temporal collection, so ParaView opens the whole run at once.
+/// 
+/// EN: Exports bodies and the spacetime grid to XDMF plus raw binary.
+/// DE: Exportiert Körper und das Raumzeitgitter nach XDMF plus Rohbinärdaten.
+class SnapshotExporter {
+    public:
+        static constexpr size_t CHUNK_BODIES = 65536; // Bodies per write task. // Körper pro Schreibaufgabe.
+        std::string prefix = "snapshot"; // Output path without extension. // Ausgabepfad ohne Endung.
+        int every = 0; // Frames between automatic exports, 0 for F6 only. // Frames zwischen automatischen Exporten, 0 nur für F6.
+
+        /// Exports one snapshot
+        /// EN: Writes PREFIX_STEP.bin and PREFIX_STEP.xmf and rewrites the series file; returns false on error
+        /// DE: Schreibt PREFIX_STEP.bin und PREFIX_STEP.xmf und schreibt die Serien-Datei neu; gibt bei Fehler false zurück
+        bool Export(const SlotMap<Object>& bodies, uint64_t step, double time) {
+            auto start = std::chrono::steady_clock::now(); // Export timing. // Exportzeitmessung.
+            std::ostringstream name; // Snapshot file stem. // Dateistamm des Schnappschusses.
+            name << prefix << "_" << std::setw(8) << std::setfill('0') << step;
+            std::string binaryPath = name.str() + ".bin";
+            std::string binaryName = binaryPath.substr(binaryPath.find_last_of("/\\") + 1); // Relative to the XML files. // Relativ zu den XML-Dateien.
+
+            // Place bodies: count per fixed chunk, then prefix sums give each chunk its output range. // Körper platzieren: pro festem Block zählen, Präfixsummen ergeben dann den Ausgabebereich jedes Blocks.
+            size_t chunks = (bodies.size() + CHUNK_BODIES - 1) / CHUNK_BODIES; // Write tasks. // Schreibaufgaben.
+            std::vector<uint64_t> first(chunks + 1, 0); // Output index of each chunk. // Ausgabeindex jedes Blocks.
+            ParallelFor(bodies.size(), CHUNK_BODIES, [&](size_t begin, size_t end) {
+                uint64_t placed = 0; // Bodies that are part of the run. // Körper, die Teil des Laufs sind.
+                for (size_t i = begin; i < end; ++i) placed += bodies[i].Initalizing ? 0 : 1;
+                first[begin / CHUNK_BODIES + 1] = placed;
+            });
+            for (size_t chunk = 0; chunk < chunks; ++chunk) first[chunk + 1] += first[chunk];
+            uint64_t count = first[chunks]; // Exported bodies. // Exportierte Körper.
+
+            // Grid surface: one point per grid node, warped like the drawn grid. // Gitterfläche: ein Punkt pro Gitterknoten, verzerrt wie das gezeichnete Gitter.
+            int side = gridDivisions + 1; // Nodes per side. // Knoten pro Seite.
+            double cell = gridSize / gridDivisions, half = gridSize / 2.0; // Same layout as CreateGridVertices. // Gleiches Layout wie CreateGridVertices.
+            std::vector<double> grid; // x, y, z per node. // x, y, z pro Knoten.
+            grid.reserve(size_t(side) * side * 3);
+            for (int zStep = 0; zStep < side; ++zStep) {
+                for (int xStep = 0; xStep < side; ++xStep) grid.insert(grid.end(), { -half + xStep * cell, -half * 0.3 + 3 * cell, -half + zStep * cell });
+            }
+            grid = UpdateGridVertices(grid, bodies);
+            std::vector<double> height(size_t(side) * side); // Warped y per node. // Verzerrtes y pro Knoten.
+            for (size_t i = 0; i < height.size(); ++i) height[i] = grid[i * 3 + 1];
+
+            // Binary layout: one 64-byte aligned array after another. // Binärlayout: ein 64-Byte-ausgerichtetes Array nach dem anderen.
+            enum { POSITION, VELOCITY, MASS, RADIUS, ID, GRID, HEIGHT, ARRAYS };
+            const uint64_t elementSize[ARRAYS] = { 24, 24, 4, 4, 4, 24, 8 }; // Bytes per element. // Bytes pro Element.
+            const uint64_t elements[ARRAYS] = { count, count, count, count, count, height.size(), height.size() };
+            uint64_t offset[ARRAYS + 1] = {}; // Array starts, plus the file size. // Array-Anfänge, plus Dateigröße.
+            for (int array = 0; array < ARRAYS; ++array) offset[array + 1] = AlignUp(offset[array] + elements[array] * elementSize[array], 64);
+
+            PositionedFile file; // Binary heavy data. // Binäre Massendaten.
+            if (!file.Create(binaryPath, offset[ARRAYS])) {
+                std::cerr << "Cannot create export file: " << binaryPath << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            std::atomic<bool> failed{false}; // Any chunk write failed. // Ein Block-Schreibvorgang schlug fehl.
+            ParallelFor(bodies.size(), CHUNK_BODIES, [&](size_t begin, size_t end) {
+                std::vector<double> position, velocity; // Interleaved xyz. // Verschachteltes xyz.
+                std::vector<float> mass, radius;
+                std::vector<uint32_t> id;
+                position.reserve((end - begin) * 3); velocity.reserve((end - begin) * 3);
+                mass.reserve(end - begin); radius.reserve(end - begin); id.reserve(end - begin);
+                for (size_t i = begin; i < end; ++i) {
+                    const Object& body = bodies[i];
+                    if (body.Initalizing) continue; // Not part of the run yet. // Noch nicht Teil des Laufs.
+                    position.insert(position.end(), { body.position.x, body.position.y, body.position.z });
+                    velocity.insert(velocity.end(), { body.velocity.x, body.velocity.y, body.velocity.z });
+                    mass.push_back(body.mass);
+                    radius.push_back(body.radius);
+                    id.push_back(bodies.HandleAt(i).index);
+                }
+                uint64_t at = first[begin / CHUNK_BODIES]; // Output index of the chunk. // Ausgabeindex des Blocks.
+                bool ok = file.WriteAt(offset[POSITION] + at * elementSize[POSITION], position.data(), position.size() * sizeof(double))
+                    && file.WriteAt(offset[VELOCITY] + at * elementSize[VELOCITY], velocity.data(), velocity.size() * sizeof(double))
+                    && file.WriteAt(offset[MASS] + at * elementSize[MASS], mass.data(), mass.size() * sizeof(float))
+                    && file.WriteAt(offset[RADIUS] + at * elementSize[RADIUS], radius.data(), radius.size() * sizeof(float))
+                    && file.WriteAt(offset[ID] + at * elementSize[ID], id.data(), id.size() * sizeof(uint32_t));
+                if (!ok) failed.store(true, std::memory_order_relaxed);
+            });
+            bool ok = !failed.load() && file.WriteAt(offset[GRID], grid.data(), grid.size() * sizeof(double))
+                && file.WriteAt(offset[HEIGHT], height.data(), height.size() * sizeof(double));
+            file.Close();
+            if (!ok) {
+                std::cerr << "Export write failed: " << binaryPath << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+
+            // Light data: XML describing the binary arrays. // Leichte Daten: XML, das die Binär-Arrays beschreibt.
+            auto item = [&](int array, const char* type, int precision, const std::string& dimensions) {
+                std::ostringstream xml; // One DataItem. // Ein DataItem.
+                xml << "<DataItem Format=\"Binary\" Endian=\"Native\" NumberType=\"" << type << "\" Precision=\"" << precision
+                    << "\" Dimensions=\"" << dimensions << "\" Seek=\"" << offset[array] << "\">" << binaryName << "</DataItem>";
+                return xml.str();
+            };
+            std::string n = std::to_string(count), s = std::to_string(side); // Dimensions. // Dimensionen.
+            std::ostringstream grids; // Bodies and grid of this snapshot. // Körper und Gitter dieses Schnappschusses.
+            grids << std::setprecision(17)
+                  << "   <Grid Name=\"step " << step << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n"
+                  << "    <Time Value=\"" << time << "\"/>\n"
+                  << "    <Grid Name=\"bodies\" GridType=\"Uniform\">\n"
+                  << "     <Topology TopologyType=\"Polyvertex\" NumberOfElements=\"" << n << "\" NodesPerElement=\"1\"/>\n"
+                  << "     <Geometry GeometryType=\"XYZ\">" << item(POSITION, "Float", 8, n + " 3") << "</Geometry>\n"
+                  << "     <Attribute Name=\"velocity\" AttributeType=\"Vector\" Center=\"Node\">" << item(VELOCITY, "Float", 8, n + " 3") << "</Attribute>\n"
+                  << "     <Attribute Name=\"mass\" AttributeType=\"Scalar\" Center=\"Node\">" << item(MASS, "Float", 4, n) << "</Attribute>\n"
+                  << "     <Attribute Name=\"radius\" AttributeType=\"Scalar\" Center=\"Node\">" << item(RADIUS, "Float", 4, n) << "</Attribute>\n"
+                  << "     <Attribute Name=\"id\" AttributeType=\"Scalar\" Center=\"Node\">" << item(ID, "UInt", 4, n) << "</Attribute>\n"
+                  << "    </Grid>\n"
+                  << "    <Grid Name=\"spacetime\" GridType=\"Uniform\">\n"
+                  << "     <Topology TopologyType=\"2DSMesh\" Dimensions=\"" << s << " " << s << "\"/>\n"
+                  << "     <Geometry GeometryType=\"XYZ\">" << item(GRID, "Float", 8, s + " " + s + " 3") << "</Geometry>\n"
+                  << "     <Attribute Name=\"height\" AttributeType=\"Scalar\" Center=\"Node\">" << item(HEIGHT, "Float", 8, s + " " + s) << "</Attribute>\n"
+                  << "    </Grid>\n"
+                  << "   </Grid>\n";
+            series.push_back(grids.str());
+            bool written = WriteXdmf(name.str() + ".xmf", grids.str(), false) && WriteXdmf(prefix + ".xmf", Join(series), true);
+
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); // Export time. // Exportzeit.
+            std::cout << "Exported " << name.str() << ".xmf (" << count << " bodies, " << offset[ARRAYS] / (1024 * 1024) << " MiB, " << ms << " ms)" << std::endl; // Confirmation. // Bestätigung.
+            return written;
+        }
+
+    private:
+        std::vector<std::string> series; // Grid XML of every exported snapshot. // Gitter-XML jedes exportierten Schnappschusses.
+
+        static std::string Join(const std::vector<std::string>& parts) {
+            std::string joined; // Concatenation. // Verkettung.
+            for (const std::string& part : parts) joined += part;
+            return joined;
+        }
+
+        /// Writes an XDMF file
+        /// EN: Wraps snapshot grids in a domain, as a temporal collection for the series file
+        /// DE: Umhüllt Schnappschuss-Gitter mit einer Domain, als zeitliche Sammlung für die Serien-Datei
+        static bool WriteXdmf(const std::string& path, const std::string& grids, bool temporal) {
+            std::ofstream xml(path, std::ios::trunc); // Small text file. // Kleine Textdatei.
+            xml << "<?xml version=\"1.0\" ?>\n<Xdmf Version=\"3.0\">\n <Domain>\n";
+            if (temporal) xml << "  <Grid Name=\"run\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+            xml << grids;
+            if (temporal) xml << "  </Grid>\n";
+            xml << " </Domain>\n</Xdmf>\n";
+            if (!xml) std::cerr << "Cannot write " << path << std::endl; // Error message. // Fehlermeldung.
+            return (bool)xml;
+        }
+};
+
+SnapshotExporter exporter; // ParaView export, F6 or every --export-every frames. // ParaView-Export, F6 oder alle --export-every Frames.
+
+/// Conserved quantities of the placed bodies
+/// EN: SI units, momenta about the origin; the scales are sums of per-body magnitudes used to normalise drifts
+/// DE: SI-Einheiten, Impulse um den Ursprung; die Maßstäbe sind Summen der Beträge pro Körper zur Normierung der Drift
+struct ConservedQuantities {
+    size_t bodies = 0; // Bodies counted. // Gezählte Körper.
+    double kinetic = 0.0, potential = 0.0; // Energies in J. // Energien in J.
+    glm::dvec3 momentum = glm::dvec3(0.0); // Sum of m v. // Summe von m v.
+    glm::dvec3 angularMomentum = glm::dvec3(0.0); // Sum of r x m v. // Summe von r x m v.
+    double momentumScale = 0.0, angularScale = 0.0; // Sums of |m v| and |r x m v|. // Summen von |m v| und |r x m v|.
+
+    double Energy() const { return kinetic + potential; }
+    double Virial() const { return potential != 0.0 ? 2.0 * kinetic / -potential : 0.0; } // 1 in virial equilibrium. // 1 im Virialgleichgewicht.
+};
+
+/// Computes energy, momenta and virial ratio
+/// EN: Each chunk of bodies sums its kinetic terms and its half of the pair potential (j > i) on its own, and the chunk sums
+///     are added in order, so the result does not depend on the thread count. Costs half a force pass.
+/// DE: Jeder Block von Körpern summiert seine kinetischen Terme und seine Hälfte des Paarpotentials (j > i) für sich, und die
+///     Blocksummen werden der Reihe nach addiert, sodass das Ergebnis nicht von der Thread-Anzahl abhängt. Kostet einen halben Kraftdurchlauf.
+ConservedQuantities ComputeConservedQuantities(const SlotMap<Object>& bodies) {
+    const size_t grain = 64; // Bodies per chunk. // Körper pro Block.
+    size_t count = bodies.size(); // Dense bodies. // Dichte Körper.
+    std::vector<ConservedQuantities> partial((count + grain - 1) / grain); // One sum per chunk. // Eine Summe pro Block.
+    ParallelFor(count, grain, [&](size_t begin, size_t end) {
+        ConservedQuantities& sum = partial[begin / grain]; // This chunk. // Dieser Block.
+        for (size_t i = begin; i < end; ++i) {
+            const Object& body = bodies[i]; // Current body. // Aktueller Körper.
+            if (body.Initalizing) continue; // Not part of the run yet. // Noch nicht Teil des Laufs.
+            glm::dvec3 momentum = double(body.mass) * body.velocity; // m v. // m v.
+            glm::dvec3 angular = glm::cross(body.position, momentum); // r x m v. // r x m v.
+            ++sum.bodies;
+            sum.kinetic += 0.5 * glm::dot(momentum, body.velocity);
+            sum.momentum += momentum;
+            sum.angularMomentum += angular;
+            sum.momentumScale += glm::length(momentum);
+            sum.angularScale += glm::length(angular);
+            double potential = 0.0; // Pairs with later bodies. // Paare mit späteren Körpern.
+            for (size_t j = i + 1; j < count; ++j) {
+                if (bodies[j].Initalizing) continue;
+                double distance = glm::length(bodies[j].position - body.position); // Pair distance. // Paarabstand.
+                if (distance > 0.0) potential += double(bodies[j].mass) / distance;
+            }
+            sum.potential -= G * body.mass * potential;
+        }
+    });
+    ConservedQuantities total; // Ordered reduction. // Geordnete Reduktion.
+    for (const ConservedQuantities& sum : partial) {
+        total.bodies += sum.bodies;
+        total.kinetic += sum.kinetic;
+        total.potential += sum.potential;
+        total.momentum += sum.momentum;
+        total.angularMomentum += sum.angularMomentum;
+        total.momentumScale += sum.momentumScale;
+        total.angularScale += sum.angularScale;
+    }
+    return total;
+}
+
+/// Conservation Monitor Class
+/// 
+/// Every K completed steps computes the conserved quantities and appends them with their drift from the reference sample
+/// to conservation.log. The reference restarts when the body count changes or the step counter jumps (scene load,
+/// checkpoint restore), since user edits and restores legitimately change the totals.
+/// 
+/// EN: Cheap correctness check for long runs: a growing drift means the time step or the integrator is not good enough.
+/// DE: Günstige Korrektheitsprüfung für lange Läufe: eine wachsende Drift bedeutet, dass Zeitschritt oder Integrator nicht genügen.
+class ConservationMonitor {
+    public:
+        int every = 0; // Steps between samples, 0 = off. // Schritte zwischen Messungen, 0 = aus.
+        ConservedQuantities reference, latest; // First and newest sample. // Erste und neueste Messung.
+        double energyDrift = 0.0, momentumDrift = 0.0, angularDrift = 0.0; // Relative drifts of the newest sample. // Relative Drift der neuesten Messung.
+
+        /// Samples if a step boundary is due
+        /// EN: Call after stepCount was advanced; returns true if a sample was taken
+        /// DE: Aufrufen, nachdem stepCount erhöht wurde; gibt true zurück, wenn gemessen wurde
+        bool Update(const SlotMap<Object>& bodies, uint64_t step, double time) {
+            if (every <= 0 || step % every != 0) return false;
+            if (!log.is_open()) {
+                log.open("conservation.log"); // CSV like profile.log. // CSV wie profile.log.
+                log << "step,time,bodies,kinetic,potential,energy,energy drift,px,py,pz,momentum drift,Lx,Ly,Lz,angular momentum drift,virial ratio\n";
+            }
+            latest = ComputeConservedQuantities(bodies);
+            if (!hasReference || latest.bodies != reference.bodies || step != lastStep + every) {
+                reference = latest; // New baseline. // Neue Basis.
+                hasReference = true;
+            }
+            lastStep = step;
+            energyDrift = reference.Energy() != 0.0 ? std::abs(latest.Energy() - reference.Energy()) / std::abs(reference.Energy()) : 0.0;
+            momentumDrift = reference.momentumScale > 0.0 ? glm::length(latest.momentum - reference.momentum) / reference.momentumScale : 0.0;
+            angularDrift = reference.angularScale > 0.0 ? glm::length(latest.angularMomentum - reference.angularMomentum) / reference.angularScale : 0.0;
+            log << std::setprecision(10) << step << "," << time << "," << latest.bodies << "," << latest.kinetic << "," << latest.potential << "," << latest.Energy() << "," << energyDrift
+                << "," << latest.momentum.x << "," << latest.momentum.y << "," << latest.momentum.z << "," << momentumDrift
+                << "," << latest.angularMomentum.x << "," << latest.angularMomentum.y << "," << latest.angularMomentum.z << "," << angularDrift
+                << "," << latest.Virial() << "\n";
+            return true;
+        }
+
+        /// Flushes the log
+        /// EN: Prints the last drifts if any sample was taken
+        /// DE: Gibt die letzte Drift aus, wenn gemessen wurde
+        void Close() {
+            if (!log.is_open()) return;
+            log.close();
+            std::cout << "Conservation: energy drift " << energyDrift << ", momentum drift " << momentumDrift << ", angular momentum drift " << angularDrift
+                      << ", virial ratio " << latest.Virial() << " (conservation.log)" << std::endl; // Summary. // Zusammenfassung.
+        }
+
+    private:
+        std::ofstream log; // Sample log. // Mess-Log.
+        bool hasReference = false; // Baseline taken. // Basis aufgenommen.
+        uint64_t lastStep = 0; // Step of the newest sample. // Schritt der neuesten Messung.
+};
+
+ConservationMonitor conservation; // Energy and momentum checks every --diagnostics steps. // Energie- und Impulsprüfung alle --diagnostics Schritte.
+
+std::string publishName; // Shared-memory segment for external readers, if any. // Segment im gemeinsamen Speicher für externe Leser, falls vorhanden.
+SharedStatePublisher statePublisher; // Publishes every frame while open. // Veröffentlicht jeden Frame, solange geöffnet.
+
+/// Opens the shared-memory segment
+/// EN: Does nothing without --publish; sized for the current bodies, it grows when more are added
+/// DE: Tut ohne --publish nichts; für die aktuellen Körper bemessen, wächst es, wenn weitere hinzukommen
+bool OpenPublisher() {
+    if (publishName.empty()) return true;
+    if (!statePublisher.Open(publishName, objs.size())) {
+        std::cerr << "Cannot create shared-memory segment " << publishName << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    std::cout << "Publishing state to shared memory: " << publishName << std::endl; // Confirmation. // Bestätigung.
+    return true;
+}
+
+/// Publishes the current bodies
+/// EN: Copies positions, velocities, masses and ids into the next ring slot on all cores; readers in other processes pick it up without locks
+/// DE: Kopiert Positionen, Geschwindigkeiten, Massen und IDs auf allen Kernen in den nächsten Ring-Slot; Leser in anderen Prozessen übernehmen ihn ohne Sperren
+void PublishState() {
+    if (!statePublisher.IsOpen()) return;
+    statePublisher.Publish(objs.size(), stepCount, simTime, [](const SharedStateArrays& arrays) {
+        ParallelFor(objs.size(), 4096, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Object& obj = objs[i]; // Dense order. // Dichte Reihenfolge.
+                for (int c = 0; c < 3; ++c) {
+                    arrays.position[c][i] = obj.position[c];
+                    arrays.velocity[c][i] = obj.velocity[c];
+                }
+                arrays.mass[i] = obj.mass;
+                arrays.id[i] = objs.HandleAt(i).index;
+            }
+        });
+    });
+}
+
+/// Streaming protocol
+/// EN: Length-prefixed messages over TCP. The server sends STREAM_FAR and STREAM_NEAR payloads, each one compressed trajectory frame
+///     (TrajectoryCodec, one codec per kind and client); the client sends STREAM_CAMERA with its camera position once per displayed frame,
+///     which also asks for the next frame, so frames arrive at the client's display rate
+/// DE: Nachrichten mit Längenpräfix über TCP. Der Server sendet STREAM_FAR- und STREAM_NEAR-Nutzdaten, jeweils ein komprimierter Trajektorien-Frame
+///     (TrajectoryCodec, ein Codec pro Art und Client); der Client sendet einmal pro angezeigtem Frame STREAM_CAMERA mit seiner Kameraposition,
+///     was zugleich den nächsten Frame anfordert, sodass Frames mit der Bildrate des Clients ankommen
+const uint32_t streamMagic = 0x4D525453; // "STRM" in little-endian. // "STRM" in Little-Endian.
+
+enum StreamMessageKind {
+    STREAM_FAR, // All bodies, sent every farInterval frames; starts a new near set. // Alle Körper, alle farInterval Frames gesendet; beginnt eine neue Nah-Menge.
+    STREAM_NEAR, // Bodies nearest to the client camera, sent every frame. // Der Client-Kamera nächste Körper, jeden Frame gesendet.
+    STREAM_CAMERA // Client camera position (3 doubles) and frame request. // Kameraposition des Clients (3 Doubles) und Frame-Anforderung.
+};
+
+struct StreamMessageHeader {
+    uint32_t magic; // streamMagic. // streamMagic.
+    uint32_t kind; // StreamMessageKind. // StreamMessageKind.
+    uint64_t bytes; // Payload size. // Nutzdatengröße.
+};
+
+const uint64_t streamMaxMessageBytes = uint64_t(1) << 28; // Larger payloads drop the connection; fits a raw frame of over four million bodies. // Größere Nutzdaten trennen die Verbindung; fasst einen rohen Frame mit über vier Millionen Körpern.
+
+#ifdef _WIN32
+using SocketHandle = SOCKET; // Winsock socket. // Winsock-Socket.
+const SocketHandle invalidSocket = INVALID_SOCKET; // No socket. // Kein Socket.
+#else
+using SocketHandle = int; // File descriptor. // Dateideskriptor.
+const SocketHandle invalidSocket = -1; // No socket. // Kein Socket.
+#endif
+
+/// Socket helpers
+/// EN: Thin portable wrappers; SendSome and ReceiveSome never block and return 0 when the call would block, -1 on errors or a closed peer
+/// DE: Dünne portable Hüllen; SendSome und ReceiveSome blockieren nie und geben 0 zurück, wenn der Aufruf blockieren würde, -1 bei Fehlern oder geschlossener Gegenseite
+bool StartSockets() {
+#ifdef _WIN32
+    static bool started = false; // WSAStartup done. // WSAStartup erledigt.
+    WSADATA data; // Winsock version info. // Winsock-Versionsinfo.
+    if (!started) started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    return started;
+#else
+    return true;
+#endif
+}
+void CloseSocket(SocketHandle& socketHandle) {
+    if (socketHandle == invalidSocket) return;
+#ifdef _WIN32
+    closesocket(socketHandle);
+#else
+    close(socketHandle);
+#endif
+    socketHandle = invalidSocket;
+}
+void ConfigureSocket(SocketHandle socketHandle) {
+    int noDelay = 1; // Small camera messages must not wait for Nagle. // Kleine Kameranachrichten dürfen nicht auf Nagle warten.
+    setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+#ifdef _WIN32
+    u_long nonBlocking = 1; // Return instead of waiting. // Zurückkehren statt warten.
+    ioctlsocket(socketHandle, FIONBIO, &nonBlocking);
+#else
+    fcntl(socketHandle, F_SETFL, fcntl(socketHandle, F_GETFL, 0) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1; // macOS: report closed peers as errors. // macOS: geschlossene Gegenseiten als Fehler melden.
+    setsockopt(socketHandle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+#endif
+}
+bool SocketWouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+long SendSome(SocketHandle socketHandle, const unsigned char* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL; // Linux: no SIGPIPE on closed peers. // Linux: kein SIGPIPE bei geschlossenen Gegenseiten.
+#else
+    const int flags = 0;
+#endif
+    long sent = (long)send(socketHandle, (const char*)data, (int)std::min<size_t>(size, 1 << 30), flags); // Bytes accepted by the kernel. // Vom Kernel angenommene Bytes.
+    if (sent < 0) return SocketWouldBlock() ? 0 : -1;
+    return sent;
+}
+long ReceiveSome(SocketHandle socketHandle, unsigned char* data, size_t size) {
+    long received = (long)recv(socketHandle, (char*)data, (int)size, 0); // Bytes read. // Gelesene Bytes.
+    if (received < 0) return SocketWouldBlock() ? 0 : -1;
+    return received == 0 ? -1 : received; // 0 means the peer closed. // 0 bedeutet, die Gegenseite hat geschlossen.
+}
+
+/// Splits HOST:PORT
+/// EN: The host may be omitted ("PORT" or ":PORT"); returns false if the port is missing
+/// DE: Der Host darf fehlen ("PORT" oder ":PORT"); gibt false zurück, wenn der Port fehlt
+bool SplitAddress(const std::string& address, std::string& host, std::string& port) {
+    size_t colon = address.rfind(':'); // Last colon separates the port. // Letzter Doppelpunkt trennt den Port.
+    host = colon == std::string::npos ? "" : address.substr(0, colon);
+    port = colon == std::string::npos ? address : address.substr(colon + 1);
+    return !port.empty();
+}
+
+/// Appends one message
+/// EN: Header and payload go into the same outgoing buffer, so a frame is never interleaved with another
+/// DE: Header und Nutzdaten gehen in denselben Ausgangspuffer, sodass ein Frame nie mit einem anderen verschränkt wird
+void AppendStreamMessage(std::vector<unsigned char>& out, StreamMessageKind kind, const unsigned char* payload, size_t bytes) {
+    StreamMessageHeader header{ streamMagic, (uint32_t)kind, bytes }; // Message header. // Nachrichten-Header.
+    size_t start = out.size(); // Append position. // Anhängeposition.
+    out.resize(start + sizeof(header) + bytes);
+    std::memcpy(out.data() + start, &header, sizeof(header));
+    if (bytes) std::memcpy(out.data() + start + sizeof(header), payload, bytes);
+}
+
+/// Stream Server Class
+/// 
+/// Serves the running simulation to remote viewers. Each client gets its own near set: the bodies nearest to its camera are sent
+/// every frame, while the full body set goes out only every farInterval frames and the client extrapolates distant bodies with their
+/// velocities in between. Both streams go through their own TrajectoryCodec; the full set keeps its body order, so its frames stay
+/// quantized deltas even when the camera moves. The split adapts to the byte budget: farInterval is chosen so full frames take half
+/// of it, and the near set grows or shrinks to fill the other half. The far velocity grid is fine enough that rounding moves an
+/// extrapolated body by at most one position error over MAX_FAR_INTERVAL sent frames, measured in simulated time per frame.
+/// Sockets are non-blocking; a client that falls behind simply gets fewer frames, never stalls the simulation.
+/// 
+/// EN: Streams quantized, delta-coded snapshots with distance-based decimation to thin viewer clients.
+/// DE: Streamt quantisierte, deltakodierte Schnappschüsse mit entfernungsabhängiger Ausdünnung an schlanke Viewer-Clients.
+class StreamServer {
+    public:
+        static constexpr size_t MIN_NEAR = 256; // Smallest near set. // Kleinste Nah-Menge.
+        static constexpr int MAX_FAR_INTERVAL = 64; // Longest gap between far frames. // Längste Pause zwischen Fern-Frames.
+        double budget = 8.0e6; // Bytes per second per client. // Bytes pro Sekunde pro Client.
+        double positionError = 1.0e4; // Position error bound in m. // Positionsfehlergrenze in m.
+
+        bool IsOpen() const { return listener != invalidSocket; }
+
+        /// Starts listening
+        /// EN: address is [HOST:]PORT; without a host the server accepts connections on all interfaces
+        /// DE: address ist [HOST:]PORT; ohne Host nimmt der Server Verbindungen auf allen Schnittstellen an
+        bool Open(const std::string& address) {
+            std::string host, port; // Parts of the address. // Teile der Adresse.
+            addrinfo hints{}; // Passive IPv4 or IPv6 TCP. // Passives IPv4- oder IPv6-TCP.
+            addrinfo* result = nullptr; // Resolved addresses. // Aufgelöste Adressen.
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = AI_PASSIVE;
+            if (!StartSockets() || !SplitAddress(address, host, port) || getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0) {
+                std::cerr << "Invalid stream address: " << address << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            for (addrinfo* entry = result; entry && listener == invalidSocket; entry = entry->ai_next) {
+                listener = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+                if (listener == invalidSocket) continue;
+                int reuse = 1; // Restart without waiting for TIME_WAIT. // Neustart ohne auf TIME_WAIT zu warten.
+                setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+                if (bind(listener, entry->ai_addr, (int)entry->ai_addrlen) != 0 || listen(listener, 8) != 0) CloseSocket(listener);
+            }
+            freeaddrinfo(result);
+            if (listener == invalidSocket) {
+                std::cerr << "Cannot listen on " << address << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            ConfigureSocket(listener);
+            std::cout << "Streaming on " << address << " (budget " << budget / 1.0e6 << " MB/s per client)" << std::endl; // Confirmation. // Bestätigung.
+            return true;
+        }
+
+        /// Serves all clients
+        /// EN: Called once per simulated frame: accepts clients, reads camera updates, and encodes the frame for every client that asked for one
+        /// DE: Einmal pro simuliertem Frame aufgerufen: nimmt Clients an, liest Kamera-Updates und kodiert den Frame für jeden Client, der einen angefordert hat
+        void Update(const SlotMap<Object>& bodies, uint64_t step, double time) {
+            if (!IsOpen()) return;
+            for (SocketHandle accepted = accept(listener, nullptr, nullptr); accepted != invalidSocket; accepted = accept(listener, nullptr, nullptr)) {
+                ConfigureSocket(accepted);
+                clients.emplace_back();
+                Client& client = clients.back();
+                client.socketHandle = accepted;
+                client.camera = cameraPos; // Until the client reports its own. // Bis der Client seine eigene meldet.
+                for (TrajectoryCodec* codec : { &client.nearCodec, &client.farCodec }) {
+                    codec->positionQuantum = 2.0 * positionError; // Rounding error is half a step. // Rundungsfehler ist ein halber Schritt.
+                    codec->velocityQuantum = 2.0 * positionError / simTimeStep; // Near bodies are resent every frame; Encode tightens the far grid. // Nahe Körper werden jeden Frame neu gesendet; Encode verfeinert das Fern-Raster.
+                    codec->keyframeInterval = std::numeric_limits<int>::max(); // TCP is reliable; keyframes only on set changes. // TCP ist zuverlässig; Schlüsselframes nur bei Mengenänderungen.
+                }
+                std::cout << "Stream client connected (" << clients.size() << " total)" << std::endl; // Status. // Status.
+            }
+
+            for (size_t c = 0; c < clients.size();) {
+                Client& client = clients[c];
+                bool alive = Receive(client) && Flush(client); // Camera in, pending bytes out. // Kamera herein, ausstehende Bytes hinaus.
+                if (alive && client.requested && step != client.lastStep) {
+                    if (client.sent < client.outgoing.size()) {
+                        client.budgetScale = std::max(0.05, client.budgetScale * 0.9); // Link slower than the budget. // Verbindung langsamer als das Budget.
+                    } else {
+                        client.budgetScale = std::min(1.0, client.budgetScale * 1.01);
+                        Encode(client, bodies, step, time);
+                        client.requested = false;
+                        client.lastStep = step;
+                        alive = Flush(client);
+                    }
+                }
+                if (alive) { ++c; continue; }
+                CloseSocket(client.socketHandle);
+                clients.erase(clients.begin() + c);
+                std::cout << "Stream client disconnected (" << clients.size() << " left)" << std::endl; // Status. // Status.
+            }
+        }
+
+        void Close() {
+            for (Client& client : clients) CloseSocket(client.socketHandle);
+            clients.clear();
+            CloseSocket(listener);
+        }
+
+    private:
+        struct Client {
+            SocketHandle socketHandle = invalidSocket; // Connection. // Verbindung.
+            std::vector<unsigned char> outgoing; // Encoded messages not yet sent. // Noch nicht gesendete kodierte Nachrichten.
+            size_t sent = 0; // Bytes of outgoing already sent. // Bereits gesendete Bytes von outgoing.
+            std::vector<unsigned char> incoming; // Partial client messages. // Unvollständige Client-Nachrichten.
+            glm::dvec3 camera = glm::dvec3(0.0); // Client camera position. // Kameraposition des Clients.
+            bool requested = false; // Client displayed a frame since the last send. // Client hat seit dem letzten Senden einen Frame angezeigt.
+            uint64_t lastStep = UINT64_MAX; // Step sent last; every step is sent at most once. // Zuletzt gesendeter Schritt; jeder Schritt wird höchstens einmal gesendet.
+            double lastTime = 0.0; // Simulated time of the last frame. // Simulierte Zeit des letzten Frames.
+            double frameSimTime = 0.0; // Decaying maximum of simulated seconds between sent frames. // Abklingendes Maximum der simulierten Sekunden zwischen gesendeten Frames.
+            TrajectoryCodec nearCodec, farCodec; // Delta state per set. // Delta-Zustand pro Menge.
+            std::vector<uint32_t> nearDense, farDense; // Near set and all placed bodies as dense indices. // Nah-Menge und alle platzierten Körper als dichte Indizes.
+            std::vector<uint32_t> nearId, farId; // Their slot ids, to detect changed bodies. // Deren Slot-IDs, um geänderte Körper zu erkennen.
+            size_t nearCount = 4096; // Target near set size. // Zielgröße der Nah-Menge.
+            int farInterval = 4; // Frames between far frames. // Frames zwischen Fern-Frames.
+            int sinceFar = 0; // Frames since the last far frame, 0 forces one. // Frames seit dem letzten Fern-Frame, 0 erzwingt einen.
+            double nearBytes = 0.0; // Average bytes of a near frame. // Durchschnittliche Bytes eines Near-Frames.
+            double farBytes = 0.0; // Bytes of the last far frame. // Bytes des letzten Fern-Frames.
+            double frameRate = 60.0; // Average frames per second sent. // Durchschnittlich gesendete Frames pro Sekunde.
+            double budgetScale = 1.0; // Shrinks while the link cannot keep up. // Schrumpft, solange die Verbindung nicht mithält.
+            std::chrono::steady_clock::time_point lastSend = std::chrono::steady_clock::now(); // Time of the last frame. // Zeit des letzten Frames.
+        };
+        SocketHandle listener = invalidSocket; // Listening socket. // Lauschender Socket.
+        std::vector<Client> clients; // Connected viewers. // Verbundene Viewer.
+        std::vector<unsigned char> raw, encoded; // Scratch frames. // Arbeits-Frames.
+
+        /// Reads client messages
+        /// EN: Keeps the newest camera position; returns false if the client disconnected or sent garbage
+        /// DE: Behält die neueste Kameraposition; gibt false zurück, wenn der Client getrennt hat oder Unsinn sendete
+        static bool Receive(Client& client) {
+            unsigned char buffer[4096]; // Receive chunk. // Empfangsblock.
+            for (long received = ReceiveSome(client.socketHandle, buffer, sizeof(buffer)); received != 0; received = ReceiveSome(client.socketHandle, buffer, sizeof(buffer))) {
+                if (received < 0 || client.incoming.size() > streamMaxMessageBytes) return false; // Camera messages never pile up this far. // Kameranachrichten stauen sich nie so weit.
+                client.incoming.insert(client.incoming.end(), buffer, buffer + received);
+            }
+            size_t offset = 0; // Parse position. // Parse-Position.
+            StreamMessageHeader header; // Current message. // Aktuelle Nachricht.
+            while (client.incoming.size() - offset >= sizeof(header)) {
+                std::memcpy(&header, client.incoming.data() + offset, sizeof(header));
+                if (header.magic != streamMagic || header.kind != STREAM_CAMERA || header.bytes != sizeof(double) * 3) return false;
+                if (client.incoming.size() - offset < sizeof(header) + header.bytes) break;
+                std::memcpy(&client.camera[0], client.incoming.data() + offset + sizeof(header), sizeof(double) * 3);
+                client.requested = true;
+                offset += sizeof(header) + header.bytes;
+            }
+            client.incoming.erase(client.incoming.begin(), client.incoming.begin() + offset);
+            return true;
+        }
+
+        /// Sends pending bytes
+        /// EN: Returns false if the connection failed
+        /// DE: Gibt false zurück, wenn die Verbindung fehlschlug
+        static bool Flush(Client& client) {
+            while (client.sent < client.outgoing.size()) {
+                long sent = SendSome(client.socketHandle, client.outgoing.data() + client.sent, client.outgoing.size() - client.sent);
+                if (sent < 0) return false;
+                if (sent == 0) return true; // Kernel buffer full. // Kernel-Puffer voll.
+                client.sent += (size_t)sent;
+            }
+            client.outgoing.clear();
+            client.sent = 0;
+            return true;
+        }
+
+        /// Chooses the near set
+        /// EN: The nearCount bodies closest to the client camera become the near set; the far set holds all placed bodies. Both stay in dense order, so ids mostly ascend
+        /// DE: Die nearCount der Client-Kamera nächsten Körper bilden die Nah-Menge; die Fern-Menge enthält alle platzierten Körper. Beide bleiben in dichter Reihenfolge, sodass IDs meist steigen
+        static void Split(Client& client, const SlotMap<Object>& bodies) {
+            std::vector<std::pair<double, uint32_t>> distance; // Squared camera distance and dense index. // Quadrierter Kameraabstand und dichter Index.
+            distance.reserve(bodies.size());
+            for (size_t dense = 0; dense < bodies.size(); ++dense) {
+                if (bodies[dense].Initalizing) continue; // Not part of the run yet. // Noch nicht Teil des Laufs.
+                glm::dvec3 offset = bodies[dense].position - client.camera; // Camera to body. // Kamera zum Körper.
+                distance.emplace_back(glm::dot(offset, offset), (uint32_t)dense);
+            }
+            size_t nearCount = std::min(client.nearCount, distance.size()); // Bodies sent every frame. // Jeden Frame gesendete Körper.
+            std::nth_element(distance.begin(), distance.begin() + nearCount, distance.end());
+            client.nearDense.clear();
+            client.farDense.clear();
+            for (size_t i = 0; i < distance.size(); ++i) {
+                if (i < nearCount) client.nearDense.push_back(distance[i].second);
+                client.farDense.push_back(distance[i].second);
+            }
+            std::sort(client.nearDense.begin(), client.nearDense.end());
+            std::sort(client.farDense.begin(), client.farDense.end());
+            client.nearId.clear();
+            client.farId.clear();
+            for (uint32_t dense : client.nearDense) client.nearId.push_back(bodies.HandleAt(dense).index);
+            for (uint32_t dense : client.farDense) client.farId.push_back(bodies.HandleAt(dense).index);
+        }
+
+        /// Checks that a split still names the same bodies
+        /// EN: Removals and merges move bodies within the dense array
+        /// DE: Entfernen und Verschmelzen verschieben Körper im dichten Array
+        static bool SplitValid(const std::vector<uint32_t>& dense, const std::vector<uint32_t>& id, const SlotMap<Object>& bodies) {
+            for (size_t i = 0; i < dense.size(); ++i) {
+                if (dense[i] >= bodies.size() || bodies.HandleAt(dense[i]).index != id[i]) return false;
+            }
+            return true;
+        }
+
+        /// Builds a raw trajectory frame for a subset of the bodies
+        /// EN: Same layout as TrajectoryWriter::Capture, ready for TrajectoryCodec::Encode
+        /// DE: Gleiches Layout wie TrajectoryWriter::Capture, bereit für TrajectoryCodec::Encode
+        static void Pack(const SlotMap<Object>& bodies, const std::vector<uint32_t>& dense, uint64_t step, double time, std::vector<unsigned char>& frame) {
+            TrajectoryFrameHeader header{}; // Frame header. // Frame-Header.
+            header.magic = trajectoryFrameMagic;
+            header.headerSize = sizeof(TrajectoryFrameHeader);
+            header.step = step;
+            header.simTime = time;
+            header.bodyCount = dense.size();
+            header.codec = TRAJ_CODEC_RAW;
+            header.keyframe = 1;
+            uint64_t offset = AlignUp(sizeof(TrajectoryFrameHeader), 64); // Next free byte. // Nächstes freies Byte.
+            for (int array = 0; array < TRAJ_ARRAY_COUNT; ++array) {
+                header.arrayOffset[array] = offset;
+                offset = AlignUp(offset + dense.size() * trajectoryElementSize[array], 64);
+            }
+            header.frameBytes = offset;
+            frame.resize(offset);
+            std::memcpy(frame.data(), &header, sizeof(TrajectoryFrameHeader));
+            auto column = [&](int array) { return frame.data() + header.arrayOffset[array]; };
+            uint32_t* id = (uint32_t*)column(TRAJ_ID);
+            double* component[6]; // Positions and velocities. // Positionen und Geschwindigkeiten.
+            for (int c = 0; c < 6; ++c) component[c] = (double*)column(TRAJ_POS_X + c);
+            float* mass = (float*)column(TRAJ_MASS);
+            ParallelFor(dense.size(), 65536, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const Object& body = bodies[dense[i]];
+                    id[i] = bodies.HandleAt(dense[i]).index;
+                    for (int c = 0; c < 3; ++c) {
+                        component[c][i] = body.position[c];
+                        component[3 + c][i] = body.velocity[c];
+                    }
+                    mass[i] = body.mass;
+                }
+            });
+        }
+
+        /// Encodes one frame for a client
+        /// EN: Sends all bodies and picks a new near set when due or when the bodies changed, always sends the near set, then adapts both to the budget
+        /// DE: Sendet alle Körper und wählt eine neue Nah-Menge, wenn fällig oder wenn sich die Körper geändert haben, sendet immer die Nah-Menge und passt dann beide an das Budget an
+        void Encode(Client& client, const SlotMap<Object>& bodies, uint64_t step, double time) {
+            auto now = std::chrono::steady_clock::now(); // Send time. // Sendezeit.
+            double interval = std::chrono::duration<double>(now - client.lastSend).count(); // Since the last frame. // Seit dem letzten Frame.
+            client.lastSend = now;
+            if (interval > 0.0) client.frameRate = 0.9 * client.frameRate + 0.1 * std::min(1.0 / interval, 240.0);
+            if (client.lastStep != UINT64_MAX) client.frameSimTime = std::max(0.99 * client.frameSimTime, std::abs(time - client.lastTime)); // Slow clients skip steps. // Langsame Clients überspringen Schritte.
+            client.lastTime = time;
+
+            size_t placed = 0; // Bodies that belong in a split. // Körper, die in eine Aufteilung gehören.
+            for (const Object& body : bodies) placed += body.Initalizing ? 0 : 1;
+            // Velocity rounding moves an extrapolated body by quantum / 2 per simulated second, for up to MAX_FAR_INTERVAL frames. // Geschwindigkeitsrundung verschiebt einen extrapolierten Körper um Raster / 2 pro simulierter Sekunde, für bis zu MAX_FAR_INTERVAL Frames.
+            double span = MAX_FAR_INTERVAL * std::max(client.frameSimTime, simTimeStep); // Longest extrapolation. // Längste Extrapolation.
+            double quantum = std::exp2(std::floor(std::log2(2.0 * positionError / span))); // Power of two, so it rarely changes. // Zweierpotenz, damit es sich selten ändert.
+            bool refresh = client.sinceFar == 0 || client.farDense.size() != placed // Bodies added or removed. // Körper hinzugefügt oder entfernt.
+                || !SplitValid(client.farDense, client.farId, bodies) // Near bodies are a subset. // Nahe Körper sind eine Teilmenge.
+                || quantum < client.farCodec.velocityQuantum; // Frames grew further apart than the far grid allows. // Frames liegen weiter auseinander, als das Fern-Raster erlaubt.
+            if (refresh) {
+                if (quantum != client.farCodec.velocityQuantum) {
+                    client.farCodec.velocityQuantum = quantum;
+                    client.farCodec.Reset(); // Deltas need the same grid. // Deltas brauchen dasselbe Raster.
+                }
+                Split(client, bodies);
+                Pack(bodies, client.farDense, step, time, raw);
+                client.farCodec.Encode(raw.data(), encoded);
+                AppendStreamMessage(client.outgoing, STREAM_FAR, encoded.data(), encoded.size());
+                client.farBytes = (double)encoded.size();
+                client.sinceFar = 0;
+            }
+            Pack(bodies, client.nearDense, step, time, raw);
+            client.nearCodec.Encode(raw.data(), encoded);
+            AppendStreamMessage(client.outgoing, STREAM_NEAR, encoded.data(), encoded.size());
+            client.nearBytes = client.nearBytes > 0.0 ? 0.8 * client.nearBytes + 0.2 * encoded.size() : (double)encoded.size(); // Includes keyframes after re-splits. // Enthält Schlüsselframes nach Neuaufteilungen.
+            if (++client.sinceFar >= client.farInterval) client.sinceFar = 0;
+
+            // Half of the per-frame budget for each set. // Die Hälfte des Budgets pro Frame für jede Menge.
+            double half = 0.5 * budget * client.budgetScale / std::max(client.frameRate, 1.0); // Bytes per frame. // Bytes pro Frame.
+            client.farInterval = client.nearDense.size() == client.farDense.size() ? MAX_FAR_INTERVAL : (int)glm::clamp(std::ceil(client.farBytes / half), 1.0, (double)MAX_FAR_INTERVAL);
+            double bytesPerBody = client.nearBytes / std::max<size_t>(client.nearDense.size(), 1); // Near cost per body. // Nah-Kosten pro Körper.
+            double fit = bytesPerBody > 0.0 ? half / bytesPerBody : (double)bodies.size(); // Near bodies within budget. // Nahe Körper innerhalb des Budgets.
+            client.nearCount = (size_t)glm::clamp(0.8 * client.nearCount + 0.2 * fit, (double)MIN_NEAR, (double)std::max<size_t>(bodies.size(), MIN_NEAR));
+        }
+};
+
+/// Stream Client Class
+/// 
+/// Thin viewer side: sends its camera every displayed frame, decodes near and far frames with its own codecs and merges them
+/// into the bodies: the far frame supplies every body, moved along its velocity to the time of the near frame, and near bodies
+/// overwrite theirs. Bodies keep the far frame's order, so they are only recreated when the server's body set changes.
+/// 
+/// EN: Connects the viewer to a --serve simulation instead of simulating locally.
+/// DE: Verbindet den Viewer mit einer --serve-Simulation, statt lokal zu simulieren.
+class StreamClient {
+    public:
+        uint64_t step = 0; // stepCount of the shown frame. // stepCount des angezeigten Frames.
+        double simTime = 0.0; // Simulated seconds of the shown frame. // Simulierte Sekunden des angezeigten Frames.
+        double bytesPerSecond = 0.0; // Average received rate. // Durchschnittliche Empfangsrate.
+
+        bool IsOpen() const { return socketHandle != invalidSocket; }
+        size_t NearBodies() const { return nearFrame.id.size(); }
+        size_t Bodies() const { return farFrame.id.size(); }
+
+        /// Connects to a server
+        /// EN: address is HOST:PORT; blocks until connected, then switches to non-blocking I/O
+        /// DE: address ist HOST:PORT; blockiert bis zur Verbindung und wechselt dann zu nicht blockierender Ein-/Ausgabe
+        bool Connect(const std::string& address) {
+            std::string host, port; // Parts of the address. // Teile der Adresse.
+            addrinfo hints{}; // IPv4 or IPv6 TCP. // IPv4- oder IPv6-TCP.
+            addrinfo* result = nullptr; // Resolved addresses. // Aufgelöste Adressen.
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            if (!StartSockets() || !SplitAddress(address, host, port) || getaddrinfo(host.empty() ? "localhost" : host.c_str(), port.c_str(), &hints, &result) != 0) {
+                std::cerr << "Invalid stream address: " << address << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            for (addrinfo* entry = result; entry && socketHandle == invalidSocket; entry = entry->ai_next) {
+                socketHandle = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+                if (socketHandle != invalidSocket && connect(socketHandle, entry->ai_addr, (int)entry->ai_addrlen) != 0) CloseSocket(socketHandle);
+            }
+            freeaddrinfo(result);
+            if (socketHandle == invalidSocket) {
+                std::cerr << "Cannot connect to " << address << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+            ConfigureSocket(socketHandle);
+            nearCodec.Reset();
+            farCodec.Reset();
+            nearFrame = farFrame = TrajectorySnapshot();
+            haveNear = haveFar = false;
+            lastRate = std::chrono::steady_clock::now();
+            std::cout << "Connected to " << address << std::endl; // Confirmation. // Bestätigung.
+            return true;
+        }
+
+        /// Exchanges one frame
+        /// EN: Sends the camera, decodes everything that arrived and shows the newest complete state; returns true if the bodies changed.
+        ///     Closes the connection if the server went away or sent a malformed or oversized message
+        /// DE: Sendet die Kamera, dekodiert alles Angekommene und zeigt den neuesten vollständigen Zustand; gibt true zurück, wenn sich die Körper geändert haben.
+        ///     Schließt die Verbindung, wenn der Server weg ist oder eine fehlerhafte oder übergroße Nachricht sendete
+        bool Update(SlotMap<Object>& bodies, const glm::dvec3& camera) {
+            if (!IsOpen()) return false;
+            std::vector<unsigned char> request; // Camera message. // Kameranachricht.
+            AppendStreamMessage(request, STREAM_CAMERA, (const unsigned char*)&camera[0], sizeof(double) * 3);
+            bool alive = SendSome(socketHandle, request.data(), request.size()) >= 0; // Dropped if the socket is full; the next frame asks again. // Verworfen, wenn der Socket voll ist; der nächste Frame fragt erneut.
+
+            unsigned char buffer[65536]; // Receive chunk. // Empfangsblock.
+            long received = 0; // Bytes of the last read. // Bytes des letzten Lesens.
+            while (alive && incoming.size() <= sizeof(StreamMessageHeader) + streamMaxMessageBytes && (received = ReceiveSome(socketHandle, buffer, sizeof(buffer))) != 0) { // Rest stays in the socket until parsed. // Rest bleibt bis zum Parsen im Socket.
+                if (received < 0) { alive = false; break; }
+                incoming.insert(incoming.end(), buffer, buffer + received);
+                windowBytes += (uint64_t)received;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastRate).count(); // Rate window. // Ratenfenster.
+            if (elapsed >= 1.0) {
+                bytesPerSecond = windowBytes / elapsed;
+                windowBytes = 0;
+                lastRate = std::chrono::steady_clock::now();
+            }
+
+            bool changed = false; // New state decoded. // Neuer Zustand dekodiert.
+            size_t offset = 0; // Parse position. // Parse-Position.
+            StreamMessageHeader header; // Current message. // Aktuelle Nachricht.
+            while (alive && incoming.size() - offset >= sizeof(header)) {
+                std::memcpy(&header, incoming.data() + offset, sizeof(header));
+                if (header.magic != streamMagic || (header.kind != STREAM_NEAR && header.kind != STREAM_FAR) || header.bytes > streamMaxMessageBytes) { alive = false; break; }
+                if (incoming.size() - offset - sizeof(header) < header.bytes) break; // Rest still in flight. // Rest noch unterwegs.
+                const unsigned char* payload = incoming.data() + offset + sizeof(header); // Encoded frame. // Kodierter Frame.
+                bool far = header.kind == STREAM_FAR; // Which set. // Welche Menge.
+                if (!(far ? farCodec : nearCodec).Decode(payload, header.bytes, far ? farFrame : nearFrame)) { alive = false; break; }
+                (far ? haveFar : haveNear) = true;
+                if (far) farSlot.clear(); // Rebuilt in Merge. // In Merge neu aufgebaut.
+                changed = true;
+                offset += sizeof(header) + header.bytes;
+            }
+            incoming.erase(incoming.begin(), incoming.begin() + offset);
+            if (!alive) {
+                std::cerr << "Stream server disconnected" << std::endl; // Status. // Status.
+                CloseSocket(socketHandle);
+            }
+            if (!changed || !haveNear || !haveFar || nearFrame.step < farFrame.step) return false; // Near frame of a new split still in flight. // Nah-Frame einer neuen Aufteilung noch unterwegs.
+            Merge(bodies);
+            return true;
+        }
+
+        void Close() { CloseSocket(socketHandle); }
 
-        glm::vec3 LastPos = position; // Previous position (unused). // Vorherige Position (unbenutzt).
-        bool glow; // Whether object should glow. // Ob Objekt leuchten soll.
+    private:
+        SocketHandle socketHandle = invalidSocket; // Connection. // Verbindung.
+        std::vector<unsigned char> incoming; // Received bytes not yet parsed. // Empfangene, noch nicht geparste Bytes.
+        TrajectoryCodec nearCodec, farCodec; // Delta state per set. // Delta-Zustand pro Menge.
+        TrajectorySnapshot nearFrame, farFrame; // Latest decoded frames. // Zuletzt dekodierte Frames.
+        bool haveNear = false, haveFar = false; // Both sets received once. // Beide Mengen einmal empfangen.
+        std::vector<uint32_t> farSlot; // Far frame index per slot id, UINT32_MAX if absent. // Fern-Frame-Index pro Slot-ID, UINT32_MAX wenn nicht vorhanden.
+        TrajectorySnapshot merged; // Bodies handed to ShowBodyFrame. // An ShowBodyFrame übergebene Körper.
+        std::vector<uint32_t> shownIds; // Bodies currently in objs. // Aktuell in objs befindliche Körper.
+        uint64_t windowBytes = 0; // Bytes in the current rate window. // Bytes im aktuellen Ratenfenster.
+        std::chrono::steady_clock::time_point lastRate; // Start of the rate window. // Beginn des Ratenfensters.
 
-        /// Constructor for creating a new gravitational object
-        /// EN: Initializes object with physical properties and generates sphere mesh
-        /// DE: Initialisiert Objekt mit physikalischen Eigenschaften und generiert Kugel-Mesh
-        Object(glm::vec3 initPosition, glm::vec3 initVelocity, float mass, float density = 3344, glm::vec4 color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f), bool Glow = false) {   
-            this->position = initPosition; // Set initial position. // Setze Anfangsposition.
-            this->velocity = initVelocity; // Set initial velocity. // Setze Anfangsgeschwindigkeit.
-            this->mass = mass; // Set object mass. // Setze Objektmasse.
-            this->density = density; // Set material density. // Setze Materialdichte.
-            this->radius = pow(((3 * this->mass/this->density)/(4 * 3.14159265359)), (1.0f/3.0f)) / sizeRatio; // Calculate radius from mass and density. // Berechne Radius aus Masse und Dichte.
-            this->color = color; // Set object color. // Setze Objektfarbe.
-            this->glow = Glow; // Set glow effect. // Setze Leuchteffekt.
-            
-            std::vector<float> vertices = Draw(); // Generate sphere vertices. // Generiere Kugel-Vertices.
-            vertexCount = vertices.size(); // Store vertex count. // Speichere Vertex-Anzahl.
-
-            CreateVBOVAO(VAO, VBO, vertices.data(), vertexCount); // Create OpenGL buffers. // Erstelle OpenGL-Buffer.
-        }
-
-        /// Generates sphere mesh vertices
-        /// EN: Creates triangulated sphere using spherical coordinates
-        /// DE: Erstellt triangulierte Kugel mit sphärischen Koordinaten
-        std::vector<float> Draw() {
-            std::vector<float> vertices; // Vertex data container. // Vertex-Daten-Container.
-            int stacks = 10; // Horizontal subdivisions. // Horizontale Unterteilungen.
-            int sectors = 10; // Vertical subdivisions. // Vertikale Unterteilungen.
-
-            // Generate sphere triangles. // Generiere Kugel-Dreiecke.
-            for(float i = 0.0f; i <= stacks; ++i){
-                float theta1 = (i / stacks) * glm::pi<float>(); // Current latitude angle. // Aktueller Breitengrad-Winkel.
-                float theta2 = (i+1) / stacks * glm::pi<float>(); // Next latitude angle. // Nächster Breitengrad-Winkel.
-                for (float j = 0.0f; j < sectors; ++j){
-                    float phi1 = j / sectors * 2 * glm::pi<float>(); // Current longitude angle. // Aktueller Längengrad-Winkel.
-                    float phi2 = (j+1) / sectors * 2 * glm::pi<float>(); // Next longitude angle. // Nächster Längengrad-Winkel.
-                    
-                    // Convert spherical to Cartesian coordinates. // Konvertiere sphärische zu kartesischen Koordinaten.
-                    glm::vec3 v1 = sphericalToCartesian(this->radius, theta1, phi1);
-                    glm::vec3 v2 = sphericalToCartesian(this->radius, theta1, phi2);
-                    glm::vec3 v3 = sphericalToCartesian(this->radius, theta2, phi1);
-                    glm::vec3 v4 = sphericalToCartesian(this->radius, theta2, phi2);
-
-                    // Triangle 1: v1-v2-v3. // Dreieck 1: v1-v2-v3.
-                    vertices.insert(vertices.end(), {v1.x, v1.y, v1.z});
-                    vertices.insert(vertices.end(), {v2.x, v2.y, v2.z});
-                    vertices.insert(vertices.end(), {v3.x, v3.y, v3.z});
-                    
-                    // Triangle 2: v2-v4-v3. // Dreieck 2: v2-v4-v3.
-                    vertices.insert(vertices.end(), {v2.x, v2.y, v2.z});
-                    vertices.insert(vertices.end(), {v4.x, v4.y, v4.z});
-                    vertices.insert(vertices.end(), {v3.x, v3.y, v3.z});
-                }   
-            }
-            return vertices; // Return generated vertices. // Gebe generierte Vertices zurück.
-        }
-        
-        /// Updates object position based on velocity
-        /// EN: Integrates velocity to update position with fixed timestep
-        /// DE: Integriert Geschwindigkeit zur Positionsaktualisierung mit festem Zeitschritt
-        void UpdatePos(){
-            this->position[0] += this->velocity[0] / 94; // Update X position. // Aktualisiere X-Position.
-            this->position[1] += this->velocity[1] / 94; // Update Y position. // Aktualisiere Y-Position.
-            this->position[2] += this->velocity[2] / 94; // Update Z position. // Aktualisiere Z-Position.
-            this->radius = pow(((3 * this->mass/this->density)/(4 * 3.14159265359)), (1.0f/3.0f)) / sizeRatio; // Recalculate radius. // Berechne Radius neu.
-        }
-        
-        /// Updates vertex buffer with new sphere data
-        /// EN: Regenerates sphere mesh when radius changes
-        /// DE: Regeneriert Kugel-Mesh wenn sich Radius ändert
-        void UpdateVertices() {
-            std::vector<float> vertices = Draw(); // Generate new vertices. // Generiere neue Vertices.
-            
-            glBindBuffer(GL_ARRAY_BUFFER, VBO); // Bind vertex buffer. // Binde Vertex-Buffer.
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW); // Upload new data. // Lade neue Daten hoch.
-        }
-        
-        /// Returns current position
-        /// EN: Getter for object position
-        /// DE: Getter für Objektposition
-        glm::vec3 GetPos() const {
-            return this->position;
-        }
-        
-        /// Applies acceleration to velocity
-        /// EN: Updates velocity based on forces with timestep integration
-        /// DE: Aktualisiert Geschwindigkeit basierend auf Kräften mit Zeitschritt-Integration
-        void accelerate(float x, float y, float z){
-            this->velocity[0] += x / 96; // Apply X acceleration. // Wende X-Beschleunigung an.
-            this->velocity[1] += y / 96; // Apply Y acceleration. // Wende Y-Beschleunigung an.
-            this->velocity[2] += z / 96; // Apply Z acceleration. // Wende Z-Beschleunigung an.
-        }
-        
-        /// Checks collision with another object
-        /// EN: Returns velocity damping factor if objects collide
-        /// DE: Gibt Geschwindigkeitsdämpfungsfaktor zurück wenn Objekte kollidieren
-        float CheckCollision(const Object& other) {
-            float dx = other.position[0] - this->position[0]; // X distance. // X-Abstand.
-            float dy = other.position[1] - this->position[1]; // Y distance. // Y-Abstand.
-            float dz = other.position[2] - this->position[2]; // Z distance. // Z-Abstand.
-            float distance = std::pow(dx*dx + dy*dy + dz*dz, (1.0f/2.0f)); // Calculate Euclidean distance. // Berechne euklidischen Abstand.
-            if (other.radius + this->radius > distance){ // Check if spheres overlap. // Prüfe ob Kugeln überlappen.
-                return -0.2f; // Return damping factor. // Gebe Dämpfungsfaktor zurück.
+        /// Combines near and far bodies
+        /// EN: Far bodies are extrapolated linearly from their frame to the near frame's time; near bodies replace theirs
+        /// DE: Ferne Körper werden linear von ihrem Frame auf die Zeit des Nah-Frames extrapoliert; nahe Körper ersetzen ihre
+        void Merge(SlotMap<Object>& bodies) {
+            size_t count = farFrame.id.size(); // All bodies. // Alle Körper.
+            if (farSlot.empty()) {
+                uint32_t maxId = 0; // Largest slot id. // Größte Slot-ID.
+                for (uint32_t id : farFrame.id) maxId = std::max(maxId, id);
+                farSlot.assign((size_t)maxId + 1, UINT32_MAX);
+                for (size_t i = 0; i < count; ++i) farSlot[farFrame.id[i]] = (uint32_t)i;
             }
-            return 1.0f; // No collision. // Keine Kollision.
+
+            double drift = nearFrame.simTime - farFrame.simTime; // Far frame age. // Alter des Fern-Frames.
+            merged.mass = farFrame.mass;
+            for (int c = 0; c < 3; ++c) merged.velocity[c] = farFrame.velocity[c];
+            for (int c = 0; c < 3; ++c) merged.position[c].resize(count);
+            ParallelFor(count, 65536, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    for (int c = 0; c < 3; ++c) merged.position[c][i] = farFrame.position[c][i] + farFrame.velocity[c][i] * drift;
+                }
+            });
+            for (size_t j = 0; j < nearFrame.id.size(); ++j) {
+                uint32_t i = nearFrame.id[j] < farSlot.size() ? farSlot[nearFrame.id[j]] : UINT32_MAX; // Same body in the far frame. // Derselbe Körper im Fern-Frame.
+                if (i == UINT32_MAX) continue;
+                merged.mass[i] = nearFrame.mass[j];
+                for (int c = 0; c < 3; ++c) {
+                    merged.position[c][i] = nearFrame.position[c][j];
+                    merged.velocity[c][i] = nearFrame.velocity[c][j];
+                }
+            }
+            const double* position[3] = { merged.position[0].data(), merged.position[1].data(), merged.position[2].data() };
+            const double* velocity[3] = { merged.velocity[0].data(), merged.velocity[1].data(), merged.velocity[2].data() };
+            ShowBodyFrame(bodies, shownIds, count, farFrame.id.data(), position, velocity, merged.mass.data());
+            step = nearFrame.step;
+            simTime = nearFrame.simTime;
         }
 };
 
-std::vector<Object> objs = {}; // Container for all objects in simulation. // Container für alle Objekte in der Simulation.
+std::string serveAddress; // [HOST:]PORT to stream from, if any. // [HOST:]PORT, von dem gestreamt wird, falls vorhanden.
+std::string connectAddress; // HOST:PORT to view instead of simulating, if any. // HOST:PORT, das statt zu simulieren angezeigt wird, falls vorhanden.
+StreamServer streamServer; // Open if --serve is given. // Offen wenn --serve angegeben ist.
+StreamClient streamClient; // Open if --connect is given. // Offen wenn --connect angegeben ist.
 
-// Grid function declarations. // Grid-Funktionsdeklarationen.
-std::vector<float> CreateGridVertices(float size, int divisions, const std::vector<Object>& objs); // Creates grid mesh. // Erstellt Grid-Mesh.
-std::vector<float> UpdateGridVertices(std::vector<float> vertices, const std::vector<Object>& objs); // Updates grid deformation. // Aktualisiert Grid-Verformung.
+/// Applies queued input commands
+/// EN: Called by the simulation between steps, so no reference into objs is held while it grows
+/// DE: Wird von der Simulation zwischen Schritten aufgerufen, sodass beim Wachsen von objs keine Referenz darauf gehalten wird
+void ApplyInputCommands() {
+    InputCommand command; // Current command. // Aktueller Befehl.
+    while (inputQueue.Pop(command)) {
+        bool editsRun = command.type != CMD_PAUSE && command.type != CMD_PICK && command.type != CMD_REPLAY_SPEED && command.type != CMD_REPLAY_SEEK && command.type != CMD_EXPORT; // Changes bodies or the run. // Ändert Körper oder den Lauf.
+        if ((replay.IsOpen() || !connectAddress.empty()) && editsRun) continue; // Recordings and streams are read-only. // Aufzeichnungen und Streams sind schreibgeschützt.
+        Object* creating = objs.Get(creatingBody); // Body being placed, if any. // Platzierter Körper, falls vorhanden.
+        switch (command.type) {
+            case CMD_SPAWN:
+                if (creating) creating->Initalizing = false; // Release a body whose launch was lost. // Körper freigeben, dessen Start verloren ging.
+                creatingBody = objs.Insert(Object(glm::dvec3(0.0, 0.0, 0.0), glm::dvec3(0.0, 0.0, 0.0), initMass)); // Create new object. // Erstelle neues Objekt.
+                objs.Get(creatingBody)->Initalizing = true; // Mark as initializing. // Markiere als initialisierend.
+                break;
+            case CMD_LAUNCH:
+                if (creating) {
+                    creating->Initalizing = false; // End initialization. // Beende Initialisierung.
+                    creating->Launched = true; // Mark as launched. // Markiere als gestartet.
+                }
+                creatingBody = BodyHandle{};
+                break;
+            case CMD_GROW_MASS:
+                if (creating) {
+                    creating->mass *= command.value; // Increase mass. // Erhöhe Masse.
+                    creating->radius = pow((3 * creating->mass / creating->density) / (4 * 3.14159265359f), 1.0f/3.0f); // Update radius based on new mass. // Aktualisiere Radius basierend auf neuer Masse.
+                }
+                break;
+            case CMD_NUDGE: {
+                Object* movable = creating ? creating : objs.Get(selectedBody); // Body being created, otherwise the selected body. // Körper in Erstellung, sonst der gewählte Körper.
+                if (movable) movable->position += command.vector * (movable->radius * command.value);
+                break;
+            }
+            case CMD_PAUSE:
+                paused = command.value != 0.0; // Pause or resume simulation. // Pausiere oder setze Simulation fort.
+                break;
+            case CMD_PICK: {
+                if (bodyBVH.nodes.empty()) bodyBVH.Build(objs); // Before the first frame's update. // Vor dem Update des ersten Frames.
+                int hit = bodyBVH.Pick(objs, command.origin, command.vector); // Nearest hit. // Nächster Treffer.
+                selectedBody = hit >= 0 ? objs.HandleAt(hit) : BodyHandle{}; // Keep a stable handle. // Stabiles Handle behalten.
+                break;
+            }
+            case CMD_REMOVE:
+                objs.Remove(selectedBody); // O(1); other handles stay valid. // O(1); andere Handles bleiben gültig.
+                selectedBody = BodyHandle{};
+                break;
+            case CMD_SAVE_CHECKPOINT:
+                checkpointWriter.Save(checkpointPath, objs); // Written in the background. // Wird im Hintergrund geschrieben.
+                break;
+            case CMD_LOAD_CHECKPOINT:
+                LoadCheckpoint(checkpointPath); // Keeps the current run on failure. // Behält den aktuellen Lauf bei Fehler.
+                break;
+            case CMD_REPLAY_SPEED:
+                replay.speed *= command.value; // Faster, slower or reversed. // Schneller, langsamer oder umgekehrt.
+                break;
+            case CMD_REPLAY_SEEK:
+                replay.Seek(command.value); // Scrub through the recording. // Durch die Aufzeichnung spulen.
+                break;
+            case CMD_EXPORT:
+                exporter.Export(objs, stepCount, simTime); // Written on all cores. // Auf allen Kernen geschrieben.
+                break;
+        }
+    }
+}
 
-GLuint gridVAO, gridVBO; // OpenGL objects for grid rendering. // OpenGL-Objekte für Grid-Rendering.
+std::ofstream profileLog; // Profiling log file. // Profiling-Logdatei.
 
+#ifndef GRAVITY_SIM_LIBRARY // Benchmarks include this file without its entry point. // Benchmarks binden diese Datei ohne ihren Einstiegspunkt ein.
 /// Main function
 /// EN: Entry point that sets up OpenGL, creates initial objects, and runs the simulation loop
 /// DE: Einstiegspunkt der OpenGL einrichtet, Anfangsobjekte erstellt und Simulationsschleife ausführt
-int main() {
+int main(int argc, char** argv) {
+    if (!ParseArguments(argc, argv)) return 1; // Invalid options. // Ungültige Optionen.
+    if (!perfReportPath.empty()) perfCounters.Open(workerPool.ThreadIds()); // Main thread and pool helpers. // Haupt-Thread und Pool-Helfer.
+    if (headlessFrames > 0) return RunHeadless(headlessFrames); // No window. // Kein Fenster.
     GLFWwindow* window = StartGLU(); // Initialize OpenGL and create window. // Initialisiere OpenGL und erstelle Fenster.
-    GLuint shaderProgram = CreateShaderProgram(vertexShaderSource, fragmentShaderSource); // Compile shaders. // Kompiliere Shader.
+    GLuint shaderProgram = LoadShaderProgram(vertexShaderSource, fragmentShaderSource); // Load or compile body shaders. // Lade oder kompiliere Körper-Shader.
+    GLuint gridProgram = LoadShaderProgram(gridVertexShaderSource, gridFragmentShaderSource); // Load or compile grid shaders. // Lade oder kompiliere Grid-Shader.
 
     // Get shader uniform locations. // Hole Shader-Uniform-Positionen.
-    GLint modelLoc = glGetUniformLocation(shaderProgram, "model"); // Model matrix location. // Model-Matrix-Position.
-    GLint objectColorLoc = glGetUniformLocation(shaderProgram, "objectColor"); // Color uniform location. // Farb-Uniform-Position.
-    glUseProgram(shaderProgram); // Activate shader program. // Aktiviere Shader-Programm.
+    GLint objectColorLoc = glGetUniformLocation(gridProgram, "objectColor"); // Grid color uniform location. // Grid-Farb-Uniform-Position.
+    CreateBodyBuffers(); // Create shared sphere meshes and batch buffers. // Erstelle gemeinsame Kugel-Meshes und Batch-Buffer.
+    glUseProgram(shaderProgram); // Activate body shader. // Aktiviere Körper-Shader.
+    glUniform1f(glGetUniformLocation(shaderProgram, "emissiveStrength"), 6.0f); // HDR brightness of glowing bodies. // HDR-Helligkeit leuchtender Körper.
+    bloom.Init(dynamicResolution.Scaled(windowWidth), dynamicResolution.Scaled(windowHeight)); // Create HDR target and bloom chain. // Erstelle HDR-Ziel und Bloom-Kette.
+
+    // Set up GPU profiling. // Richte GPU-Profiling ein.
+    GLuint overlayProgram = LoadShaderProgram(overlayVertexShaderSource, overlayFragmentShaderSource); // Load or compile overlay shaders. // Lade oder kompiliere Overlay-Shader.
+    glGenVertexArrays(1, &overlayVAO); // Generate overlay vertex array. // Generiere Overlay-Vertex-Array.
+    glGenBuffers(1, &overlayVBO); // Generate overlay vertex buffer. // Generiere Overlay-Vertex-Buffer.
+    glBindVertexArray(overlayVAO); // Bind overlay VAO. // Binde Overlay-VAO.
+    glBindBuffer(GL_ARRAY_BUFFER, overlayVBO); // Bind overlay VBO. // Binde Overlay-VBO.
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0); // Position attribute. // Positionsattribut.
+    glEnableVertexAttribArray(0); // Enable position. // Aktiviere Position.
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float))); // Color attribute. // Farbattribut.
+    glEnableVertexAttribArray(1); // Enable color. // Aktiviere Farbe.
+    glBindVertexArray(0); // Unbind VAO. // Löse VAO-Bindung.
+    gpuTimer.Init(); // Create timer queries. // Erstelle Timer-Queries.
+    profileLog.open("profile.log"); // Open profiling log. // Öffne Profiling-Log.
+    profileLog << "frame"; // CSV header. // CSV-Kopfzeile.
+    for (int pass = 0; pass < PASS_COUNT; ++pass) profileLog << ",gpu " << gpuPassNames[pass] << " ms"; // One column per pass. // Eine Spalte pro Pass.
+    profileLog << ",resolution scale\n";
+    governor.log.open("quality.log"); // Open governor decision log. // Öffne Regler-Entscheidungs-Log.
+    double gpuFrameMs = 0.0; // Latest GPU time of a whole frame. // Letzte GPU-Zeit eines ganzen Frames.
 
     // Set up input callbacks. // Richte Eingabe-Callbacks ein.
+    glfwSetKeyCallback(window, keyCallback); // Keyboard callback. // Tastatur-Callback.
+    glfwSetMouseButtonCallback(window, mouseButtonCallback); // Mouse button callback. // Maustasten-Callback.
     glfwSetCursorPosCallback(window, mouse_callback); // Mouse movement callback. // Mausbewegung-Callback.
     glfwSetScrollCallback(window, scroll_callback); // Mouse wheel callback. // Mausrad-Callback.
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback); // Window resize callback. // Fenstergrößen-Callback.
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED); // Hide and capture cursor. // Verstecke und fange Cursor.
 
     // Set up projection matrix. // Richte Projektionsmatrix ein.
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 750000.0f); // Create perspective projection. // Erstelle perspektivische Projektion.
-    GLint projectionLoc = glGetUniformLocation(shaderProgram, "projection"); // Get projection uniform location. // Hole Projektions-Uniform-Position.
-    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection)); // Upload projection matrix. // Lade Projektionsmatrix hoch.
-    cameraPos = glm::vec3(0.0f, 1000.0f, 5000.0f); // Set initial camera position. // Setze Anfangs-Kameraposition.
+    glm::mat4 projection = UpdateProjection({shaderProgram, gridProgram}); // Create and upload perspective projection. // Erstelle und lade perspektivische Projektion.
+    cameraPos = glm::dvec3(0.0, 3.0e7, 1.5e8); // Set initial camera position. // Setze Anfangs-Kameraposition.
 
     // Initialize celestial objects. // Initialisiere Himmelskörper.
-    objs = {
-        Object(glm::vec3(-5000, 650, -350), glm::vec3(0, 0, 1500), 5.97219*pow(10, 22), 5515, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f)), // Blue object orbiting. // Blaues Objekt in Umlaufbahn.
-        Object(glm::vec3(5000, 650, -350), glm::vec3(0, 0, -1500), 5.97219*pow(10, 22), 5515, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f)), // Blue object orbiting opposite. // Blaues Objekt in Gegenumlaufbahn.
-        Object(glm::vec3(0, 0, -350), glm::vec3(0, 0, 0), 1.989 * pow(10, 25), 5515, glm::vec4(1.0f, 0.929f, 0.176f, 1.0f), true), // Central glowing star. // Zentraler leuchtender Stern.
-    };
+    if (!replayPath.empty()) {
+        if (!replay.Open(replayPath) || !replay.Apply(objs)) { // Show the first frame. // Ersten Frame anzeigen.
+            glfwTerminate(); // Clean up GLFW. // Räume GLFW auf.
+            return 1;
+        }
+    } else if (!connectAddress.empty()) {
+        if (!streamClient.Connect(connectAddress)) { // Bodies arrive with the first frames. // Körper kommen mit den ersten Frames.
+            glfwTerminate(); // Clean up GLFW. // Räume GLFW auf.
+            return 1;
+        }
+    } else if (!SetUpScene()) {
+        glfwTerminate(); // Clean up GLFW. // Räume GLFW auf.
+        return 1;
+    }
     
+    if (!trajectoryPath.empty() && !trajectory.Open(trajectoryPath, trajectoryEvery, trajectoryDirectIO, trajectoryError)) {
+        glfwTerminate(); // Clean up GLFW. // Räume GLFW auf.
+        return 1;
+    }
+    if (!OpenPublisher() || (!serveAddress.empty() && !streamServer.Open(serveAddress))) {
+        glfwTerminate(); // Clean up GLFW. // Räume GLFW auf.
+        return 1;
+    }
+    if (replayPath.empty() && connectAddress.empty()) conservation.Update(objs, stepCount, simTime); // Baseline before the first step. // Basis vor dem ersten Schritt.
+
     // Create grid mesh. // Erstelle Grid-Mesh.
-    std::vector<float> gridVertices = CreateGridVertices(20000.0f, 25, objs); // Generate grid vertices. // Generiere Grid-Vertices.
-    CreateVBOVAO(gridVAO, gridVBO, gridVertices.data(), gridVertices.size()); // Create grid buffers. // Erstelle Grid-Buffer.
+    std::vector<double> gridVertices = CreateGridVertices(gridSize, gridDivisions, objs); // Generate grid vertices. // Generiere Grid-Vertices.
+    std::vector<float> gridRelative = ToCameraRelative(gridVertices); // Camera-relative copy for the GPU. // Kamerarelative Kopie für die GPU.
+    CreateVBOVAO(gridVAO, gridVBO, gridRelative.data(), gridRelative.size()); // Create grid buffers. // Erstelle Grid-Buffer.
+    gridCapacity = gridRelative.size() * sizeof(float); // Initial storage. // Anfänglicher Speicher.
 
     // Main render loop. // Haupt-Render-Schleife.
     while (!glfwWindowShouldClose(window) && running == true) {
+        PROFILE_ZONE("frame"); // Root zone of the frame. // Wurzelzone des Frames.
         // Calculate frame timing. // Berechne Frame-Timing.
         float currentFrame = glfwGetTime(); // Get current time. // Hole aktuelle Zeit.
         deltaTime = currentFrame - lastFrame; // Calculate delta time. // Berechne Delta-Zeit.
         lastFrame = currentFrame; // Update last frame time. // Aktualisiere letzte Frame-Zeit.
+        auto frameStart = std::chrono::steady_clock::now(); // Start of CPU work. // Beginn der CPU-Arbeit.
+
+        // Read back GPU times from earlier frames. // Lese GPU-Zeiten früherer Frames aus.
+        bool resolutionChanged = false; // Scene target must be reallocated. // Szenenziel muss neu angelegt werden.
+        if (gpuTimer.BeginFrame()) {
+            gpuFrameMs = 0.0; // Sum of pass times. // Summe der Pass-Zeiten.
+            profileLog << gpuTimer.sampleFrame; // Frame the samples were taken in. // Frame, in dem die Messwerte entstanden.
+            for (int pass = 0; pass < PASS_COUNT; ++pass) {
+                profileLog << "," << gpuTimer.lastMs[pass]; // Raw pass times. // Rohe Pass-Zeiten.
+                gpuFrameMs += gpuTimer.lastMs[pass];
+            }
+            profileLog << "," << dynamicResolution.scale << "\n";
+            resolutionChanged = dynamicResolution.Update(gpuFrameMs); // GPU time ignores vsync waits. // GPU-Zeit ignoriert VSync-Wartezeiten.
+        } else if (!gpuTimer.supported) {
+            resolutionChanged = dynamicResolution.Update(deltaTime * 1000.0); // Fall back to CPU frame time. // Rückfall auf CPU-Frame-Zeit.
+        }
+
+        // Follow window and render-scale changes. // Fenster- und Render-Maßstabsänderungen folgen.
+        if (windowResized) {
+            projection = UpdateProjection({shaderProgram, gridProgram}); // New aspect ratio. // Neues Seitenverhältnis.
+            windowResized = false;
+            resolutionChanged = true;
+        }
+        if (resolutionChanged) {
+            bloom.Resize(dynamicResolution.Scaled(windowWidth), dynamicResolution.Scaled(windowHeight)); // Reallocate scene target. // Szenenziel neu anlegen.
+        }
 
+        bloom.BeginScene(); // Render the scene in HDR. // Rendere die Szene in HDR.
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear framebuffer. // Lösche Framebuffer.
 
-        // Set up callbacks. // Richte Callbacks ein.
-        glfwSetKeyCallback(window, keyCallback); // Keyboard callback. // Tastatur-Callback.
-        glfwSetMouseButtonCallback(window, mouseButtonCallback); // Mouse button callback. // Maustasten-Callback.
-        UpdateCam(shaderProgram, cameraPos); // Update camera view matrix. // Aktualisiere Kamera-Ansichtsmatrix.
+        glm::mat4 view = UpdateCam(shaderProgram); // Update camera view matrix. // Aktualisiere Kamera-Ansichtsmatrix.
+        glm::vec3 lightPos = glm::vec3(-cameraPos); // World center relative to the camera. // Weltzentrum relativ zur Kamera.
+        glUniform3f(glGetUniformLocation(shaderProgram, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
+        UpdateCam(gridProgram); // Same view for the grid. // Gleiche Ansicht für das Gitter.
         
         // Handle object creation with right mouse. // Verarbeite Objekterstellung mit rechter Maus.
-        if (!objs.empty() && objs.back().Initalizing) {
-            if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
-                objs.back().mass *= 1.0 + 1.0 * deltaTime; // Increase mass over time. // Erhöhe Masse über Zeit.
-                
-                // Update radius based on new mass. // Aktualisiere Radius basierend auf neuer Masse.
-                objs.back().radius = pow(
-                    (3 * objs.back().mass / objs.back().density) / 
-                    (4 * 3.14159265359f), 
-                    1.0f/3.0f
-                ) / sizeRatio;
-                
-                objs.back().UpdateVertices(); // Regenerate sphere mesh. // Regeneriere Kugel-Mesh.
-            }
+        if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
+            PushInput(CMD_GROW_MASS, glm::dvec3(0.0, 0.0, 0.0), 1.0 + 1.0 * deltaTime); // Increase mass over time. // Erhöhe Masse über Zeit.
         }
 
         // Draw the grid. // Zeichne das Gitter.
-        glUseProgram(shaderProgram); // Activate shader. // Aktiviere Shader.
+        glUseProgram(gridProgram); // Activate grid shader. // Aktiviere Grid-Shader.
         glUniform4f(objectColorLoc, 1.0f, 1.0f, 1.0f, 0.25f); // Set grid color with transparency. // Setze Grid-Farbe mit Transparenz.
-        glUniform1i(glGetUniformLocation(shaderProgram, "isGrid"), 1); // Enable grid rendering mode. // Aktiviere Grid-Rendering-Modus.
-        glUniform1i(glGetUniformLocation(shaderProgram, "GLOW"), 0); // Disable glow for grid. // Deaktiviere Leuchten für Grid.
-        gridVertices = UpdateGridVertices(gridVertices, objs); // Update grid deformation. // Aktualisiere Grid-Verformung.
-        glBindBuffer(GL_ARRAY_BUFFER, gridVBO); // Bind grid buffer. // Binde Grid-Buffer.
-        glBufferData(GL_ARRAY_BUFFER, gridVertices.size() * sizeof(float), gridVertices.data(), GL_DYNAMIC_DRAW); // Upload grid data. // Lade Grid-Daten hoch.
-        DrawGrid(shaderProgram, gridVAO, gridVertices.size()); // Render grid. // Rendere Grid.
-
-        // Draw all objects. // Zeichne alle Objekte.
-        for(auto& obj : objs) {
-            glUniform4f(objectColorLoc, obj.color.r, obj.color.g, obj.color.b, obj.color.a); // Set object color. // Setze Objektfarbe.
-
-            // Calculate gravitational forces between objects. // Berechne Gravitationskräfte zwischen Objekten.
-            for(auto& obj2 : objs){
-                if(&obj2 != &obj && !obj.Initalizing && !obj2.Initalizing){ // Skip self and initializing objects. // Überspringe Selbst und initialisierende Objekte.
-                    float dx = obj2.GetPos()[0] - obj.GetPos()[0]; // X distance. // X-Abstand.
-                    float dy = obj2.GetPos()[1] - obj.GetPos()[1]; // Y distance. // Y-Abstand.
-                    float dz = obj2.GetPos()[2] - obj.GetPos()[2]; // Z distance. // Z-Abstand.
-                    float distance = sqrt(dx * dx + dy * dy + dz * dz); // Calculate distance. // Berechne Abstand.
-
-                    if (distance > 0) { // Avoid division by zero. // Vermeide Division durch Null.
-                        std::vector<float> direction = {dx / distance, dy / distance, dz / distance}; // Normalized direction. // Normalisierte Richtung.
-                        distance *= 1000; // Convert to meters. // Konvertiere zu Metern.
-                        double Gforce = (G * obj.mass * obj2.mass) / (distance * distance); // Newton's law of gravitation. // Newtonsches Gravitationsgesetz.
-                        
-                        float acc1 = Gforce / obj.mass; // Calculate acceleration. // Berechne Beschleunigung.
-                        std::vector<float> acc = {direction[0] * acc1, direction[1]*acc1, direction[2]*acc1}; // Acceleration vector. // Beschleunigungsvektor.
-                        if(!pause){
-                            obj.accelerate(acc[0], acc[1], acc[2]); // Apply acceleration if not paused. // Wende Beschleunigung an wenn nicht pausiert.
-                        }
+        {
+            PROFILE_ZONE("grid update");
+            gridVertices = UpdateGridVertices(gridVertices, objs); // Update grid deformation. // Aktualisiere Grid-Verformung.
+            gridRelative = ToCameraRelative(gridVertices); // Rebase to the camera. // Relativ zur Kamera verschieben.
+        }
+        {
+            PROFILE_ZONE("grid upload");
+            gpuTimer.Begin(PASS_GRID_UPLOAD); // Measure grid upload. // Miss Grid-Upload.
+            UploadStreamBuffer(GL_ARRAY_BUFFER, gridVBO, gridCapacity, gridRelative.data(), gridRelative.size() * sizeof(float)); // Upload grid data. // Lade Grid-Daten hoch.
+            gpuTimer.End();
+        }
+        {
+            PROFILE_ZONE("grid draw");
+            gpuTimer.Begin(PASS_GRID_DRAW); // Measure grid draw. // Miss Grid-Zeichnen.
+            DrawGrid(gridProgram, gridVAO, gridRelative.size()); // Render grid. // Rendere Grid.
+            gpuTimer.End();
+        }
 
-                        obj.velocity *= obj.CheckCollision(obj2); // Apply collision damping. // Wende Kollisionsdämpfung an.
-                        std::cout<<"radius: "<<obj.radius<<std::endl; // Debug output. // Debug-Ausgabe.
-                    }
+        // Apply input at the step boundary. // Eingaben an der Schrittgrenze anwenden.
+        {
+            PROFILE_ZONE("input");
+            ApplyInputCommands();
+        }
+
+        // Update all objects in substeps, or take them from the recording. // Aktualisiere alle Objekte in Teilschritten oder übernimm sie aus der Aufzeichnung.
+        auto stepStart = std::chrono::steady_clock::now(); // Start of physics. // Beginn der Physik.
+        {
+            PROFILE_ZONE("physics");
+            if (replay.IsOpen()) {
+                if (!paused) replay.Advance(deltaTime); // Move through the recording. // Durch die Aufzeichnung bewegen.
+                if (replay.Apply(objs)) {
+                    simTime = replay.index[replay.Frame()].simTime; // Clock of the shown frame. // Uhr des angezeigten Frames.
+                    stepCount = replay.index[replay.Frame()].step;
+                }
+            } else if (!connectAddress.empty()) {
+                if (streamClient.Update(objs, cameraPos)) { // Newest frame from the server. // Neuester Frame vom Server.
+                    simTime = streamClient.simTime; // Clock of the server. // Uhr des Servers.
+                    stepCount = streamClient.step;
+                }
+            } else {
+                for (int substep = 0; substep < substeps; ++substep) {
+                    StepSimulation(simTimeStep / substeps, substep == 0); // Collision damping once per frame. // Kollisionsdämpfung einmal pro Frame.
                 }
             }
-            
-            // Update object during initialization. // Aktualisiere Objekt während Initialisierung.
-            if(obj.Initalizing){
-                obj.radius = pow(((3 * obj.mass/obj.density)/(4 * 3.14159265359)), (1.0f/3.0f)) / 1000000; // Smaller radius during creation. // Kleinerer Radius während Erstellung.
-                obj.UpdateVertices(); // Update mesh. // Aktualisiere Mesh.
+            if (!paused && !replay.IsOpen() && connectAddress.empty()) {
+                simTime += simTimeStep; // Advance the run clock. // Laufuhr vorstellen.
+                ++stepCount;
+                if (trajectory.IsOpen() && stepCount % trajectoryEvery == 0) {
+                    trajectory.Capture(objs, stepCount, simTime); // Queued for the writer thread. // Für den Schreib-Thread eingereiht.
+                }
+                if (exporter.every > 0 && stepCount % exporter.every == 0) {
+                    exporter.Export(objs, stepCount, simTime); // Snapshot for ParaView. // Schnappschuss für ParaView.
+                }
+                conservation.Update(objs, stepCount, simTime); // Drift check every K steps. // Driftprüfung alle K Schritte.
             }
+        }
+        bodyBVH.Update(objs); // Picking tree follows the moved bodies. // Picking-Baum folgt den bewegten Körpern.
+        {
+            PROFILE_ZONE("output");
+            PublishState(); // Latest frame for external readers. // Neuester Frame für externe Leser.
+            streamServer.Update(objs, stepCount, simTime); // Frames for remote viewers. // Frames für entfernte Viewer.
+        }
+        double stepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stepStart).count(); // Physics time. // Physikzeit.
 
-            // Update positions if not paused. // Aktualisiere Positionen wenn nicht pausiert.
-            if(!pause){
-                obj.UpdatePos();
-            }
-            
-            // Set up rendering state for object. // Richte Rendering-Zustand für Objekt ein.
-            glm::mat4 model = glm::mat4(1.0f); // Identity matrix. // Einheitsmatrix.
-            model = glm::translate(model, obj.position); // Apply object position. // Wende Objektposition an.
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model)); // Upload model matrix. // Lade Model-Matrix hoch.
-            glUniform1i(glGetUniformLocation(shaderProgram, "isGrid"), 0); // Disable grid mode. // Deaktiviere Grid-Modus.
-            
-            // Set glow effect. // Setze Leuchteffekt.
-            if(obj.glow){
-                glUniform1i(glGetUniformLocation(shaderProgram, "GLOW"), 1); // Enable glow. // Aktiviere Leuchten.
-            } else {
-                glUniform1i(glGetUniformLocation(shaderProgram, "GLOW"), 0); // Disable glow. // Deaktiviere Leuchten.
-            }
-            
-            glBindVertexArray(obj.VAO); // Bind object vertex array. // Binde Objekt-Vertex-Array.
-            glDrawArrays(GL_TRIANGLES, 0, obj.vertexCount / 3); // Draw triangles. // Zeichne Dreiecke.
+        // Draw all objects in one batch. // Zeichne alle Objekte in einem Batch.
+        {
+            PROFILE_ZONE("body culling");
+            BuildBodyDrawCommands(objs, projection * view); // Cull and select LODs. // Verwerfe und wähle LODs.
+        }
+        {
+            PROFILE_ZONE("body draw"); // Includes the instance upload. // Einschließlich Instanz-Upload.
+            gpuTimer.Begin(PASS_BODIES); // Measure body draws. // Miss Körper-Zeichnen.
+            DrawBodies(shaderProgram); // Submit batches. // Sende Batches.
+            gpuTimer.End();
+        }
+
+        // Bloom and composite to the window. // Bloom und Compositing ins Fenster.
+        {
+            PROFILE_ZONE("post");
+            gpuTimer.Begin(PASS_POST); // Measure post-processing. // Miss Nachbearbeitung.
+            bloom.Apply(windowWidth, windowHeight);
+            gpuTimer.End();
+        }
+        gpuTimer.EndFrame(); // Advance query slot. // Nächster Query-Slot.
+
+        // Show GPU pass times. // Zeige GPU-Pass-Zeiten.
+        if (showProfiler && gpuTimer.supported) {
+            DrawProfilerOverlay(overlayProgram, overlayVAO, overlayVBO, gpuTimer.passMs); // Draw timing bars. // Zeichne Zeitbalken.
+        }
+        UpdateWindowTitle(window, gpuTimer.passMs); // Update title text. // Aktualisiere Titeltext.
+
+        // Adjust quality knobs for the next frames. // Qualitätsstellgrößen für die nächsten Frames anpassen.
+        double cpuFrameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count(); // CPU busy time, excludes vsync. // CPU-Arbeitszeit, ohne VSync.
+        if (governor.Update(std::max(cpuFrameMs, gpuFrameMs), stepMs)) {
+            gridVertices = CreateGridVertices(gridSize, gridDivisions, objs); // Rebuild grid at new resolution. // Gitter mit neuer Auflösung neu erstellen.
         }
         
-        glfwSwapBuffers(window); // Swap front and back buffers. // Tausche Vorder- und Hintergrundpuffer.
-        glfwPollEvents(); // Process window events. // Verarbeite Fenster-Events.
+        {
+            PROFILE_ZONE("swap"); // Includes vsync waits. // Einschließlich VSync-Wartezeiten.
+            glfwSwapBuffers(window); // Swap front and back buffers. // Tausche Vorder- und Hintergrundpuffer.
+        }
+        {
+            PROFILE_ZONE("events"); // Key and mouse callbacks. // Tasten- und Maus-Callbacks.
+            glfwPollEvents(); // Process window events. // Verarbeite Fenster-Events.
+        }
     }
+    PROFILE_WRITE_TRACE(); // Newest zones of the run. // Neueste Zonen des Laufs.
+    if (perfCounters.enabled) perfCounters.Report(perfReportPath); // Counters per phase. // Zähler pro Phase.
+    perfCounters.Close(); // Release the counters. // Zähler freigeben.
+    conservation.Close(); // Flush the drift log. // Drift-Log schreiben.
 
     // Clean up OpenGL resources. // Räume OpenGL-Ressourcen auf.
-    for (auto& obj : objs) {
-        glDeleteVertexArrays(1, &obj.VAO); // Delete vertex array. // Lösche Vertex-Array.
-        glDeleteBuffers(1, &obj.VBO); // Delete vertex buffer. // Lösche Vertex-Buffer.
-    }
-
     glDeleteVertexArrays(1, &gridVAO); // Delete grid vertex array. // Lösche Grid-Vertex-Array.
     glDeleteBuffers(1, &gridVBO); // Delete grid buffer. // Lösche Grid-Buffer.
+    glDeleteVertexArrays(1, &bodyVAO); // Delete body vertex array. // Lösche Körper-Vertex-Array.
+    glDeleteBuffers(1, &sphereVBO); // Delete sphere mesh buffer. // Lösche Kugel-Mesh-Buffer.
+    glDeleteBuffers(1, &instanceVBO); // Delete instance buffer. // Lösche Instanz-Buffer.
+    glDeleteBuffers(1, &indirectBuffer); // Delete indirect command buffer. // Lösche Indirekt-Befehls-Buffer.
+    glDeleteVertexArrays(1, &overlayVAO); // Delete overlay vertex array. // Lösche Overlay-Vertex-Array.
+    glDeleteBuffers(1, &overlayVBO); // Delete overlay buffer. // Lösche Overlay-Buffer.
+    gpuTimer.Destroy(); // Delete timer queries. // Lösche Timer-Queries.
+    bloom.Destroy(); // Delete HDR target and bloom chain. // Lösche HDR-Ziel und Bloom-Kette.
+    profileLog.close(); // Flush profiling log. // Schreibe Profiling-Log.
+    trajectory.Close(); // Write queued snapshots. // Eingereihte Schnappschüsse schreiben.
+    statePublisher.Close(); // Remove the segment name. // Segmentnamen entfernen.
+    streamServer.Close(); // Disconnect remote viewers. // Entfernte Viewer trennen.
+    streamClient.Close();
+    governor.log.close(); // Flush governor log. // Schreibe Regler-Log.
 
     glDeleteProgram(shaderProgram); // Delete shader program. // Lösche Shader-Programm.
+    glDeleteProgram(gridProgram); // Delete grid program. // Lösche Grid-Programm.
+    glDeleteProgram(overlayProgram); // Delete overlay program. // Lösche Overlay-Programm.
     glfwTerminate(); // Terminate GLFW. // Beende GLFW.
 
     return 0; // Exit successfully. // Beende erfolgreich.
 }
+#endif
+
+/// Creates the initial bodies
+/// EN: Loads the scenario or checkpoint given with --load, generates the --generate scene, otherwise the built-in scene; returns false if the file cannot be loaded
+/// DE: Lädt das mit --load angegebene Szenario oder den Checkpoint, generiert die --generate-Szene, sonst die eingebaute Szene; gibt false zurück, wenn die Datei nicht geladen werden kann
+bool SetUpScene() {
+    if (!loadPath.empty()) return LoadScenario(loadPath); // Restart a saved run or load a scene. // Gespeicherten Lauf fortsetzen oder Szene laden.
+    if (generator.count > 0) {
+        GenerateScene(generator); // Benchmark scene. // Benchmark-Szene.
+        return true;
+    }
+
+    // Built-in scene in SI units, also shipped as scenarios/three_body.scn. // Eingebaute Szene in SI-Einheiten, auch als scenarios/three_body.scn enthalten.
+    const double starMass = 1.989e25; // Central star mass in kg. // Masse des Zentralsterns in kg.
+    const double orbitRadius = 1.5e8; // Planet distance from the star in m. // Planetenabstand vom Stern in m.
+    const double orbitSpeed = sqrt(G * starMass / orbitRadius); // Circular orbit speed. // Kreisbahngeschwindigkeit.
+    objs.reserve(1024); // Room for user-spawned bodies. // Platz für vom Benutzer erzeugte Körper.
+    objs.Insert(Object(glm::dvec3(-orbitRadius, 1.95e7, -1.05e7), glm::dvec3(0, 0, orbitSpeed), 5.97219e22, 5515, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f))); // Blue object orbiting. // Blaues Objekt in Umlaufbahn.
+    objs.Insert(Object(glm::dvec3(orbitRadius, 1.95e7, -1.05e7), glm::dvec3(0, 0, -orbitSpeed), 5.97219e22, 5515, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f))); // Blue object orbiting opposite. // Blaues Objekt in Gegenumlaufbahn.
+    objs.Insert(Object(glm::dvec3(0, 0, -1.05e7), glm::dvec3(0, 0, 0), starMass, 5515, glm::vec4(1.0f, 0.929f, 0.176f, 1.0f), true)); // Central glowing star. // Zentraler leuchtender Stern.
+    return true;
+}
+
+/// Runs the simulation without a window
+/// EN: Steps the scene for a fixed number of frames as fast as possible, records the trajectory if requested and reports the wall time
+/// DE: Rechnet die Szene so schnell wie möglich für eine feste Anzahl Frames, zeichnet auf Wunsch die Trajektorie auf und meldet die Laufzeit
+int RunHeadless(int frames) {
+    if (!SetUpScene()) return 1;
+    if (!trajectoryPath.empty() && !trajectory.Open(trajectoryPath, trajectoryEvery, trajectoryDirectIO, trajectoryError)) return 1;
+    if (!OpenPublisher() || (!serveAddress.empty() && !streamServer.Open(serveAddress))) return 1;
+    paused = false; // Nothing to pause without input. // Ohne Eingabe gibt es nichts zu pausieren.
+    conservation.Update(objs, stepCount, simTime); // Baseline before the first step. // Basis vor dem ersten Schritt.
+    auto start = std::chrono::steady_clock::now(); // Start of the run. // Beginn des Laufs.
+    for (int frame = 0; frame < frames; ++frame) {
+        PROFILE_ZONE("frame");
+        for (int substep = 0; substep < substeps; ++substep) {
+            StepSimulation(simTimeStep / substeps, substep == 0); // Same schedule as the viewer. // Gleicher Ablauf wie im Viewer.
+        }
+        simTime += simTimeStep; // Advance the run clock. // Laufuhr vorstellen.
+        ++stepCount;
+        if (trajectory.IsOpen() && stepCount % trajectoryEvery == 0) {
+            trajectory.Capture(objs, stepCount, simTime); // Queued for the writer thread. // Für den Schreib-Thread eingereiht.
+        }
+        if (exporter.every > 0 && stepCount % exporter.every == 0) {
+            exporter.Export(objs, stepCount, simTime); // Snapshot for ParaView. // Schnappschuss für ParaView.
+        }
+        conservation.Update(objs, stepCount, simTime); // Drift check every K steps. // Driftprüfung alle K Schritte.
+        PublishState(); // Latest frame for external readers. // Neuester Frame für externe Leser.
+        streamServer.Update(objs, stepCount, simTime); // Frames for remote viewers. // Frames für entfernte Viewer.
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); // Wall time. // Laufzeit.
+    PROFILE_WRITE_TRACE(); // Newest zones of the run. // Neueste Zonen des Laufs.
+    if (perfCounters.enabled) perfCounters.Report(perfReportPath); // Counters per phase. // Zähler pro Phase.
+    perfCounters.Close(); // Release the counters. // Zähler freigeben.
+    conservation.Close(); // Flush the drift log. // Drift-Log schreiben.
+    trajectory.Close(); // Write queued snapshots. // Eingereihte Schnappschüsse schreiben.
+    statePublisher.Close(); // Remove the segment name. // Segmentnamen entfernen.
+    streamServer.Close(); // Disconnect remote viewers. // Entfernte Viewer trennen.
+    std::cout << "Headless: " << frames << " frames, " << objs.size() << " bodies, " << seconds << " s (" << frames / seconds << " frames/s, t = " << simTime << " s)" << std::endl; // Summary. // Zusammenfassung.
+    return 0;
+}
+
+/// Advances the simulation by one substep
+/// EN: All-pairs gravity with semi-implicit Euler over dt simulated seconds, in SI units and double precision
+/// DE: Paarweise Gravitation mit semi-implizitem Euler über dt simulierte Sekunden, in SI-Einheiten und doppelter Genauigkeit
+void StepSimulation(double dt, bool applyCollisions) {
+    PROFILE_ZONE(applyCollisions ? "substep with collisions" : "substep"); // Forces, collisions and integration share one loop. // Kräfte, Kollisionen und Integration teilen sich eine Schleife.
+    PerfScope perfScope(applyCollisions ? PERF_SUBSTEP_COLLISIONS : PERF_SUBSTEP, double(objs.size()) * (objs.size() - 1.0)); // Body pairs visited. // Besuchte Körperpaare.
+    for(auto& obj : objs) {
+        // Calculate gravitational forces between objects. // Berechne Gravitationskräfte zwischen Objekten.
+        for(auto& obj2 : objs){
+            if(&obj2 != &obj && !obj.Initalizing && !obj2.Initalizing){ // Skip self and initializing objects. // Überspringe Selbst und initialisierende Objekte.
+                double dx = obj2.GetPos()[0] - obj.GetPos()[0]; // X distance. // X-Abstand.
+                double dy = obj2.GetPos()[1] - obj.GetPos()[1]; // Y distance. // Y-Abstand.
+                double dz = obj2.GetPos()[2] - obj.GetPos()[2]; // Z distance. // Z-Abstand.
+                double distance = sqrt(dx * dx + dy * dy + dz * dz); // Calculate distance in meters. // Berechne Abstand in Metern.
+
+                if (distance > 0) { // Avoid division by zero. // Vermeide Division durch Null.
+                    glm::dvec3 direction(dx / distance, dy / distance, dz / distance); // Normalized direction. // Normalisierte Richtung.
+                    double Gforce = (G * obj.mass * obj2.mass) / (distance * distance); // Newton's law of gravitation. // Newtonsches Gravitationsgesetz.
+
+                    double acc1 = Gforce / obj.mass; // Calculate acceleration. // Berechne Beschleunigung.
+                    glm::dvec3 acc = direction * acc1; // Acceleration vector. // Beschleunigungsvektor.
+                    if(!paused){
+                        obj.accelerate(acc[0], acc[1], acc[2], dt); // Apply acceleration if not paused. // Wende Beschleunigung an wenn nicht pausiert.
+                    }
+
+                    if (applyCollisions) {
+                        obj.velocity *= double(obj.CheckCollision(obj2)); // Apply collision damping. // Wende Kollisionsdämpfung an.
+                    }
+                }
+            }
+        }
+
+        // Update positions if not paused. // Aktualisiere Positionen wenn nicht pausiert.
+        if(!paused){
+            obj.UpdatePos(dt);
+        }
+    }
+}
+
+/// Parses command-line options
+/// EN: --target-fps N, --no-governor, --no-dynamic-resolution, MIN:MAX bounds for the governor knobs, scenario, checkpoint, trajectory and replay files, generated scenes, headless runs; returns false on bad input
+/// DE: --target-fps N, --no-governor, --no-dynamic-resolution, MIN:MAX-Grenzen für die Regler-Stellgrößen, Szenario-, Checkpoint-, Trajektorien- und Wiedergabe-Dateien, generierte Szenen, Läufe ohne Fenster; gibt bei fehlerhafter Eingabe false zurück
+bool ParseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i]; // Current option. // Aktuelle Option.
+        bool hasValue = i + 1 < argc; // Option has a following value. // Option hat einen folgenden Wert.
+        try {
+            if (arg == "--target-fps" && hasValue) {
+                double fps = std::stod(argv[++i]); // Frames per second. // Bilder pro Sekunde.
+                if (!(fps > 0.0)) { // Also rejects NaN; 0 would give an infinite budget. // Verwirft auch NaN; 0 ergäbe ein unendliches Budget.
+                    std::cerr << "--target-fps must be positive" << std::endl; // Error message. // Fehlermeldung.
+                    return false;
+                }
+                governor.targetMs = dynamicResolution.targetMs = 1000.0 / fps; // Shared frame budget. // Gemeinsames Frame-Budget.
+            } else if (arg == "--grid-divisions" && hasValue) {
+                std::string range = argv[++i]; // MIN:MAX. // MIN:MAX.
+                governor.minGridDivisions = std::stoi(range.substr(0, range.find(':')));
+                governor.maxGridDivisions = std::stoi(range.substr(range.find(':') + 1));
+            } else if (arg == "--lod-bias" && hasValue) {
+                std::string range = argv[++i];
+                governor.minLodBias = std::stof(range.substr(0, range.find(':')));
+                governor.maxLodBias = std::stof(range.substr(range.find(':') + 1));
+            } else if (arg == "--substeps" && hasValue) {
+                std::string range = argv[++i];
+                governor.minSubsteps = std::stoi(range.substr(0, range.find(':')));
+                governor.maxSubsteps = std::stoi(range.substr(range.find(':') + 1));
+            } else if (arg == "--load" && hasValue) {
+                loadPath = argv[++i]; // Start from a checkpoint or scenario. // Von einem Checkpoint oder Szenario starten.
+            } else if (arg == "--checkpoint" && hasValue) {
+                checkpointPath = argv[++i]; // File for F5/F9. // Datei für F5/F9.
+            } else if (arg == "--trajectory" && hasValue) {
+                trajectoryPath = argv[++i]; // Record snapshots. // Schnappschüsse aufzeichnen.
+            } else if (arg == "--trajectory-every" && hasValue) {
+                trajectoryEvery = std::max(1, std::stoi(argv[++i])); // Frames between snapshots. // Frames zwischen Schnappschüssen.
+            } else if (arg == "--trajectory-error" && hasValue) {
+                trajectoryError = std::stod(argv[++i]); // Compress within this error. // Innerhalb dieses Fehlers komprimieren.
+            } else if (arg == "--replay" && hasValue) {
+                replayPath = argv[++i]; // Play back a recording. // Eine Aufzeichnung abspielen.
+            } else if (arg == "--replay-speed" && hasValue) {
+                replay.speed = std::stod(argv[++i]); // Initial speed, negative plays backwards. // Anfangsgeschwindigkeit, negativ spielt rückwärts.
+            } else if (arg == "--generate" && hasValue) {
+                std::string spec = argv[++i]; // KIND:N[:SEED]. // KIND:N[:SEED].
+                size_t colon = spec.find(':'), second = spec.find(':', colon + 1); // Field separators. // Feldtrenner.
+                std::string kind = spec.substr(0, colon); // Generator name. // Generatorname.
+                generator.kind = GEN_COUNT;
+                for (int k = 0; k < GEN_COUNT; ++k) if (kind == generatorNames[k]) generator.kind = k;
+                if (generator.kind == GEN_COUNT || colon == std::string::npos) {
+                    std::cerr << "Unknown generator: " << spec << " (plummer, hernquist, nfw, disk, galaxies, kepler)" << std::endl; // Error message. // Fehlermeldung.
+                    return false;
+                }
+                generator.count = (size_t)std::stoull(spec.substr(colon + 1, second - colon - 1)); // Body count. // Körperanzahl.
+                if (second != std::string::npos) generator.seed = std::stoull(spec.substr(second + 1)); // Scene seed. // Szenen-Seed.
+            } else if (arg == "--generate-mass" && hasValue) {
+                generator.mass = std::stod(argv[++i]); // Total mass in kg. // Gesamtmasse in kg.
+            } else if (arg == "--generate-scale" && hasValue) {
+                generator.scale = std::stod(argv[++i]); // Scale length in m. // Skalenlänge in m.
+            } else if (arg == "--headless" && hasValue) {
+                headlessFrames = std::max(1, std::stoi(argv[++i])); // Frames to simulate. // Zu simulierende Frames.
+            } else if (arg == "--export" && hasValue) {
+                exporter.prefix = argv[++i]; // ParaView output prefix. // ParaView-Ausgabepräfix.
+            } else if (arg == "--export-every" && hasValue) {
+                exporter.every = std::max(0, std::stoi(argv[++i])); // Frames between exports. // Frames zwischen Exporten.
+            } else if (arg == "--publish" && hasValue) {
+                publishName = argv[++i]; // Shared-memory segment name. // Name des Segments im gemeinsamen Speicher.
+            } else if (arg == "--serve" && hasValue) {
+                serveAddress = argv[++i]; // Stream to remote viewers. // An entfernte Viewer streamen.
+            } else if (arg == "--stream-budget" && hasValue) {
+                streamServer.budget = std::stod(argv[++i]) * 1.0e6; // MB/s per client. // MB/s pro Client.
+            } else if (arg == "--stream-error" && hasValue) {
+                streamServer.positionError = std::stod(argv[++i]); // Quantization bound in m. // Quantisierungsgrenze in m.
+            } else if (arg == "--connect" && hasValue) {
+                connectAddress = argv[++i]; // View a remote simulation. // Eine entfernte Simulation anzeigen.
+            } else if (arg == "--diagnostics" && hasValue) {
+                conservation.every = std::max(0, std::stoi(argv[++i])); // Steps between conservation checks. // Schritte zwischen Erhaltungsprüfungen.
+            } else if (arg == "--perf-counters" && hasValue) {
+                perfReportPath = argv[++i]; // JSON report of hardware counters. // JSON-Bericht der Hardware-Zähler.
+            } else if (arg == "--direct-io") {
+                trajectoryDirectIO = true; // Bypass the page cache. // Seitencache umgehen.
+            } else if (arg == "--no-governor") {
+                governor.enabled = false; // Keep knobs fixed. // Stellgrößen fest halten.
+            } else if (arg == "--no-dynamic-resolution") {
+                dynamicResolution.enabled = false; // Always native resolution. // Immer native Auflösung.
+            } else {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl; // Error message. // Fehlermeldung.
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for option: " << arg << std::endl; // Error message. // Fehlermeldung.
+            return false;
+        }
+    }
+
+    if (!replayPath.empty() && (!trajectoryPath.empty() || !loadPath.empty() || generator.count > 0 || headlessFrames > 0)) {
+        std::cerr << "--replay cannot be combined with --trajectory, --load, --generate or --headless" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (!connectAddress.empty() && (!replayPath.empty() || !trajectoryPath.empty() || !loadPath.empty() || generator.count > 0 || headlessFrames > 0 || !serveAddress.empty())) {
+        std::cerr << "--connect cannot be combined with --replay, --trajectory, --load, --generate, --headless or --serve" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (streamServer.budget <= 0.0 || streamServer.positionError <= 0.0) {
+        std::cerr << "--stream-budget and --stream-error must be positive" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (!loadPath.empty() && generator.count > 0) {
+        std::cerr << "--load cannot be combined with --generate" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (governor.minGridDivisions < 1 || governor.minGridDivisions > governor.maxGridDivisions) {
+        std::cerr << "--grid-divisions needs 1 <= MIN <= MAX" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (governor.minSubsteps < 1 || governor.minSubsteps > governor.maxSubsteps) {
+        std::cerr << "--substeps needs 1 <= MIN <= MAX" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+    if (!(governor.minLodBias > 0.0f) || !(governor.minLodBias <= governor.maxLodBias)) { // Bias multiplies, 0 would stick. // Bias multipliziert, 0 bliebe hängen.
+        std::cerr << "--lod-bias needs 0 < MIN <= MAX" << std::endl; // Error message. // Fehlermeldung.
+        return false;
+    }
+
+    // Start inside the bounds. // Innerhalb der Grenzen starten.
+    gridDivisions = glm::clamp(gridDivisions, governor.minGridDivisions, governor.maxGridDivisions);
+    lodBias = glm::clamp(lodBias, governor.minLodBias, governor.maxLodBias);
+    substeps = glm::clamp(substeps, governor.minSubsteps, governor.maxSubsteps);
+    return true;
+}
 
 /// Initializes GLFW and GLEW, creates window
 /// EN: Sets up OpenGL context with depth testing and alpha blending
@@ -402,7 +4962,15 @@ GLFWwindow* StartGLU() {
     }
 
     glEnable(GL_DEPTH_TEST); // Enable depth testing. // Aktiviere Tiefentest.
-    glViewport(0, 0, 800, 600); // Set viewport size. // Setze Viewport-Größe.
+    if (GLEW_VERSION_4_5 || GLEW_ARB_clip_control) {
+        // Reversed-Z: depth in [0, 1] keeps float precision for distant bodies. // Reversed-Z: Tiefe in [0, 1] erhält Float-Genauigkeit für ferne Körper.
+        glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE); // No [-1, 1] remap. // Keine [-1, 1]-Umrechnung.
+        glDepthFunc(GL_GREATER); // Nearer fragments have larger depth. // Nähere Fragmente haben größere Tiefe.
+        glClearDepth(0.0); // Clear to infinity. // Auf Unendlich löschen.
+        reversedZ = true;
+    }
+    glfwGetFramebufferSize(window, &windowWidth, &windowHeight); // May differ from window size on high-DPI screens. // Kann auf High-DPI-Bildschirmen von der Fenstergröße abweichen.
+    glViewport(0, 0, windowWidth, windowHeight); // Set viewport size. // Setze Viewport-Größe.
     glEnable(GL_BLEND); // Enable alpha blending. // Aktiviere Alpha-Blending.
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Set blend function. // Setze Blend-Funktion.
 
@@ -410,9 +4978,9 @@ GLFWwindow* StartGLU() {
 }
 
 /// Creates and links OpenGL shader program
-/// EN: Compiles vertex and fragment shaders, links them into a program
-/// DE: Kompiliert Vertex- und Fragment-Shader, verknüpft sie zu einem Programm
-GLuint CreateShaderProgram(const char* vertexSource, const char* fragmentSource) {
+/// EN: Compiles vertex and fragment shaders, links them into a program; retrievable programs can be saved with glGetProgramBinary
+/// DE: Kompiliert Vertex- und Fragment-Shader, verknüpft sie zu einem Programm; abrufbare Programme können mit glGetProgramBinary gespeichert werden
+GLuint CreateShaderProgram(const char* vertexSource, const char* fragmentSource, bool retrievable) {
     // Compile vertex shader. // Kompiliere Vertex-Shader.
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER); // Create vertex shader object. // Erstelle Vertex-Shader-Objekt.
     glShaderSource(vertexShader, 1, &vertexSource, nullptr); // Set shader source. // Setze Shader-Quellcode.
@@ -442,6 +5010,9 @@ GLuint CreateShaderProgram(const char* vertexSource, const char* fragmentSource)
     GLuint shaderProgram = glCreateProgram(); // Create program object. // Erstelle Programm-Objekt.
     glAttachShader(shaderProgram, vertexShader); // Attach vertex shader. // Hänge Vertex-Shader an.
     glAttachShader(shaderProgram, fragmentShader); // Attach fragment shader. // Hänge Fragment-Shader an.
+    if (retrievable) {
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE); // Must be set before linking. // Muss vor dem Verknüpfen gesetzt werden.
+    }
     glLinkProgram(shaderProgram); // Link program. // Verknüpfe Programm.
 
     glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success); // Check linking. // Prüfe Verknüpfung.
@@ -457,6 +5028,91 @@ GLuint CreateShaderProgram(const char* vertexSource, const char* fragmentSource)
     return shaderProgram; // Return linked program. // Gebe verknüpftes Programm zurück.
 }
 
+/// Header of a cached program binary file
+/// EN: Identifies the cache entry; the key covers shader sources and driver strings so driver updates invalidate the cache
+/// DE: Identifiziert den Cache-Eintrag; der Schlüssel umfasst Shader-Quellen und Treiber-Strings, sodass Treiber-Updates den Cache invalidieren
+struct ShaderCacheHeader {
+    char magic[8]; // File signature "GSIMPROG". // Dateisignatur "GSIMPROG".
+    uint32_t version; // Cache file format version. // Version des Cache-Dateiformats.
+    uint32_t binaryFormat; // Driver-specific binary format enum. // Treiberspezifisches Binärformat-Enum.
+    uint64_t key; // Hash of sources and driver strings. // Hash von Quellen und Treiber-Strings.
+    uint64_t size; // Size of the program binary in bytes. // Größe der Programm-Binärdatei in Bytes.
+};
+
+/// Hashes a string with 64-bit FNV-1a
+/// EN: Feeds the bytes of text into a running hash, including the terminating zero as separator
+/// DE: Fügt die Bytes von text in einen laufenden Hash ein, einschließlich der abschließenden Null als Trenner
+uint64_t HashString(uint64_t hash, const char* text) {
+    if (!text) text = ""; // Driver strings may be null. // Treiber-Strings können null sein.
+    do {
+        hash ^= (unsigned char)*text; // Mix in byte. // Byte einmischen.
+        hash *= 1099511628211ull; // FNV prime. // FNV-Primzahl.
+    } while (*text++);
+    return hash;
+}
+
+/// Loads a shader program from the binary cache or compiles it
+/// EN: Looks up shader_cache/<key>.bin; on a miss or a rejected binary it compiles from source and stores the linked binary
+/// DE: Sucht shader_cache/<Schlüssel>.bin; bei Fehltreffer oder abgelehnter Binärdatei wird aus dem Quellcode kompiliert und die Binärdatei gespeichert
+GLuint LoadShaderProgram(const char* vertexSource, const char* fragmentSource) {
+    GLint formatCount = 0; // Number of supported binary formats. // Anzahl unterstützter Binärformate.
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount); // Query formats. // Formate abfragen.
+    }
+    if (formatCount == 0) {
+        return CreateShaderProgram(vertexSource, fragmentSource); // Driver cannot cache binaries. // Treiber kann keine Binärdateien cachen.
+    }
+
+    // Build cache key from sources and driver identity. // Erstelle Cache-Schlüssel aus Quellen und Treiber-Identität.
+    uint64_t key = 14695981039346656037ull; // FNV offset basis. // FNV-Offset-Basis.
+    key = HashString(key, vertexSource);
+    key = HashString(key, fragmentSource);
+    key = HashString(key, (const char*)glGetString(GL_VENDOR));
+    key = HashString(key, (const char*)glGetString(GL_RENDERER));
+    key = HashString(key, (const char*)glGetString(GL_VERSION));
+    std::ostringstream name; // Cache file name. // Cache-Dateiname.
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    std::filesystem::path path = std::filesystem::path(shaderCacheDir) / name.str(); // Cache file path. // Cache-Dateipfad.
+
+    // Try the cached binary first. // Versuche zuerst die zwischengespeicherte Binärdatei.
+    std::error_code sizeError; // Missing file. // Fehlende Datei.
+    uintmax_t fileSize = std::filesystem::file_size(path, sizeError); // Bounds the binary size. // Begrenzt die Binärgröße.
+    std::ifstream in(path, std::ios::binary);
+    ShaderCacheHeader header; // Cached header. // Zwischengespeicherter Header.
+    if (in.read((char*)&header, sizeof(header)) && std::string(header.magic, 8) == "GSIMPROG" && header.version == 1 && header.key == key
+        && !sizeError && header.size == fileSize - sizeof(header)) { // Truncated or corrupt files are recompiled. // Abgeschnittene oder beschädigte Dateien werden neu kompiliert.
+        std::vector<char> binary(header.size); // Program binary. // Programm-Binärdatei.
+        if (in.read(binary.data(), binary.size())) {
+            GLuint program = glCreateProgram(); // Create empty program. // Erstelle leeres Programm.
+            glProgramBinary(program, header.binaryFormat, binary.data(), (GLsizei)binary.size()); // Upload binary. // Lade Binärdatei hoch.
+            GLint success = 0; // Link status. // Verknüpfungsstatus.
+            glGetProgramiv(program, GL_LINK_STATUS, &success); // Driver may reject stale binaries. // Treiber kann veraltete Binärdateien ablehnen.
+            if (success) return program; // Cache hit. // Cache-Treffer.
+            glDeleteProgram(program); // Fall back to compiling. // Auf Kompilieren zurückfallen.
+        }
+    }
+    in.close();
+
+    // Compile and store the binary. // Kompiliere und speichere die Binärdatei.
+    GLuint program = CreateShaderProgram(vertexSource, fragmentSource, true); // Compile retrievable program. // Kompiliere abrufbares Programm.
+    GLint success = 0, length = 0; // Link status and binary size. // Verknüpfungsstatus und Binärgröße.
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (!success || length <= 0) return program; // Nothing to cache. // Nichts zu cachen.
+
+    std::vector<char> binary(length); // Program binary. // Programm-Binärdatei.
+    GLenum binaryFormat = 0; // Driver binary format. // Treiber-Binärformat.
+    glGetProgramBinary(program, length, nullptr, &binaryFormat, binary.data()); // Read binary back. // Lese Binärdatei zurück.
+    header = ShaderCacheHeader{ {'G','S','I','M','P','R','O','G'}, 1, binaryFormat, key, (uint64_t)length };
+
+    std::error_code error; // Ignored; a missing cache only costs startup time. // Ignoriert; ein fehlender Cache kostet nur Startzeit.
+    std::filesystem::create_directories(shaderCacheDir, error); // Ensure cache directory exists. // Stelle sicher, dass das Cache-Verzeichnis existiert.
+    std::ofstream out(path, std::ios::binary); // Cache file. // Cache-Datei.
+    out.write((const char*)&header, sizeof(header)); // Write header. // Schreibe Header.
+    out.write(binary.data(), binary.size()); // Write binary. // Schreibe Binärdatei.
+    return program;
+}
+
 /// Creates Vertex Array Object and Vertex Buffer Object
 /// EN: Sets up OpenGL buffers for vertex data with position attributes
 /// DE: Richtet OpenGL-Puffer für Vertex-Daten mit Positionsattributen ein
@@ -473,53 +5129,58 @@ void CreateVBOVAO(GLuint& VAO, GLuint& VBO, const float* vertices, size_t vertex
     glBindVertexArray(0); // Unbind VAO. // Löse VAO-Bindung.
 }
 
+/// Uploads data into a pooled stream buffer
+/// EN: Keeps the buffer object; its storage only grows (by doubling) and is otherwise orphaned at the same size, which drivers serve from recycled blocks
+/// DE: Behält das Buffer-Objekt; sein Speicher wächst nur (durch Verdopplung) und wird sonst in gleicher Größe verwaist, was Treiber aus wiederverwendeten Blöcken bedienen
+void UploadStreamBuffer(GLenum target, GLuint buffer, GLsizeiptr& capacity, const void* data, GLsizeiptr size) {
+    glBindBuffer(target, buffer); // Bind pooled buffer. // Binde gepoolten Buffer.
+    while (capacity < size) capacity = std::max<GLsizeiptr>(capacity * 2, 4096); // Grow rarely. // Selten wachsen.
+    glBufferData(target, capacity, nullptr, GL_STREAM_DRAW); // Orphan previous contents. // Vorherigen Inhalt verwaisen.
+    glBufferSubData(target, 0, size, data); // Fill. // Befüllen.
+}
+
 /// Updates camera view matrix
-/// EN: Calculates and uploads view matrix based on camera position and orientation
-/// DE: Berechnet und lädt Ansichtsmatrix basierend auf Kameraposition und -ausrichtung
-void UpdateCam(GLuint shaderProgram, glm::vec3 cameraPos) {
+/// EN: Calculates and uploads a rotation-only view matrix; positions are rebased to the camera on the CPU, so the camera sits at the origin. Returns it for culling
+/// DE: Berechnet und lädt eine reine Rotations-Ansichtsmatrix; Positionen werden auf der CPU relativ zur Kamera verschoben, sodass die Kamera im Ursprung sitzt. Gibt sie für das Culling zurück
+glm::mat4 UpdateCam(GLuint shaderProgram) {
     glUseProgram(shaderProgram); // Activate shader program. // Aktiviere Shader-Programm.
-    glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp); // Calculate view matrix. // Berechne Ansichtsmatrix.
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), cameraFront, cameraUp); // Calculate view matrix. // Berechne Ansichtsmatrix.
     GLint viewLoc = glGetUniformLocation(shaderProgram, "view"); // Get view uniform location. // Hole View-Uniform-Position.
     glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view)); // Upload view matrix. // Lade Ansichtsmatrix hoch.
+    return view;
 }
 
 /// Keyboard input handler
-/// EN: Processes keyboard events for camera movement and object manipulation
-/// DE: Verarbeitet Tastatur-Events für Kamerabewegung und Objektmanipulation
+/// EN: Moves the camera directly and queues commands for pausing and object manipulation
+/// DE: Bewegt die Kamera direkt und reiht Befehle für Pause und Objektmanipulation ein
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-    float cameraSpeed = 10000.0f * deltaTime; // Camera movement speed. // Kamerabewegungsgeschwindigkeit.
+    double cameraSpeed = 3.0e8 * deltaTime; // Camera movement speed in m/s. // Kamerabewegungsgeschwindigkeit in m/s.
     bool shiftPressed = (mods & GLFW_MOD_SHIFT) != 0; // Check shift key. // Prüfe Shift-Taste.
-    Object& lastObj = objs[objs.size() - 1]; // Reference to last object. // Referenz zum letzten Objekt.
     
     // WASD camera movement. // WASD-Kamerabewegung.
     if (glfwGetKey(window, GLFW_KEY_W)==GLFW_PRESS){
-        cameraPos += cameraSpeed * cameraFront; // Move forward. // Bewege vorwärts.
+        cameraPos += cameraSpeed * glm::dvec3(cameraFront); // Move forward. // Bewege vorwärts.
     }
     if (glfwGetKey(window, GLFW_KEY_S)==GLFW_PRESS){
-        cameraPos -= cameraSpeed * cameraFront; // Move backward. // Bewege rückwärts.
+        cameraPos -= cameraSpeed * glm::dvec3(cameraFront); // Move backward. // Bewege rückwärts.
     }
     if (glfwGetKey(window, GLFW_KEY_A)==GLFW_PRESS){
-        cameraPos -= cameraSpeed * glm::normalize(glm::cross(cameraFront, cameraUp)); // Move left. // Bewege links.
+        cameraPos -= cameraSpeed * glm::dvec3(glm::normalize(glm::cross(cameraFront, cameraUp))); // Move left. // Bewege links.
     }
     if (glfwGetKey(window, GLFW_KEY_D)==GLFW_PRESS){
-        cameraPos += cameraSpeed * glm::normalize(glm::cross(cameraFront, cameraUp)); // Move right. // Bewege rechts.
+        cameraPos += cameraSpeed * glm::dvec3(glm::normalize(glm::cross(cameraFront, cameraUp))); // Move right. // Bewege rechts.
     }
 
     // Vertical camera movement. // Vertikale Kamerabewegung.
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS){
-        cameraPos += cameraSpeed * cameraUp; // Move up. // Bewege nach oben.
+        cameraPos += cameraSpeed * glm::dvec3(cameraUp); // Move up. // Bewege nach oben.
     }
     if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS){
-        cameraPos -= cameraSpeed * cameraUp; // Move down. // Bewege nach unten.
+        cameraPos -= cameraSpeed * glm::dvec3(cameraUp); // Move down. // Bewege nach unten.
     }
 
     // Pause control. // Pausensteuerung.
-    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS){
-        pause = true; // Pause simulation. // Pausiere Simulation.
-    }
-    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_RELEASE){
-        pause = false; // Resume simulation. // Setze Simulation fort.
-    }
+    PushInput(CMD_PAUSE, glm::dvec3(0.0, 0.0, 0.0), glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS ? 1.0 : 0.0); // Paused while K is held. // Pausiert solange K gehalten wird.
     
     // Quit application. // Beende Anwendung.
     if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS){
@@ -528,31 +5189,76 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
         running = false; // Stop main loop. // Stoppe Hauptschleife.
     }
 
-    // Object positioning during initialization. // Objektpositionierung während Initialisierung.
-    if(!objs.empty() && objs[objs.size() - 1].Initalizing){
-        if (key == GLFW_KEY_UP && (action == GLFW_PRESS || action == GLFW_REPEAT)){
-            if (!shiftPressed) {
-                objs[objs.size()-1].position[1] += objs[objs.size() - 1].radius * 0.2; // Move up. // Bewege nach oben.
-            }
-        };
-        if (key == GLFW_KEY_DOWN && (action == GLFW_PRESS || action == GLFW_REPEAT)) {
-            if (!shiftPressed) {
-                objs[objs.size()-1].position[1] -= objs[objs.size() - 1].radius * 0.2; // Move down. // Bewege nach unten.
-            }
-        }
-        if(key == GLFW_KEY_RIGHT && (action == GLFW_PRESS || action == GLFW_REPEAT)){
-            objs[objs.size()-1].position[0] += objs[objs.size() - 1].radius * 0.2; // Move right. // Bewege nach rechts.
-        };
-        if(key == GLFW_KEY_LEFT && (action == GLFW_PRESS || action == GLFW_REPEAT)){
-            objs[objs.size()-1].position[0] -= objs[objs.size() - 1].radius * 0.2; // Move left. // Bewege nach links.
-        };
-        if (key == GLFW_KEY_UP && (action == GLFW_PRESS || action == GLFW_REPEAT)) {
-            objs[objs.size()-1].position[2] += objs[objs.size() - 1].radius * 0.2; // Move forward. // Bewege vorwärts.
-        };
-        if (key == GLFW_KEY_DOWN && (action == GLFW_PRESS || action == GLFW_REPEAT)) {
-            objs[objs.size()-1].position[2] -= objs[objs.size() - 1].radius * 0.2; // Move backward. // Bewege rückwärts.
+    // Delete the selected body. // Lösche den gewählten Körper.
+    if (key == GLFW_KEY_DELETE && action == GLFW_PRESS){
+        PushInput(CMD_REMOVE);
+    }
+
+    // Save and restore the run. // Lauf speichern und wiederherstellen.
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS){
+        PushInput(CMD_SAVE_CHECKPOINT);
+    }
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS){
+        PushInput(CMD_LOAD_CHECKPOINT);
+    }
+
+    // Export for ParaView. // Export für ParaView.
+    if (key == GLFW_KEY_F6 && action == GLFW_PRESS){
+        PushInput(CMD_EXPORT);
+    }
+
+    // Replay speed and scrubbing. // Wiedergabegeschwindigkeit und Spulen.
+    if (key == GLFW_KEY_LEFT_BRACKET && action == GLFW_PRESS){
+        PushInput(CMD_REPLAY_SPEED, glm::dvec3(0.0, 0.0, 0.0), 0.5); // Half speed. // Halbe Geschwindigkeit.
+    }
+    if (key == GLFW_KEY_RIGHT_BRACKET && action == GLFW_PRESS){
+        PushInput(CMD_REPLAY_SPEED, glm::dvec3(0.0, 0.0, 0.0), 2.0); // Double speed. // Doppelte Geschwindigkeit.
+    }
+    if (key == GLFW_KEY_BACKSPACE && action == GLFW_PRESS){
+        PushInput(CMD_REPLAY_SPEED, glm::dvec3(0.0, 0.0, 0.0), -1.0); // Reverse direction. // Richtung umkehren.
+    }
+    if ((key == GLFW_KEY_COMMA || key == GLFW_KEY_PERIOD) && (action == GLFW_PRESS || action == GLFW_REPEAT)){
+        double frames = shiftPressed ? 100.0 : 1.0; // Shift skips further. // Shift springt weiter.
+        PushInput(CMD_REPLAY_SEEK, glm::dvec3(0.0, 0.0, 0.0), key == GLFW_KEY_COMMA ? -frames : frames);
+    }
+
+    // Profiler overlay toggle. // Profiler-Overlay umschalten.
+    if (key == GLFW_KEY_P && action == GLFW_PRESS){
+        showProfiler = !showProfiler; // Toggle overlay. // Overlay umschalten.
+    }
+
+    // Write the CPU profiler trace. // CPU-Profiler-Trace schreiben.
+    if (key == GLFW_KEY_F8 && action == GLFW_PRESS){
+#if GRAVITY_SIM_PROFILER
+        PROFILE_WRITE_TRACE();
+#else
+        std::cerr << "Profiler compiled out; build with -DGRAVITY_SIM_PROFILER=1" << std::endl; // Hint. // Hinweis.
+#endif
+    }
+
+    // Quality governor toggle. // Qualitätsregler umschalten.
+    if (key == GLFW_KEY_G && action == GLFW_PRESS){
+        governor.enabled = !governor.enabled; // Toggle governor. // Regler umschalten.
+    }
+
+    // Dynamic resolution toggle. // Dynamische Auflösung umschalten.
+    if (key == GLFW_KEY_R && action == GLFW_PRESS){
+        dynamicResolution.enabled = !dynamicResolution.enabled; // Toggle controller. // Regler umschalten.
+        if (!dynamicResolution.enabled) {
+            dynamicResolution.scale = 1.0f; // Back to native resolution. // Zurück zur nativen Auflösung.
+            windowResized = true; // Reallocate scene target next frame. // Szenenziel im nächsten Frame neu anlegen.
         }
-    };
+    }
+
+    // Object positioning during initialization, otherwise of the selected body. // Objektpositionierung während Initialisierung, sonst des gewählten Körpers.
+    if (action == GLFW_PRESS || action == GLFW_REPEAT) {
+        glm::dvec3 nudge(0.0, 0.0, 0.0); // Direction, scaled by 0.2 radii. // Richtung, skaliert mit 0,2 Radien.
+        if (key == GLFW_KEY_UP) nudge = glm::dvec3(0.0, shiftPressed ? 0.0 : 1.0, 1.0); // Up and forward. // Nach oben und vorwärts.
+        if (key == GLFW_KEY_DOWN) nudge = glm::dvec3(0.0, shiftPressed ? 0.0 : -1.0, -1.0); // Down and backward. // Nach unten und rückwärts.
+        if (key == GLFW_KEY_RIGHT) nudge = glm::dvec3(1.0, 0.0, 0.0); // Move right. // Bewege nach rechts.
+        if (key == GLFW_KEY_LEFT) nudge = glm::dvec3(-1.0, 0.0, 0.0); // Move left. // Bewege nach links.
+        if (nudge != glm::dvec3(0.0, 0.0, 0.0)) PushInput(CMD_NUDGE, nudge, 0.2);
+    }
 };
 
 /// Mouse movement callback
@@ -584,24 +5290,22 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
 }
 
 /// Mouse button callback
-/// EN: Handles object creation and launch with mouse buttons
-/// DE: Verarbeitet Objekterstellung und -start mit Maustasten
+/// EN: Queues object creation, launch and picking commands; the middle button picks the body under the crosshair
+/// DE: Reiht Befehle für Objekterstellung, -start und Picking ein; die mittlere Taste wählt den Körper unter dem Fadenkreuz
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods){
+    if (button == GLFW_MOUSE_BUTTON_MIDDLE && action == GLFW_PRESS) { // Middle mouse button. // Mittlere Maustaste.
+        PushInput(CMD_PICK, glm::dvec3(cameraFront), 0.0, cameraPos); // Cursor is captured, so cast through the screen center. // Cursor ist gefangen, daher durch die Bildmitte casten.
+    }
     if (button == GLFW_MOUSE_BUTTON_LEFT){ // Left mouse button. // Linke Maustaste.
         if (action == GLFW_PRESS){
-            objs.emplace_back(glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0f, 0.0f, 0.0f), initMass); // Create new object. // Erstelle neues Objekt.
-            objs[objs.size()-1].Initalizing = true; // Mark as initializing. // Markiere als initialisierend.
+            PushInput(CMD_SPAWN); // Create new object. // Erstelle neues Objekt.
         };
         if (action == GLFW_RELEASE){
-            objs[objs.size()-1].Initalizing = false; // End initialization. // Beende Initialisierung.
-            objs[objs.size()-1].Launched = true; // Mark as launched. // Markiere als gestartet.
+            PushInput(CMD_LAUNCH); // Launch it. // Starte es.
         };
     };
-    if (!objs.empty() && button == GLFW_MOUSE_BUTTON_RIGHT && objs[objs.size()-1].Initalizing) { // Right mouse during init. // Rechte Maus während Init.
-        if (action == GLFW_PRESS || action == GLFW_REPEAT) {
-            objs[objs.size()-1].mass *= 1.2; // Increase mass. // Erhöhe Masse.
-            std::cout<<"MASS: "<<objs[objs.size()-1].mass<<std::endl; // Debug output. // Debug-Ausgabe.
-        }
+    if (button == GLFW_MOUSE_BUTTON_RIGHT && (action == GLFW_PRESS || action == GLFW_REPEAT)) { // Right mouse during init. // Rechte Maus während Init.
+        PushInput(CMD_GROW_MASS, glm::dvec3(0.0, 0.0, 0.0), 1.2); // Increase mass. // Erhöhe Masse.
     }
 };
 
@@ -609,12 +5313,46 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods){
 /// EN: Zooms camera in/out with mouse wheel
 /// DE: Zoomt Kamera ein/aus mit Mausrad
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset){
-    float cameraSpeed = 250000.0f * deltaTime; // Zoom speed. // Zoom-Geschwindigkeit.
+    double cameraSpeed = 7.5e9 * deltaTime; // Zoom speed in m/s. // Zoom-Geschwindigkeit in m/s.
     if(yoffset>0){
-        cameraPos += cameraSpeed * cameraFront; // Zoom in. // Hineinzoomen.
+        cameraPos += cameraSpeed * glm::dvec3(cameraFront); // Zoom in. // Hineinzoomen.
     } else if(yoffset<0){
-        cameraPos -= cameraSpeed * cameraFront; // Zoom out. // Herauszoomen.
+        cameraPos -= cameraSpeed * glm::dvec3(cameraFront); // Zoom out. // Herauszoomen.
+    }
+}
+
+/// Framebuffer resize callback
+/// EN: Records the new framebuffer size; projection and render targets are rebuilt at the start of the next frame
+/// DE: Speichert die neue Framebuffergröße; Projektion und Renderziele werden zu Beginn des nächsten Frames neu erstellt
+void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
+    if (width == 0 || height == 0) return; // Minimized. // Minimiert.
+    windowWidth = width; // New width. // Neue Breite.
+    windowHeight = height; // New height. // Neue Höhe.
+    windowResized = true; // Handle in main loop. // In Hauptschleife behandeln.
+}
+
+/// Rebuilds the projection matrix
+/// EN: Infinite perspective for the current aspect ratio, reversed-Z when clip control is available; uploads the matrix to every given program
+/// DE: Unendliche Perspektive für das aktuelle Seitenverhältnis, Reversed-Z wenn Clip-Control verfügbar ist; lädt die Matrix in jedes angegebene Programm
+glm::mat4 UpdateProjection(std::initializer_list<GLuint> programs) {
+    float aspect = float(windowWidth) / windowHeight; // Aspect ratio. // Seitenverhältnis.
+    glm::mat4 projection; // Perspective projection. // Perspektivische Projektion.
+    if (reversedZ) {
+        float f = 1.0f / tan(glm::radians(fovY) / 2.0f); // Cotangent of half the field of view. // Kotangens des halben Sichtfelds.
+        projection = glm::mat4(0.0f);
+        projection[0][0] = f / aspect;
+        projection[1][1] = f;
+        projection[2][3] = -1.0f; // w = -z_view. // w = -z_view.
+        projection[3][2] = nearPlane; // Depth = near / -z_view: 1 at the near plane, 0 at infinity. // Tiefe = near / -z_view: 1 an der Nahebene, 0 im Unendlichen.
+    } else {
+        projection = glm::infinitePerspective(glm::radians(fovY), aspect, nearPlane * 1.0e4f); // Standard depth needs a distant near plane. // Standard-Tiefe braucht eine ferne Nahebene.
     }
+    for (GLuint program : programs) {
+        glUseProgram(program); // Activate shader program. // Aktiviere Shader-Programm.
+        GLint projectionLoc = glGetUniformLocation(program, "projection"); // Get projection uniform location. // Hole Projektions-Uniform-Position.
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection)); // Upload projection matrix. // Lade Projektionsmatrix hoch.
+    }
+    return projection;
 }
 
 /// Converts spherical to Cartesian coordinates
@@ -627,6 +5365,156 @@ glm::vec3 sphericalToCartesian(float r, float theta, float phi){
     return glm::vec3(x, y, z); // Return Cartesian vector. // Gebe kartesischen Vektor zurück.
 };
 
+/// Generates sphere mesh vertices
+/// EN: Creates a triangulated sphere using spherical coordinates, 6 vertices per stack/sector cell
+/// DE: Erstellt eine triangulierte Kugel mit sphärischen Koordinaten, 6 Vertices pro Stapel/Sektor-Zelle
+std::vector<float> CreateSphereVertices(float radius, int stacks, int sectors) {
+    std::vector<float> vertices; // Vertex data container. // Vertex-Daten-Container.
+
+    // Generate sphere triangles. // Generiere Kugel-Dreiecke.
+    for(float i = 0.0f; i <= stacks; ++i){
+        float theta1 = (i / stacks) * glm::pi<float>(); // Current latitude angle. // Aktueller Breitengrad-Winkel.
+        float theta2 = (i+1) / stacks * glm::pi<float>(); // Next latitude angle. // Nächster Breitengrad-Winkel.
+        for (float j = 0.0f; j < sectors; ++j){
+            float phi1 = j / sectors * 2 * glm::pi<float>(); // Current longitude angle. // Aktueller Längengrad-Winkel.
+            float phi2 = (j+1) / sectors * 2 * glm::pi<float>(); // Next longitude angle. // Nächster Längengrad-Winkel.
+
+            // Convert spherical to Cartesian coordinates. // Konvertiere sphärische zu kartesischen Koordinaten.
+            glm::vec3 v1 = sphericalToCartesian(radius, theta1, phi1);
+            glm::vec3 v2 = sphericalToCartesian(radius, theta1, phi2);
+            glm::vec3 v3 = sphericalToCartesian(radius, theta2, phi1);
+            glm::vec3 v4 = sphericalToCartesian(radius, theta2, phi2);
+
+            // Triangle 1: v1-v2-v3. // Dreieck 1: v1-v2-v3.
+            vertices.insert(vertices.end(), {v1.x, v1.y, v1.z});
+            vertices.insert(vertices.end(), {v2.x, v2.y, v2.z});
+            vertices.insert(vertices.end(), {v3.x, v3.y, v3.z});
+
+            // Triangle 2: v2-v4-v3. // Dreieck 2: v2-v4-v3.
+            vertices.insert(vertices.end(), {v2.x, v2.y, v2.z});
+            vertices.insert(vertices.end(), {v4.x, v4.y, v4.z});
+            vertices.insert(vertices.end(), {v3.x, v3.y, v3.z});
+        }
+    }
+    return vertices; // Return generated vertices. // Gebe generierte Vertices zurück.
+}
+
+/// Creates the buffers for batched body rendering
+/// EN: Packs all unit-sphere LODs into one vertex buffer and sets up per-instance attributes with divisor 1
+/// DE: Packt alle Einheitskugel-LODs in einen Vertex-Buffer und richtet Instanz-Attribute mit Divisor 1 ein
+void CreateBodyBuffers() {
+    std::vector<float> meshVertices; // All LOD meshes back to back. // Alle LOD-Meshes hintereinander.
+    for (int lod = 0; lod < LOD_COUNT; ++lod) {
+        std::vector<float> sphere = CreateSphereVertices(1.0f, lodSegments[lod], lodSegments[lod]); // Unit sphere. // Einheitskugel.
+        lodFirst[lod] = meshVertices.size() / 3; // First vertex of this level. // Erster Vertex dieser Stufe.
+        lodVertexCount[lod] = sphere.size() / 3; // Vertices of this level. // Vertices dieser Stufe.
+        meshVertices.insert(meshVertices.end(), sphere.begin(), sphere.end());
+    }
+    CreateVBOVAO(bodyVAO, sphereVBO, meshVertices.data(), meshVertices.size()); // Mesh buffer with attribute 0. // Mesh-Buffer mit Attribut 0.
+
+    glGenBuffers(1, &instanceVBO); // Generate instance buffer. // Generiere Instanz-Buffer.
+    glGenBuffers(1, &indirectBuffer); // Generate indirect command buffer. // Generiere Indirekt-Befehls-Buffer.
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer); // At most one command per LOD. // Höchstens ein Befehl pro LOD.
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, LOD_COUNT * sizeof(DrawArraysIndirectCommand), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(bodyVAO); // Bind body VAO. // Binde Körper-VAO.
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO); // Bind instance buffer. // Binde Instanz-Buffer.
+    instanceCapacity = initialInstanceCapacity * sizeof(BodyInstance); // Allocate up front. // Vorab belegen.
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)offsetof(BodyInstance, positionRadius)); // Position and radius. // Position und Radius.
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)offsetof(BodyInstance, color)); // Color. // Farbe.
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)offsetof(BodyInstance, glow)); // Glow flag. // Leucht-Flag.
+    for (GLuint attribute = 1; attribute <= 3; ++attribute) {
+        glEnableVertexAttribArray(attribute); // Enable instance attribute. // Aktiviere Instanz-Attribut.
+        glVertexAttribDivisor(attribute, 1); // Advance once per instance. // Einmal pro Instanz weiterschalten.
+    }
+    glBindVertexArray(0); // Unbind VAO. // Löse VAO-Bindung.
+
+    multiDrawIndirect = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect; // Needs GL 4.3 or the extension. // Benötigt GL 4.3 oder die Erweiterung.
+}
+
+/// Culls bodies and fills the indirect draw commands
+/// EN: Drops spheres outside the view frustum, picks a LOD from the projected diameter and groups instances by LOD
+/// DE: Verwirft Kugeln außerhalb des Sichtkegels, wählt ein LOD anhand des projizierten Durchmessers und gruppiert Instanzen nach LOD
+void BuildBodyDrawCommands(const SlotMap<Object>& objs, const glm::mat4& viewProjection) {
+    // Extract frustum planes (row 3 +/- row i). // Extrahiere Sichtkegel-Ebenen (Zeile 3 +/- Zeile i).
+    glm::vec4 planes[6]; // Left, right, bottom, top, near, far. // Links, rechts, unten, oben, nah, fern.
+    for (int i = 0; i < 3; ++i) {
+        glm::vec4 row(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); // Row i. // Zeile i.
+        glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]); // Row 3. // Zeile 3.
+        planes[2 * i] = row3 + row;
+        planes[2 * i + 1] = row3 - row;
+    }
+    for (auto& plane : planes) {
+        float length = glm::length(glm::vec3(plane)); // Zero for the far plane at infinity. // Null für die Fernebene im Unendlichen.
+        plane = length > 0.0f ? plane / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // Normalize for distance tests. // Normalisieren für Abstandstests.
+    }
+
+    float pixelsPerUnit = windowHeight / (2.0f * tan(glm::radians(fovY) / 2.0f)); // Projected size at distance 1. // Projizierte Größe im Abstand 1.
+    std::vector<int> instanceLod; // Chosen LOD per visible instance. // Gewähltes LOD pro sichtbarer Instanz.
+    std::vector<BodyInstance> visible; // Visible instances in object order. // Sichtbare Instanzen in Objektreihenfolge.
+    int lodCounts[LOD_COUNT] = {}; // Instances per LOD. // Instanzen pro LOD.
+
+    for (const auto& obj : objs) {
+        glm::vec3 relative = glm::vec3(obj.position - cameraPos); // Rebase in double, then narrow. // In double verschieben, dann verkleinern.
+        bool inside = true; // Sphere intersects frustum. // Kugel schneidet Sichtkegel.
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), relative) + plane.w < -obj.radius) { inside = false; break; } // Fully outside one plane. // Komplett außerhalb einer Ebene.
+        }
+        if (!inside) continue;
+
+        float distance = std::max(glm::length(relative), 1e-3f); // Distance to camera. // Abstand zur Kamera.
+        float pixels = 2.0f * obj.radius / distance * pixelsPerUnit * lodBias; // Projected diameter. // Projizierter Durchmesser.
+        int lod = 0; // Finest level that is still justified. // Feinste noch gerechtfertigte Stufe.
+        while (lod < LOD_COUNT - 1 && pixels < lodMinPixels[lod]) ++lod;
+
+        visible.push_back(BodyInstance{ glm::vec4(relative, obj.radius), obj.color, obj.glow ? 1.0f : 0.0f });
+        instanceLod.push_back(lod);
+        ++lodCounts[lod];
+    }
+
+    // Counting sort by LOD so each level is one contiguous instance range. // Zählsortierung nach LOD, sodass jede Stufe ein zusammenhängender Instanzbereich ist.
+    int offsets[LOD_COUNT]; // Start of each LOD range. // Beginn jedes LOD-Bereichs.
+    bodyCommands.clear();
+    for (int lod = 0, offset = 0; lod < LOD_COUNT; offset += lodCounts[lod], ++lod) {
+        offsets[lod] = offset;
+        if (lodCounts[lod] > 0) {
+            bodyCommands.push_back(DrawArraysIndirectCommand{ (GLuint)lodVertexCount[lod], (GLuint)lodCounts[lod], (GLuint)lodFirst[lod], (GLuint)offset });
+        }
+    }
+    bodyInstances.resize(visible.size());
+    for (size_t i = 0; i < visible.size(); ++i) {
+        bodyInstances[offsets[instanceLod[i]]++] = visible[i]; // Scatter into LOD range. // In LOD-Bereich verteilen.
+    }
+}
+
+/// Submits all body batches
+/// EN: One glMultiDrawArraysIndirect call for all LODs; without GL 4.3 falls back to one instanced draw per LOD
+/// DE: Ein glMultiDrawArraysIndirect-Aufruf für alle LODs; ohne GL 4.3 ein instanzierter Aufruf pro LOD
+void DrawBodies(GLuint shaderProgram) {
+    if (bodyCommands.empty()) return; // Nothing visible. // Nichts sichtbar.
+    glUseProgram(shaderProgram); // Activate body shader. // Aktiviere Körper-Shader.
+    glBindVertexArray(bodyVAO); // Bind body VAO. // Binde Körper-VAO.
+    UploadStreamBuffer(GL_ARRAY_BUFFER, instanceVBO, instanceCapacity, bodyInstances.data(), bodyInstances.size() * sizeof(BodyInstance)); // Upload instances. // Lade Instanzen hoch.
+
+    if (multiDrawIndirect) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer); // Bind command buffer. // Binde Befehls-Buffer.
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, bodyCommands.size() * sizeof(DrawArraysIndirectCommand), bodyCommands.data()); // Upload commands into the fixed buffer. // Lade Befehle in den festen Buffer.
+        glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, (GLsizei)bodyCommands.size(), 0); // Draw all batches. // Zeichne alle Batches.
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0); // Unbind command buffer. // Löse Befehls-Buffer-Bindung.
+    } else {
+        for (const auto& command : bodyCommands) {
+            // Offset instance attributes instead of relying on baseInstance. // Versetze Instanz-Attribute statt baseInstance zu nutzen.
+            size_t base = command.baseInstance * sizeof(BodyInstance); // Byte offset of the batch. // Byte-Offset des Batches.
+            glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)(base + offsetof(BodyInstance, positionRadius)));
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)(base + offsetof(BodyInstance, color)));
+            glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)(base + offsetof(BodyInstance, glow)));
+            glDrawArraysInstanced(GL_TRIANGLES, command.first, command.count, command.instanceCount); // Draw one LOD. // Zeichne ein LOD.
+        }
+    }
+    glBindVertexArray(0); // Unbind VAO. // Löse VAO-Bindung.
+}
+
 /// Renders the grid
 /// EN: Draws grid lines with identity transformation
 /// DE: Zeichnet Gitterlinien mit Einheitstransformation
@@ -643,21 +5531,21 @@ void DrawGrid(GLuint shaderProgram, GLuint gridVAO, size_t vertexCount) {
 }
 
 /// Creates grid vertex data
-/// EN: Generates a flat grid of lines in the XZ plane
-/// DE: Generiert ein flaches Gitter aus Linien in der XZ-Ebene
-std::vector<float> CreateGridVertices(float size, int divisions, const std::vector<Object>& objs) {
-    std::vector<float> vertices; // Vertex container. // Vertex-Container.
-    float step = size / divisions; // Grid cell size. // Gitterzellengröße.
-    float halfSize = size / 2.0f; // Half grid size. // Halbe Gittergröße.
+/// EN: Generates a flat grid of lines in the XZ plane, in world meters
+/// DE: Generiert ein flaches Gitter aus Linien in der XZ-Ebene, in Weltmetern
+std::vector<double> CreateGridVertices(double size, int divisions, const SlotMap<Object>& objs) {
+    std::vector<double> vertices; // Vertex container. // Vertex-Container.
+    double step = size / divisions; // Grid cell size. // Gitterzellengröße.
+    double halfSize = size / 2.0; // Half grid size. // Halbe Gittergröße.
 
     // Generate X-axis lines. // Generiere X-Achsen-Linien.
     for (int yStep = 3; yStep <= 3; ++yStep) { // Fixed Y position. // Feste Y-Position.
-        float y = -halfSize*0.3f + yStep * step; // Calculate Y coordinate. // Berechne Y-Koordinate.
+        double y = -halfSize*0.3 + yStep * step; // Calculate Y coordinate. // Berechne Y-Koordinate.
         for (int zStep = 0; zStep <= divisions; ++zStep) {
-            float z = -halfSize + zStep * step; // Calculate Z coordinate. // Berechne Z-Koordinate.
+            double z = -halfSize + zStep * step; // Calculate Z coordinate. // Berechne Z-Koordinate.
             for (int xStep = 0; xStep < divisions; ++xStep) {
-                float xStart = -halfSize + xStep * step; // Line start X. // Linienstart X.
-                float xEnd = xStart + step; // Line end X. // Linienende X.
+                double xStart = -halfSize + xStep * step; // Line start X. // Linienstart X.
+                double xEnd = xStart + step; // Line end X. // Linienende X.
                 vertices.push_back(xStart); vertices.push_back(y); vertices.push_back(z); // Start vertex. // Startvertex.
                 vertices.push_back(xEnd);   vertices.push_back(y); vertices.push_back(z); // End vertex. // Endvertex.
             }
@@ -666,12 +5554,12 @@ std::vector<float> CreateGridVertices(float size, int divisions, const std::vect
     
     // Generate Z-axis lines. // Generiere Z-Achsen-Linien.
     for (int xStep = 0; xStep <= divisions; ++xStep) {
-        float x = -halfSize + xStep * step; // Calculate X coordinate. // Berechne X-Koordinate.
+        double x = -halfSize + xStep * step; // Calculate X coordinate. // Berechne X-Koordinate.
         for (int yStep = 3; yStep <= 3; ++yStep) { // Fixed Y position. // Feste Y-Position.
-            float y = -halfSize*0.3f + yStep * step; // Calculate Y coordinate. // Berechne Y-Koordinate.
+            double y = -halfSize*0.3 + yStep * step; // Calculate Y coordinate. // Berechne Y-Koordinate.
             for (int zStep = 0; zStep < divisions; ++zStep) {
-                float zStart = -halfSize + zStep * step; // Line start Z. // Linienstart Z.
-                float zEnd = zStart + step; // Line end Z. // Linienende Z.
+                double zStart = -halfSize + zStep * step; // Line start Z. // Linienstart Z.
+                double zEnd = zStart + step; // Line end Z. // Linienende Z.
                 vertices.push_back(x); vertices.push_back(y); vertices.push_back(zStart); // Start vertex. // Startvertex.
                 vertices.push_back(x); vertices.push_back(y); vertices.push_back(zEnd); // End vertex. // Endvertex.
             }
@@ -684,11 +5572,12 @@ std::vector<float> CreateGridVertices(float size, int divisions, const std::vect
 /// Updates grid vertices to show gravitational warping
 /// EN: Deforms grid based on gravitational field of objects (spacetime curvature visualization)
 /// DE: Verformt Gitter basierend auf Gravitationsfeld der Objekte (Raumzeit-Krümmungsvisualisierung)
-std::vector<float> UpdateGridVertices(std::vector<float> vertices, const std::vector<Object>& objs){
-    
+std::vector<double> UpdateGridVertices(std::vector<double> vertices, const SlotMap<Object>& objs){
+    PerfScope perfScope(PERF_GRID_UPDATE, double(vertices.size() / 3) * objs.size()); // Vertex-body pairs. // Vertex-Körper-Paare.
+
     // Calculate center of mass. // Berechne Massenschwerpunkt.
-    float totalMass = 0.0f; // Total system mass. // Gesamtsystemmasse.
-    float comY = 0.0f; // Center of mass Y coordinate. // Massenschwerpunkt Y-Koordinate.
+    double totalMass = 0.0; // Total system mass. // Gesamtsystemmasse.
+    double comY = 0.0; // Center of mass Y coordinate. // Massenschwerpunkt Y-Koordinate.
     for (const auto& obj : objs) {
         if (obj.Initalizing) continue; // Skip initializing objects. // Überspringe initialisierende Objekte.
         comY += obj.mass * obj.position.y; // Weighted Y position. // Gewichtete Y-Position.
@@ -697,30 +5586,110 @@ std::vector<float> UpdateGridVertices(std::vector<float> vertices, const std::ve
     if (totalMass > 0) comY /= totalMass; // Calculate average. // Berechne Durchschnitt.
     
     // Find original grid height. // Finde ursprüngliche Grid-Höhe.
-    float originalMaxY = -std::numeric_limits<float>::infinity(); // Initialize to minimum. // Initialisiere auf Minimum.
+    double originalMaxY = -std::numeric_limits<double>::infinity(); // Initialize to minimum. // Initialisiere auf Minimum.
     for (int i = 0; i < vertices.size(); i += 3) {
         originalMaxY = std::max(originalMaxY, vertices[i+1]); // Find maximum Y. // Finde maximales Y.
     }
 
-    float verticalShift = comY - originalMaxY; // Calculate shift. // Berechne Verschiebung.
-    std::cout<<"vertical shift: "<<verticalShift<<" |         comY: "<<comY<<"|            originalmaxy: "<<originalMaxY<<std::endl; // Debug output. // Debug-Ausgabe.
+    double verticalShift = comY - originalMaxY; // Calculate shift. // Berechne Verschiebung.
 
-    // Apply gravitational warping. // Wende Gravitationsverzerrung an.
-    for (int i = 0; i < vertices.size(); i += 3) {
-        glm::vec3 vertexPos(vertices[i], vertices[i+1], vertices[i+2]); // Current vertex position. // Aktuelle Vertex-Position.
-        glm::vec3 totalDisplacement(0.0f); // Total warping. // Gesamtverzerrung.
-        
-        for (const auto& obj : objs) {
-            glm::vec3 toObject = obj.GetPos() - vertexPos; // Vector to object. // Vektor zum Objekt.
-            float distance = glm::length(toObject); // Distance to object. // Abstand zum Objekt.
-            float distance_m = distance * 1000.0f; // Convert to meters. // Konvertiere zu Metern.
-            float rs = (2*G*obj.mass)/(c*c); // Schwarzschild radius. // Schwarzschild-Radius.
+    // Apply gravitational warping; vertices are independent, so they are split across cores. // Wende Gravitationsverzerrung an; Vertices sind unabhängig und werden daher auf Kerne verteilt.
+    ParallelFor(vertices.size() / 3, 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin * 3; i < end * 3; i += 3) {
+            glm::dvec3 vertexPos(vertices[i], vertices[i+1], vertices[i+2]); // Current vertex position. // Aktuelle Vertex-Position.
+            glm::dvec3 totalDisplacement(0.0, 0.0, 0.0); // Total warping. // Gesamtverzerrung.
+
+            for (const auto& obj : objs) {
+                glm::dvec3 toObject = obj.GetPos() - vertexPos; // Vector to object. // Vektor zum Objekt.
+                double distance = glm::length(toObject); // Distance to object in meters. // Abstand zum Objekt in Metern.
+                double rs = (2*G*obj.mass)/(double(c)*c); // Schwarzschild radius. // Schwarzschild-Radius.
 
-            float dz = 2 * sqrt(rs * (distance_m - rs)); // Gravitational depression. // Gravitationssenkung.
-            totalDisplacement.y += dz * 2.0f; // Apply warping. // Wende Verzerrung an.
+                double dz = 2 * sqrt(rs * (distance - rs)); // Flamm's paraboloid depth. // Tiefe von Flamms Paraboloid.
+                totalDisplacement.y += dz * gridWarpExaggeration; // Apply exaggerated warping. // Wende überhöhte Verzerrung an.
+            }
+            vertices[i+1] = totalDisplacement.y + -std::abs(verticalShift); // Update Y coordinate. // Aktualisiere Y-Koordinate.
         }
-        vertices[i+1] = totalDisplacement.y + -abs(verticalShift); // Update Y coordinate. // Aktualisiere Y-Koordinate.
-    }
+    });
 
     return vertices; // Return warped vertices. // Gebe verzerrte Vertices zurück.
 }
+
+/// Rebases world vertices to the camera
+/// EN: Subtracts the camera position in double precision and narrows to float for upload, so vertices near the camera keep full precision
+/// DE: Subtrahiert die Kameraposition in doppelter Genauigkeit und verkleinert für den Upload auf float, sodass Vertices nahe der Kamera volle Genauigkeit behalten
+std::vector<float> ToCameraRelative(const std::vector<double>& vertices) {
+    std::vector<float> relative(vertices.size()); // Camera-relative vertices. // Kamerarelative Vertices.
+    for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+        relative[i]     = float(vertices[i]     - cameraPos.x);
+        relative[i + 1] = float(vertices[i + 1] - cameraPos.y);
+        relative[i + 2] = float(vertices[i + 2] - cameraPos.z);
+    }
+    return relative;
+}
+
+/// Renders the GPU profiler overlay
+/// EN: Draws one horizontal bar per render pass in the top-left corner; the full bar width equals a 16.7 ms (60 FPS) budget
+/// DE: Zeichnet einen horizontalen Balken pro Render-Pass oben links; die volle Balkenbreite entspricht einem 16,7-ms-Budget (60 FPS)
+void DrawProfilerOverlay(GLuint overlayProgram, GLuint overlayVAO, GLuint overlayVBO, const double* passMs) {
+    const float budgetMs = 1000.0f / 60.0f; // Frame budget represented by a full bar. // Frame-Budget, das ein voller Balken darstellt.
+    const float left = -0.97f, top = 0.95f; // Top-left corner in NDC. // Obere linke Ecke in NDC.
+    const float width = 0.6f, height = 0.04f, gap = 0.015f; // Bar dimensions in NDC. // Balkenmaße in NDC.
+    std::vector<float> vertices; // Interleaved position and color. // Verschachtelte Position und Farbe.
+
+    auto addQuad = [&](float x0, float y0, float x1, float y1, float r, float g, float b, float a) {
+        const float quad[6][2] = { {x0, y0}, {x1, y0}, {x1, y1}, {x0, y0}, {x1, y1}, {x0, y1} }; // Two triangles. // Zwei Dreiecke.
+        for (const auto& v : quad) vertices.insert(vertices.end(), {v[0], v[1], r, g, b, a});
+    };
+
+    for (int pass = 0; pass < PASS_COUNT; ++pass) {
+        float y1 = top - pass * (height + gap); // Bar top. // Balken oben.
+        float y0 = y1 - height; // Bar bottom. // Balken unten.
+        float fill = std::min(float(passMs[pass]) / budgetMs, 1.0f); // Fraction of budget, clamped. // Anteil am Budget, begrenzt.
+        addQuad(left, y0, left + width, y1, 0.15f, 0.15f, 0.15f, 0.6f); // Background. // Hintergrund.
+        addQuad(left, y0, left + width * fill, y1, gpuPassColors[pass][0], gpuPassColors[pass][1], gpuPassColors[pass][2], 0.9f); // Measured time. // Gemessene Zeit.
+    }
+
+    glDisable(GL_DEPTH_TEST); // Overlay is always on top. // Overlay liegt immer oben.
+    glUseProgram(overlayProgram); // Activate overlay shader. // Aktiviere Overlay-Shader.
+    glBindVertexArray(overlayVAO); // Bind overlay VAO. // Binde Overlay-VAO.
+    UploadStreamBuffer(GL_ARRAY_BUFFER, overlayVBO, overlayCapacity, vertices.data(), vertices.size() * sizeof(float)); // Upload bars. // Lade Balken hoch.
+    glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 6); // Draw bars. // Zeichne Balken.
+    glBindVertexArray(0); // Unbind VAO. // Löse VAO-Bindung.
+    glEnable(GL_DEPTH_TEST); // Restore depth testing. // Stelle Tiefentest wieder her.
+}
+
+/// Updates the window title with GPU pass times and the selected body
+/// EN: Refreshes at most twice per second because changing the title is a slow window-system call
+/// DE: Aktualisiert höchstens zweimal pro Sekunde, da das Ändern des Titels ein langsamer Fenstersystem-Aufruf ist
+void UpdateWindowTitle(GLFWwindow* window, const double* passMs) {
+    static double lastUpdate = 0.0; // Time of last title change. // Zeit der letzten Titeländerung.
+    double now = glfwGetTime(); // Current time. // Aktuelle Zeit.
+    if (now - lastUpdate < 0.5) return; // Throttle updates. // Aktualisierungen drosseln.
+    lastUpdate = now;
+
+    std::ostringstream title; // Title text. // Titeltext.
+    title << "3D_TEST"; // Base title. // Basistitel.
+    if (showProfiler && gpuTimer.supported) {
+        title << std::fixed << std::setprecision(2); // Two decimals. // Zwei Nachkommastellen.
+        for (int pass = 0; pass < PASS_COUNT; ++pass) {
+            title << " | " << gpuPassNames[pass] << " " << passMs[pass] << " ms"; // Pass time. // Pass-Zeit.
+        }
+    }
+    title << " | res " << int(dynamicResolution.scale * 100.0f + 0.5f) << "%"; // Render scale. // Render-Maßstab.
+    if (replay.IsOpen()) {
+        title << std::defaultfloat << " | replay " << replay.Frame() + 1 << "/" << replay.index.size() << " x" << replay.speed; // Playback position. // Wiedergabeposition.
+    }
+    if (!connectAddress.empty()) {
+        title << std::defaultfloat << std::setprecision(3) << " | stream " << (streamClient.IsOpen() ? "" : "lost, ") << streamClient.NearBodies() << "/" << streamClient.Bodies()
+              << " near, " << streamClient.bytesPerSecond / 1.0e6 << " MB/s"; // Remote view state. // Zustand der Fernansicht.
+    }
+    if (conservation.every > 0) {
+        title << std::scientific << std::setprecision(2) << " | dE " << conservation.energyDrift << ", dL " << conservation.angularDrift; // Conservation drifts. // Erhaltungsdrift.
+    }
+    if (const Object* body = objs.Get(selectedBody)) {
+        title << std::scientific << std::setprecision(3) << " | body " << selectedBody.index
+              << ": m " << body->mass << " kg, r " << body->radius << " m, v " << glm::length(body->velocity)
+              << " m/s, d " << glm::length(body->position - cameraPos) << " m"; // Selected body stats. // Werte des gewählten Körpers.
+    }
+    glfwSetWindowTitle(window, title.str().c_str()); // Apply title. // Wende Titel an.
+}
@@ -0,0 +1,440 @@
+/// shared_state.h
+///
+/// Shared-memory state publishing between gravity_sim and external tools on the same host.
+/// The simulation writes snapshots into a ring of slots in a named shared-memory segment; any number of readers map it
+/// and copy the newest snapshot without locks. The name itself holds a small fixed directory with the current
+/// generation; the ring lives in NAME.<generation>, and growing it creates the next generation instead of reusing
+/// the name, since Windows would hand back the old, smaller mapping while any reader still has it open. Each slot is guarded by a seqlock: its sequence is odd while the writer
+/// fills it and 2 * epoch once complete, so a reader that sees the same even sequence before and after copying got a
+/// consistent snapshot. The ring gives readers SLOTS - 1 publishes of slack before the writer laps them.
+///
+/// Usage:
+/// ```cpp
+/// SharedStateReader reader;
+/// SharedStateSnapshot snapshot;
+/// if (reader.Open("gravity_sim_state") && reader.ReadLatest(snapshot)) { /* snapshot.position[0][i] ... */ }
+/// ```
+///
+/// EN: Layout, publisher and reader of the shared-memory snapshot ring; used by gravity_sim.cpp and state_reader.cpp.
+/// DE: Layout, Herausgeber und Leser des Schnappschuss-Rings im gemeinsamen Speicher; verwendet von gravity_sim.cpp und state_reader.cpp.
+
+#pragma once
+
+#include <algorithm> // Standard library for std::min and std::max. // Standardbibliothek für std::min und std::max.
+#include <atomic> // Standard library for the seqlock and epoch counters. // Standardbibliothek für Seqlock- und Epochenzähler.
+#include <chrono> // Standard library for publish timestamps. // Standardbibliothek für Veröffentlichungszeitstempel.
+#include <cstdint> // Fixed-width integer types for the shared layout. // Integer-Typen fester Breite für das gemeinsame Layout.
+#include <cstring> // Standard library for memcpy and memcmp. // Standardbibliothek für memcpy und memcmp.
+#include <new> // Standard library for placement new. // Standardbibliothek für Placement-new.
+#include <string> // Standard library for segment names. // Standardbibliothek für Segmentnamen.
+#include <thread> // Standard library for yielding while a slot is written. // Standardbibliothek zum Abgeben während ein Slot geschrieben wird.
+#include <vector> // Standard library for reader copies. // Standardbibliothek für Leserkopien.
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min and std::max usable. // std::min und std::max nutzbar halten.
+#endif
+#include <windows.h> // Named file mappings on Windows. // Benannte Datei-Mappings unter Windows.
+#else
+#include <sys/mman.h> // shm_open and mmap. // shm_open und mmap.
+#include <sys/stat.h> // fstat for segment sizes. // fstat für Segmentgrößen.
+#include <fcntl.h> // open flags. // open-Flags.
+#include <unistd.h> // ftruncate and close. // ftruncate und close.
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory counters must be lock-free"); // Atomics must not hide a process-local lock. // Atomics dürfen keine prozesslokale Sperre verbergen.
+
+const char sharedStateMagic[8] = { 'G', 'S', 'I', 'M', 'S', 'H', 'M', 'R' }; // Segment signature. // Segmentsignatur.
+const uint32_t sharedStateVersion = 2; // Bumped on every layout change. // Bei jeder Layoutänderung erhöht.
+
+enum SharedStateArray {
+    SHM_POS_X, SHM_POS_Y, SHM_POS_Z, // double, m. // double, m.
+    SHM_VEL_X, SHM_VEL_Y, SHM_VEL_Z, // double, m/s. // double, m/s.
+    SHM_MASS, // float, kg. // float, kg.
+    SHM_ID, // uint32 slot index, stable while the body lives. // uint32-Slot-Index, stabil solange der Körper lebt.
+    SHM_ARRAY_COUNT
+};
+const uint64_t sharedStateElementSize[SHM_ARRAY_COUNT] = { 8, 8, 8, 8, 8, 8, 4, 4 }; // Bytes per body. // Bytes pro Körper.
+
+/// Directory segment
+/// EN: Lives under the plain name for the publisher's lifetime; generation names the current ring segment
+/// DE: Liegt für die Lebensdauer des Herausgebers unter dem reinen Namen; generation benennt das aktuelle Ring-Segment
+struct SharedStateDirectory {
+    char magic[8]; // sharedStateMagic. // sharedStateMagic.
+    uint32_t version; // sharedStateVersion. // sharedStateVersion.
+    alignas(64) std::atomic<uint64_t> generation; // Ring segment is NAME.<generation>, 0 for none yet. // Ring-Segment ist NAME.<generation>, 0 für noch keines.
+};
+
+/// Name of a ring segment
+/// EN: One name per generation, so a new segment never collides with one a reader still maps
+/// DE: Ein Name pro Generation, damit ein neues Segment nie mit einem kollidiert, das ein Leser noch abbildet
+inline std::string SharedStateSegmentName(const std::string& name, uint64_t generation) { return name + "." + std::to_string(generation); }
+
+/// Segment header
+/// EN: Written once by the publisher; latest and retired change while readers are attached
+/// DE: Einmal vom Herausgeber geschrieben; latest und retired ändern sich, während Leser verbunden sind
+struct SharedStateHeader {
+    char magic[8]; // sharedStateMagic. // sharedStateMagic.
+    uint32_t version; // sharedStateVersion. // sharedStateVersion.
+    uint32_t slotCount; // Snapshots in the ring. // Schnappschüsse im Ring.
+    uint64_t capacity; // Bodies per slot. // Körper pro Slot.
+    uint64_t slotBytes; // Bytes per slot, including its SharedStateSlot. // Bytes pro Slot, einschließlich seines SharedStateSlot.
+    uint64_t firstSlot; // Offset of slot 0 from the segment start. // Offset von Slot 0 vom Segmentanfang.
+    uint64_t arrayOffset[SHM_ARRAY_COUNT]; // Array starts within a slot. // Array-Anfänge innerhalb eines Slots.
+    alignas(64) std::atomic<uint64_t> latest; // Epoch of the newest complete snapshot, 0 for none. // Epoche des neuesten vollständigen Schnappschusses, 0 für keinen.
+    alignas(64) std::atomic<uint32_t> retired; // Publisher moved to the next generation or closed. // Herausgeber ist in die nächste Generation umgezogen oder hat geschlossen.
+};
+
+/// Slot header
+/// EN: Seqlock plus the snapshot metadata; the body arrays follow at arrayOffset
+/// DE: Seqlock plus die Schnappschuss-Metadaten; die Körper-Arrays folgen bei arrayOffset
+struct SharedStateSlot {
+    alignas(64) std::atomic<uint64_t> sequence; // Odd while written, 2 * epoch when complete. // Ungerade während des Schreibens, 2 * Epoche wenn vollständig.
+    uint64_t epoch; // Publish counter, starts at 1. // Veröffentlichungszähler, beginnt bei 1.
+    uint64_t step; // stepCount of the snapshot. // stepCount des Schnappschusses.
+    double simTime; // Simulated seconds. // Simulierte Sekunden.
+    int64_t publishNs; // steady_clock time of the publish, comparable across processes. // steady_clock-Zeit der Veröffentlichung, prozessübergreifend vergleichbar.
+    uint64_t bodyCount; // Bodies in the arrays. // Körper in den Arrays.
+};
+
+/// Monotonic time in nanoseconds
+/// EN: steady_clock is CLOCK_MONOTONIC on Linux and QueryPerformanceCounter on Windows, both shared by all processes
+/// DE: steady_clock ist CLOCK_MONOTONIC unter Linux und QueryPerformanceCounter unter Windows, beide von allen Prozessen geteilt
+inline int64_t SharedStateNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Shared Segment Class
+/// EN: Creates or opens a named shared-memory segment and maps it read-write or read-only
+/// DE: Erstellt oder öffnet ein benanntes Segment im gemeinsamen Speicher und bildet es lesend-schreibend oder nur lesend ab
+class SharedSegment {
+    public:
+        unsigned char* data = nullptr; // First byte of the mapping. // Erstes Byte des Mappings.
+        size_t size = 0; // Mapped bytes. // Abgebildete Bytes.
+
+        SharedSegment() = default;
+        SharedSegment(const SharedSegment&) = delete;
+        SharedSegment& operator=(const SharedSegment&) = delete;
+        ~SharedSegment() { Close(); }
+
+        /// Creates a segment
+        /// EN: On POSIX replaces any segment of the same name. Windows keeps an existing object alive while a reader maps it and returns
+        ///     that one, possibly smaller, so this fails instead unless reuse is set for a fixed-size segment
+        /// DE: Ersetzt unter POSIX ein Segment gleichen Namens. Windows hält ein bestehendes Objekt am Leben, solange ein Leser es abbildet,
+        ///     und liefert dieses, womöglich kleinere, zurück; daher schlägt dies fehl, außer reuse ist für ein Segment fester Größe gesetzt
+        bool Create(const std::string& name, size_t bytes, bool reuse = false) {
+            Close();
+#ifdef _WIN32
+            mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)bytes >> 32), (DWORD)bytes, ("Local\\" + name).c_str());
+            if (!mapping) return false;
+            if (GetLastError() == ERROR_ALREADY_EXISTS && !reuse) { Close(); return false; } // Stale object held by a reader. // Veraltetes, von einem Leser gehaltenes Objekt.
+            data = (unsigned char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+#else
+            std::string path = "/" + name; // POSIX names start with a slash. // POSIX-Namen beginnen mit einem Schrägstrich.
+            shm_unlink(path.c_str()); // Fresh segment, so readers of the old one are not corrupted. // Frisches Segment, damit Leser des alten nicht beschädigt werden.
+            int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if (fd < 0) return false;
+            void* address = ftruncate(fd, (off_t)bytes) == 0 ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            close(fd); // The mapping keeps the segment. // Das Mapping hält das Segment.
+            if (address == MAP_FAILED) { shm_unlink(path.c_str()); return false; }
+            data = (unsigned char*)address;
+            owner = path;
+#endif
+            if (!data) { Close(); return false; }
+            size = bytes;
+            return true;
+        }
+
+        /// Opens an existing segment read-only
+        /// EN: Returns false if no publisher has created it or it is smaller than minBytes
+        /// DE: Gibt false zurück, wenn kein Herausgeber es erstellt hat oder es kleiner als minBytes ist
+        bool Open(const std::string& name, size_t minBytes) {
+            Close();
+#ifdef _WIN32
+            mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, ("Local\\" + name).c_str());
+            if (!mapping) return false;
+            data = (unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            MEMORY_BASIC_INFORMATION info; // Mapped view size. // Größe der abgebildeten Ansicht.
+            if (data && VirtualQuery(data, &info, sizeof(info))) size = info.RegionSize;
+#else
+            int fd = shm_open(("/" + name).c_str(), O_RDONLY, 0);
+            if (fd < 0) return false;
+            struct stat info; // Segment size. // Segmentgröße.
+            void* address = fstat(fd, &info) == 0 && info.st_size > 0 ? mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            close(fd);
+            if (address == MAP_FAILED) return false;
+            data = (unsigned char*)address;
+            size = (size_t)info.st_size;
+#endif
+            if (!data || size < minBytes) { Close(); return false; }
+            return true;
+        }
+
+        /// Unmaps the segment
+        /// EN: A creating publisher also removes the name
+        /// DE: Ein erstellender Herausgeber entfernt auch den Namen
+        void Close() {
+#ifdef _WIN32
+            if (data) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            mapping = nullptr;
+#else
+            if (data) munmap(data, size);
+            if (!owner.empty()) shm_unlink(owner.c_str());
+            owner.clear();
+#endif
+            data = nullptr;
+            size = 0;
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE mapping = nullptr; // File mapping object. // Datei-Mapping-Objekt.
+#else
+        std::string owner; // Name to unlink, if this process created the segment. // Zu entfernender Name, falls dieser Prozess das Segment erstellt hat.
+#endif
+};
+
+/// Body arrays of one slot
+/// EN: Handed to the publisher's fill callback; all arrays have room for the published count
+/// DE: Wird an den Füll-Callback des Herausgebers übergeben; alle Arrays haben Platz für die veröffentlichte Anzahl
+struct SharedStateArrays {
+    double* position[3]; // x, y, z in m. // x, y, z in m.
+    double* velocity[3]; // vx, vy, vz in m/s. // vx, vy, vz in m/s.
+    float* mass; // kg. // kg.
+    uint32_t* id; // Stable body ids. // Stabile Körper-IDs.
+};
+
+/// Shared State Publisher Class
+///
+/// Owns the directory and the ring segment and writes one snapshot per Publish into the next ring slot. A publish never
+/// waits for readers; when the body count outgrows the slots, a larger segment is created as the next generation,
+/// the directory points to it and the old one is marked retired, so attached readers follow.
+///
+/// EN: Writer side of the snapshot ring; one publishing thread.
+/// DE: Schreibseite des Schnappschuss-Rings; ein veröffentlichender Thread.
+class SharedStatePublisher {
+    public:
+        static constexpr uint32_t SLOTS = 4; // Ring depth. // Ringtiefe.
+
+        bool IsOpen() const { return segment.data != nullptr; }
+
+        /// Creates the segment
+        /// EN: capacity is the initial bodies per slot; returns false if shared memory is unavailable
+        /// DE: capacity ist die anfängliche Körperanzahl pro Slot; gibt false zurück, wenn gemeinsamer Speicher nicht verfügbar ist
+        bool Open(const std::string& segmentName, uint64_t capacity) {
+            Close();
+            name = segmentName;
+            epoch = 0;
+            if (!directory.Create(name, sizeof(SharedStateDirectory), true)) return false; // Fixed size, safe to reuse. // Feste Größe, gefahrlos wiederverwendbar.
+            SharedStateDirectory* entry = Directory();
+            generation = std::memcmp(entry->magic, sharedStateMagic, sizeof(entry->magic)) == 0 ? entry->generation.load(std::memory_order_relaxed) : 0; // Skip names a stale reader may hold. // Namen überspringen, die ein veralteter Leser halten könnte.
+            entry = new (directory.data) SharedStateDirectory(); // Starts the atomic's lifetime. // Beginnt die Lebensdauer des Atomics.
+            std::memcpy(entry->magic, sharedStateMagic, sizeof(entry->magic));
+            entry->version = sharedStateVersion;
+            entry->generation.store(0, std::memory_order_release);
+            if (!Allocate(std::max<uint64_t>(capacity, 1024))) { Close(); return false; }
+            return true;
+        }
+
+        /// Closes the segments
+        /// EN: Marks the ring retired first, so attached readers notice and wait for a new publisher
+        /// DE: Markiert den Ring zuerst als abgelöst, sodass verbundene Leser es bemerken und auf einen neuen Herausgeber warten
+        void Close() {
+            if (IsOpen()) Header()->retired.store(1, std::memory_order_release);
+            segment.Close();
+            directory.Close();
+        }
+
+        /// Publishes a snapshot
+        /// EN: fill(arrays) writes count bodies into the slot arrays; the seqlock makes the slot invisible to readers meanwhile
+        /// DE: fill(arrays) schreibt count Körper in die Slot-Arrays; der Seqlock macht den Slot währenddessen für Leser unsichtbar
+        template <typename Fill>
+        bool Publish(uint64_t count, uint64_t step, double simTime, Fill fill) {
+            if (!IsOpen()) return false;
+            if (count > Header()->capacity && !Allocate(count + count / 2)) return false; // Grow with headroom. // Mit Reserve wachsen.
+
+            ++epoch;
+            SharedStateHeader* header = Header();
+            unsigned char* base = segment.data + header->firstSlot + (epoch % header->slotCount) * header->slotBytes; // Slot start. // Slot-Anfang.
+            SharedStateSlot* slot = (SharedStateSlot*)base;
+            slot->sequence.store(2 * epoch - 1, std::memory_order_relaxed); // Odd: being written. // Ungerade: wird geschrieben.
+            std::atomic_thread_fence(std::memory_order_release); // Sequence before data. // Sequenz vor Daten.
+
+            SharedStateArrays arrays; // Slot arrays. // Slot-Arrays.
+            for (int c = 0; c < 3; ++c) {
+                arrays.position[c] = (double*)(base + header->arrayOffset[SHM_POS_X + c]);
+                arrays.velocity[c] = (double*)(base + header->arrayOffset[SHM_VEL_X + c]);
+            }
+            arrays.mass = (float*)(base + header->arrayOffset[SHM_MASS]);
+            arrays.id = (uint32_t*)(base + header->arrayOffset[SHM_ID]);
+            fill(arrays);
+
+            slot->epoch = epoch;
+            slot->step = step;
+            slot->simTime = simTime;
+            slot->bodyCount = count;
+            slot->publishNs = SharedStateNow();
+            slot->sequence.store(2 * epoch, std::memory_order_release); // Even: complete. // Gerade: vollständig.
+            header->latest.store(epoch, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        SharedSegment directory; // Fixed segment under the plain name. // Festes Segment unter dem reinen Namen.
+        SharedSegment segment; // Current ring segment. // Aktuelles Ring-Segment.
+        std::string name; // Segment name without the leading slash. // Segmentname ohne führenden Schrägstrich.
+        uint64_t epoch = 0; // Last published epoch. // Zuletzt veröffentlichte Epoche.
+        uint64_t generation = 0; // Suffix of the current ring segment. // Suffix des aktuellen Ring-Segments.
+
+        SharedStateDirectory* Directory() { return (SharedStateDirectory*)directory.data; }
+        SharedStateHeader* Header() { return (SharedStateHeader*)segment.data; }
+
+        static uint64_t AlignUp64(uint64_t offset) { return (offset + 63) / 64 * 64; }
+
+        /// Creates a segment for capacity bodies per slot
+        /// EN: Marks the previous segment retired before unmapping it; epochs continue, so readers never see them go backwards
+        /// DE: Markiert das vorherige Segment als abgelöst, bevor es freigegeben wird; Epochen laufen weiter, sodass Leser sie nie rückwärts laufen sehen
+        bool Allocate(uint64_t capacity) {
+            uint64_t arrayOffset[SHM_ARRAY_COUNT]; // Layout within a slot. // Layout innerhalb eines Slots.
+            uint64_t offset = AlignUp64(sizeof(SharedStateSlot)); // Next free byte. // Nächstes freies Byte.
+            for (int array = 0; array < SHM_ARRAY_COUNT; ++array) {
+                arrayOffset[array] = offset;
+                offset = AlignUp64(offset + capacity * sharedStateElementSize[array]);
+            }
+            uint64_t slotBytes = offset, firstSlot = AlignUp64(sizeof(SharedStateHeader)); // Ring geometry. // Ringgeometrie.
+
+            if (IsOpen()) {
+                Header()->retired.store(1, std::memory_order_release); // Readers reopen via the directory. // Leser öffnen über das Verzeichnis neu.
+                segment.Close();
+            }
+            bool created = false; // A fresh name was found. // Ein freier Name wurde gefunden.
+            for (int attempt = 0; attempt < 16 && !created; ++attempt) // Windows: names still mapped by readers fail. // Windows: noch von Lesern abgebildete Namen schlagen fehl.
+                created = segment.Create(SharedStateSegmentName(name, ++generation), firstSlot + SLOTS * slotBytes);
+            if (!created) return false;
+
+            SharedStateHeader* header = new (segment.data) SharedStateHeader(); // Starts the atomics' lifetime. // Beginnt die Lebensdauer der Atomics.
+            std::memcpy(header->magic, sharedStateMagic, sizeof(header->magic));
+            header->version = sharedStateVersion;
+            header->slotCount = SLOTS;
+            header->capacity = capacity;
+            header->slotBytes = slotBytes;
+            header->firstSlot = firstSlot;
+            std::memcpy(header->arrayOffset, arrayOffset, sizeof(arrayOffset));
+            for (uint32_t i = 0; i < SLOTS; ++i) new (segment.data + firstSlot + i * slotBytes) SharedStateSlot(); // Sequence 0: empty. // Sequenz 0: leer.
+            header->latest.store(0, std::memory_order_relaxed);
+            header->retired.store(0, std::memory_order_release);
+            Directory()->generation.store(generation, std::memory_order_release); // Initialized header before the name. // Initialisierter Header vor dem Namen.
+            return true;
+        }
+};
+
+/// Reader copy of a snapshot
+/// EN: Vectors are reused between reads, so polling does not allocate once the body count is stable
+/// DE: Vektoren werden zwischen Lesevorgängen wiederverwendet, sodass das Abfragen bei stabiler Körperanzahl nicht alloziert
+struct SharedStateSnapshot {
+    uint64_t epoch = 0; // Publish counter. // Veröffentlichungszähler.
+    uint64_t step = 0; // stepCount of the snapshot. // stepCount des Schnappschusses.
+    double simTime = 0.0; // Simulated seconds. // Simulierte Sekunden.
+    int64_t publishNs = 0; // Publish time, see SharedStateNow. // Veröffentlichungszeit, siehe SharedStateNow.
+    std::vector<double> position[3]; // m. // m.
+    std::vector<double> velocity[3]; // m/s. // m/s.
+    std::vector<float> mass; // kg. // kg.
+    std::vector<uint32_t> id; // Stable body ids. // Stabile Körper-IDs.
+};
+
+/// Shared State Reader Class
+///
+/// Maps the segment read-only and copies the newest complete snapshot. Readers never write to the segment,
+/// so they cannot slow the publisher or each other; a copy torn by a concurrent publish is detected and retried.
+///
+/// EN: Lock-free reader side of the snapshot ring.
+/// DE: Sperrfreie Leseseite des Schnappschuss-Rings.
+class SharedStateReader {
+    public:
+        bool IsOpen() const { return segment.data != nullptr; }
+
+        /// Attaches to a publisher
+        /// EN: Looks up the current generation in the directory; returns false if the segments do not exist or have another layout version
+        /// DE: Sucht die aktuelle Generation im Verzeichnis; gibt false zurück, wenn die Segmente nicht existieren oder eine andere Layout-Version haben
+        bool Open(const std::string& segmentName) {
+            name = segmentName;
+            segment.Close();
+            directory.Close(); // A restarted publisher replaced it. // Ein neu gestarteter Herausgeber hat es ersetzt.
+            if (!directory.Open(name, sizeof(SharedStateDirectory))) return false;
+            const SharedStateDirectory* entry = (const SharedStateDirectory*)directory.data;
+            if (std::memcmp(entry->magic, sharedStateMagic, sizeof(entry->magic)) == 0 && entry->version == sharedStateVersion) {
+                for (int attempt = 0; attempt < 4; ++attempt) { // The publisher may grow between lookup and open. // Der Herausgeber kann zwischen Nachschlagen und Öffnen wachsen.
+                    uint64_t generation = entry->generation.load(std::memory_order_acquire); // Current ring segment. // Aktuelles Ring-Segment.
+                    if (generation == 0) break;
+                    if (segment.Open(SharedStateSegmentName(name, generation), sizeof(SharedStateHeader))) {
+                        const SharedStateHeader* header = Header();
+                        if (std::memcmp(header->magic, sharedStateMagic, sizeof(header->magic)) == 0 && header->version == sharedStateVersion
+                            && header->firstSlot + (uint64_t)header->slotCount * header->slotBytes <= segment.size) return true;
+                        segment.Close();
+                    }
+                    if (entry->generation.load(std::memory_order_acquire) == generation) break; // Not a race, give up for now. // Kein Wettlauf, vorerst aufgeben.
+                }
+            }
+            directory.Close();
+            return false;
+        }
+
+        /// Newest published epoch
+        /// EN: Cheap to poll; 0 while nothing is published
+        /// DE: Günstig abzufragen; 0 solange nichts veröffentlicht ist
+        uint64_t Latest() { return Reattach() ? Header()->latest.load(std::memory_order_acquire) : 0; }
+
+        /// Copies the newest snapshot
+        /// EN: Returns false if nothing newer than snapshot.epoch is published; retries while the publisher overwrites the slot being copied
+        /// DE: Gibt false zurück, wenn nichts Neueres als snapshot.epoch veröffentlicht ist; wiederholt, während der Herausgeber den kopierten Slot überschreibt
+        bool ReadLatest(SharedStateSnapshot& snapshot) {
+            for (;;) {
+                uint64_t epoch = Latest(); // Candidate snapshot. // Kandidaten-Schnappschuss.
+                if (epoch == 0 || epoch <= snapshot.epoch) return false;
+                const SharedStateHeader* header = Header();
+                const unsigned char* base = segment.data + header->firstSlot + (epoch % header->slotCount) * header->slotBytes; // Slot start. // Slot-Anfang.
+                const SharedStateSlot* slot = (const SharedStateSlot*)base;
+                uint64_t before = slot->sequence.load(std::memory_order_acquire); // Seqlock read begin. // Seqlock-Lesebeginn.
+                if (before != 2 * epoch) { std::this_thread::yield(); continue; } // Lapped or being rewritten. // Überrundet oder wird neu geschrieben.
+
+                uint64_t count = std::min<uint64_t>(slot->bodyCount, header->capacity); // Bounded even if torn. // Begrenzt, auch wenn zerrissen.
+                for (int c = 0; c < 3; ++c) {
+                    Copy(snapshot.position[c], base + header->arrayOffset[SHM_POS_X + c], count);
+                    Copy(snapshot.velocity[c], base + header->arrayOffset[SHM_VEL_X + c], count);
+                }
+                Copy(snapshot.mass, base + header->arrayOffset[SHM_MASS], count);
+                Copy(snapshot.id, base + header->arrayOffset[SHM_ID], count);
+                snapshot.step = slot->step;
+                snapshot.simTime = slot->simTime;
+                snapshot.publishNs = slot->publishNs;
+
+                std::atomic_thread_fence(std::memory_order_acquire); // Data before the second sequence read. // Daten vor dem zweiten Sequenz-Lesen.
+                if (slot->sequence.load(std::memory_order_relaxed) == before) {
+                    snapshot.epoch = epoch;
+                    return true;
+                }
+            }
+        }
+
+    private:
+        SharedSegment directory; // Read-only directory mapping. // Nur-Lese-Mapping des Verzeichnisses.
+        SharedSegment segment; // Read-only ring mapping. // Nur-Lese-Mapping des Rings.
+        std::string name; // Segment name. // Segmentname.
+
+        const SharedStateHeader* Header() const { return (const SharedStateHeader*)segment.data; }
+
+        /// Follows a publisher that moved to a larger segment or restarted
+        /// EN: Returns false while no segment is available
+        /// DE: Gibt false zurück, solange kein Segment verfügbar ist
+        bool Reattach() {
+            if (IsOpen() && Header()->retired.load(std::memory_order_acquire) == 0) return true;
+            segment.Close();
+            return Open(name);
+        }
+
+        template <typename T>
+        static void Copy(std::vector<T>& out, const unsigned char* in, uint64_t count) {
+            out.resize((size_t)count);
+            std::memcpy(out.data(), in, (size_t)count * sizeof(T));
+        }
+};
@@ -0,0 +1,132 @@
+/// state_reader.cpp
+///
+/// Example reader and latency benchmark for the shared-memory state published by gravity_sim --publish NAME.
+/// Needs no OpenGL; build with: g++ -std=c++17 -O2 state_reader.cpp -o state_reader -pthread
+///
+/// Usage:
+///   state_reader [NAME]                               Print the newest snapshot of a running gravity_sim every 0.5 s.
+///   state_reader --bench [BODIES] [READERS] [SECONDS] Publish synthetic snapshots in-process and measure reader latency.
+///
+/// EN: Shows how external tools attach to a running simulation without slowing it down.
+/// DE: Zeigt, wie externe Werkzeuge sich an eine laufende Simulation anhängen, ohne sie zu verlangsamen.
+
+#include "shared_state.h" // Snapshot ring layout, publisher and reader. // Layout, Herausgeber und Leser des Schnappschuss-Rings.
+#include <iostream> // Standard library for console output. // Standardbibliothek für Konsolenausgabe.
+#include <iomanip> // Standard library for stream formatting manipulators. // Standardbibliothek für Stream-Formatierungsmanipulatoren.
+#include <string> // Standard library for argument handling. // Standardbibliothek für Argumentverarbeitung.
+
+/// Prints snapshots of a running simulation
+/// EN: Polls the segment and reports epoch, step, body count, centre of mass and how old the snapshot was when copied
+/// DE: Fragt das Segment ab und meldet Epoche, Schritt, Körperanzahl, Schwerpunkt und wie alt der Schnappschuss beim Kopieren war
+int Watch(const std::string& name) {
+    SharedStateReader reader; // Read-only attachment. // Nur-Lese-Anbindung.
+    while (!reader.Open(name)) {
+        std::cout << "Waiting for gravity_sim --publish " << name << " ..." << std::endl; // Status. // Status.
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    SharedStateSnapshot snapshot; // Reused copy. // Wiederverwendete Kopie.
+    uint64_t lastEpoch = 0; // Detects skipped publishes. // Erkennt übersprungene Veröffentlichungen.
+    for (;;) {
+        if (reader.ReadLatest(snapshot)) {
+            double ageUs = (SharedStateNow() - snapshot.publishNs) / 1000.0; // Publish to copy. // Veröffentlichung bis Kopie.
+            double total = 0.0, com[3] = { 0.0, 0.0, 0.0 }; // Mass and weighted position. // Masse und gewichtete Position.
+            for (size_t i = 0; i < snapshot.mass.size(); ++i) {
+                total += snapshot.mass[i];
+                for (int c = 0; c < 3; ++c) com[c] += snapshot.mass[i] * snapshot.position[c][i];
+            }
+            if (total > 0.0) for (int c = 0; c < 3; ++c) com[c] /= total;
+            std::cout << "epoch " << snapshot.epoch << " (+" << snapshot.epoch - lastEpoch << "), step " << snapshot.step
+                      << ", t = " << snapshot.simTime << " s, " << snapshot.mass.size() << " bodies, centre of mass ("
+                      << com[0] << ", " << com[1] << ", " << com[2] << ") m, age " << std::fixed << std::setprecision(1) << ageUs << " us"
+                      << std::defaultfloat << std::setprecision(6) << std::endl; // One line per snapshot. // Eine Zeile pro Schnappschuss.
+            lastEpoch = snapshot.epoch;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+}
+
+/// Measures publish-to-read latency
+/// EN: One thread publishes synthetic bodies as fast as possible while readers copy every new epoch; reports latency percentiles and copy throughput
+/// DE: Ein Thread veröffentlicht so schnell wie möglich synthetische Körper, während Leser jede neue Epoche kopieren; meldet Latenz-Perzentile und Kopierdurchsatz
+int Bench(uint64_t bodies, int readers, double seconds) {
+    std::string name = "gravity_sim_bench_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count() % 1000000); // Private segment. // Privates Segment.
+    SharedStatePublisher publisher; // Writer side. // Schreibseite.
+    if (!publisher.Open(name, bodies)) {
+        std::cerr << "Cannot create shared-memory segment " << name << std::endl; // Error message. // Fehlermeldung.
+        return 1;
+    }
+    std::atomic<bool> running{ true }; // Stops all threads. // Stoppt alle Threads.
+    std::atomic<uint64_t> published{ 0 }; // Publishes done. // Erfolgte Veröffentlichungen.
+    std::thread writer([&]() {
+        uint64_t step = 0; // Synthetic step counter. // Synthetischer Schrittzähler.
+        while (running.load(std::memory_order_relaxed)) {
+            ++step;
+            publisher.Publish(bodies, step, step * 0.01, [&](const SharedStateArrays& arrays) {
+                for (uint64_t i = 0; i < bodies; ++i) {
+                    for (int c = 0; c < 3; ++c) {
+                        arrays.position[c][i] = (double)(step + i + c); // Checked by the readers. // Von den Lesern geprüft.
+                        arrays.velocity[c][i] = 0.0;
+                    }
+                    arrays.mass[i] = 1.0f;
+                    arrays.id[i] = (uint32_t)i;
+                }
+            });
+            published.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    struct ReaderStats { std::vector<double> latencyUs; uint64_t torn = 0, bytes = 0; }; // Per-reader results. // Ergebnisse pro Leser.
+    std::vector<ReaderStats> stats(readers); // One entry per reader thread. // Ein Eintrag pro Leser-Thread.
+    std::vector<std::thread> threads; // Reader threads. // Leser-Threads.
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            SharedStateReader reader; // Separate attachment, like another process. // Eigene Anbindung, wie ein anderer Prozess.
+            SharedStateSnapshot snapshot; // Reused copy. // Wiederverwendete Kopie.
+            if (!reader.Open(name)) return;
+            while (running.load(std::memory_order_relaxed)) {
+                if (!reader.ReadLatest(snapshot)) { std::this_thread::yield(); continue; } // Wait for the next epoch. // Auf die nächste Epoche warten.
+                stats[r].latencyUs.push_back((SharedStateNow() - snapshot.publishNs) / 1000.0);
+                stats[r].bytes += snapshot.mass.size() * (6 * sizeof(double) + sizeof(float) + sizeof(uint32_t));
+                for (size_t i = 0; i < snapshot.mass.size(); i += 997) {
+                    if (snapshot.position[0][i] != (double)(snapshot.step + i)) { ++stats[r].torn; break; } // Seqlock failure. // Seqlock-Fehler.
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    writer.join();
+    for (std::thread& thread : threads) thread.join();
+    publisher.Close();
+
+    std::cout << "Shared-memory benchmark: " << bodies << " bodies, " << readers << " readers, " << seconds << " s, "
+              << published.load() / seconds << " publishes/s" << std::endl; // Setup. // Aufbau.
+    std::cout << std::fixed << std::setprecision(1);
+    for (int r = 0; r < readers; ++r) {
+        std::vector<double>& latency = stats[r].latencyUs; // Samples of this reader. // Messwerte dieses Lesers.
+        if (latency.empty()) { std::cout << "  reader " << r << ": no snapshots" << std::endl; continue; }
+        std::sort(latency.begin(), latency.end());
+        auto percentile = [&](double p) { return latency[std::min(latency.size() - 1, (size_t)(p * latency.size()))]; };
+        std::cout << "  reader " << r << ": " << latency.size() << " snapshots, latency p50 " << percentile(0.5) << " us, p99 " << percentile(0.99)
+                  << " us, max " << latency.back() << " us, " << stats[r].bytes / seconds / (1024.0 * 1024.0 * 1024.0) << " GiB/s copied, "
+                  << stats[r].torn << " torn" << std::endl; // Result line. // Ergebniszeile.
+    }
+    return 0;
+}
+
+/// Main function
+/// EN: Watches a running simulation, or runs the benchmark with --bench
+/// DE: Beobachtet eine laufende Simulation oder führt mit --bench den Benchmark aus
+int main(int argc, char** argv) {
+    std::string first = argc > 1 ? argv[1] : "gravity_sim_state"; // Segment name or --bench. // Segmentname oder --bench.
+    if (first != "--bench") return Watch(first);
+    try {
+        uint64_t bodies = argc > 2 ? std::stoull(argv[2]) : 100000; // Bodies per snapshot. // Körper pro Schnappschuss.
+        int readers = argc > 3 ? std::max(1, std::stoi(argv[3])) : 2; // Reader threads. // Leser-Threads.
+        double seconds = argc > 4 ? std::stod(argv[4]) : 3.0; // Duration. // Dauer.
+        return Bench(bodies, readers, seconds);
+    } catch (const std::exception&) {
+        std::cerr << "Usage: state_reader [NAME] | state_reader --bench [BODIES] [READERS] [SECONDS]" << std::endl; // Error message. // Fehlermeldung.
+        return 1;
+    }
+}